@@ -20,6 +20,7 @@ public class InventorySystem : ModuleRules
 				"Core",
 				"CoreOnline",
 				"CoreUObject",
+				"DeveloperSettings",
 				"Engine",
 				"InputCore",
 				"NetCore",
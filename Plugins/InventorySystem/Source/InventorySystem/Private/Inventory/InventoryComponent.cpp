@@ -3,38 +3,84 @@
 
 #include "Inventory/InventoryComponent.h"
 
+#include "InventorySystemSettings.h"
 #include "GameFramework/Character.h"
+#include "Inventory/InventoryContainerComponent.h"
 #include "Inventory/InventoryInterface.h"
+#include "Inventory/InventorySaveScheduler.h"
+#include "Inventory/InventoryTransaction.h"
+#include "Item/InventoryItemAssets.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Item/InventoryItemClaims.h"
+#include "Item/InventoryItemHandleAllocator.h"
 #include "Item/InventoryItemInterface.h"
+#include "Item/InventoryWorldItemIndex.h"
+#include "Item/InventoryWorldItemManager.h"
+#include "Item/InventoryWorldItemPool.h"
 #include "Item/ItemBase.h"
 #include "Engine/PackageMapClient.h"
 #include "Logging/StructuredLog.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY(InventoryLog);
 
 
 UInventoryComponent::UInventoryComponent()
 {
-	PrimaryComponentTick.TickGroup = TG_DuringPhysics;
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = true;
+	// Save information is added by the save scheduler once it's ready, the inventory doesn't need to tick
+	PrimaryComponentTick.bCanEverTick = false;
 	SetIsReplicatedByDefault(true);
 }
 
 
+void UInventoryComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// The inventory is copied from the component's template, so the listener is set after the properties have been initialized
+	Inventory.SetListener(this);
+	ItemPool.SetAllocator([this]() { return CreateInventoryObject(); }, [this](F_Item& Item) { ResetInventoryObject(Item); });
+}
+
+
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(UInventoryComponent, Inventory, COND_OwnerOnly);
+}
+
+
 void UInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
 	// Save the net and platform id for determining the character (on both server and client)
 	SetPlayerId();
+
+	// Add this inventory's database to the item catalog if it's different from the default database
+	if (UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get())
+	{
+		Catalog->RegisterDatabase(ItemDatabase);
+
+		// Items whose definition the client didn't have yet are in the common section until it's added
+		if (!GetOwner()->HasAuthority())
+		{
+			Catalog->OnPendingDefinitionAdded.AddWeakLambda(this, [this](const int32 ItemDefId)
+			{
+				if (Inventory.GetCount(ItemDefId) > 0) Inventory.RefreshSections();
+			});
+
+			// Let the server know which catalog this client has, so the items are sent with their ItemDefIds instead of their database ids
+			if (GetOwner()->GetNetConnection()) Server_SetItemCatalog(Catalog->Num(), Catalog->GetCatalogHash());
+		}
+	}
 }
 
 
-void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UInventoryComponent::Server_SetItemCatalog_Implementation(const int32 NumDefinitions, const uint32 CatalogHash)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	UpdateInventoryAfterRetrievingSaveInformation();
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (Catalog) Catalog->SetClientCatalog(GetOwner()->GetNetConnection(), NumDefinitions, CatalogHash);
 }
 
 
@@ -44,25 +90,17 @@ bool UInventoryComponent::TryAddItem_Implementation(const FName DatabaseId, UObj
 {
 	if (!GetCharacter() || DatabaseId.IsNone()) return false;
 
-	// TODO: check if this is valid in production. If not, add logic to refactor distributing this from the server - Unable to resolve default guid from client: ObjectName: BaseItem_0, ObjOuter: /Game/UEDPIE_0_Level.Level:PersistentLevel 
-	FGuid Id = FGuid::NewGuid();
-	const TScriptInterface<IInventoryItemInterface> InventoryItem = InventoryItemInterface;
-	if (InventoryItem.GetInterface() && InventoryItem->Execute_GetId(InventoryItem.GetObject()).IsValid())
-	{
-		Id = InventoryItem->Execute_GetId(InventoryItem.GetObject());
-	}
-
+	// The item's id is created on the server (or uses the id of the item in the world), clients don't need to send one
 	// If the server calls the function, just handle it and send the updated information to the client. Otherwise handle sending the information to the server and then back to the client
 	if (Character->IsLocallyControlled())
 	{
-		Server_TryAddItem(Id, DatabaseId, InventoryItemInterface, Type);
+		Server_TryAddItem(DatabaseId, InventoryItemInterface, Type);
 		Execute_AddItemPendingClientLogic(this, DatabaseId, InventoryItemInterface, Type);
 		return true; // Just return true by default and let the client rpc response handle everything else
 	}
 	else if (Character->HasAuthority())
 	{
-		const F_Item ItemId = Execute_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type);
-		Client_AddItemResponse(ItemId.IsValid() ? true : false, Id, DatabaseId, InventoryItemInterface, Type);
+		Server_TryAddItem_Implementation(DatabaseId, InventoryItemInterface, Type);
 		return true;
 	}
 
@@ -70,36 +108,57 @@ bool UInventoryComponent::TryAddItem_Implementation(const FName DatabaseId, UObj
 }
 
 
-void UInventoryComponent::Server_TryAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
+bool UInventoryComponent::TryPickupWorldItem(const FGuid& Id)
 {
-	bool bSuccessfullyAddedItem;
-	const TScriptInterface<IInventoryItemInterface> InventoryItem = InventoryItemInterface;
-	
-	// Adding an item from the world
-	if (InventoryItem.GetInterface())
+	if (!GetCharacter() || !Id.IsValid()) return false;
+
+	if (Character->IsLocallyControlled())
 	{
-		// Don't allow players to interfere with items that are already being adjusted 
-		if (!InventoryItem->Execute_IsSafeToAdjustItem(InventoryItem.GetObject()))
-		{
-			bSuccessfullyAddedItem = false;
-		}
-		else
-		{
-			const F_Item ItemId = Execute_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type);
-			InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), Character);
-			bSuccessfullyAddedItem = ItemId.IsValid();
-		}
-		
-		// Remove the scope lock
-		if (InventoryItem->Execute_GetPlayerPending(InventoryItem.GetObject()) == Character) InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), nullptr);
+		Server_TryPickupWorldItem(Id);
+		return true;
 	}
-	else
-	// Adding an item by id
+	else if (Character->HasAuthority())
+	{
+		Server_TryPickupWorldItem_Implementation(Id);
+		return true;
+	}
+
+	return false;
+}
+
+
+void UInventoryComponent::Server_TryPickupWorldItem_Implementation(const FGuid& Id)
+{
+	// Lightweight items are claimed by their id the same as world items, so there's no reason to promote an item someone else has
+	const UInventoryItemClaims* Claims = UInventoryItemClaims::Get(this);
+	const UObject* Claimant = Claims ? Claims->GetClaimant(Id) : nullptr;
+	if (Claimant && Claimant != Character)
 	{
-		const F_Item ItemId = Execute_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type);
-		bSuccessfullyAddedItem = ItemId.IsValid();
+		Client_AddItemFailed(Id, NAME_None, nullptr, EItemType::Inv_None);
+		return;
+	}
+	
+	// The item is an actor while it's being picked up, and it's added like any other item in the world. If it isn't picked up it's turned back into a lightweight item later
+	UInventoryWorldItemManager* WorldItemManager = GetWorld() ? GetWorld()->GetSubsystem<UInventoryWorldItemManager>() : nullptr;
+	AItemBase* WorldItem = WorldItemManager ? WorldItemManager->PromoteWorldItem(Id) : nullptr;
+	if (!WorldItem)
+	{
+		Client_AddItemFailed(Id, NAME_None, nullptr, EItemType::Inv_None);
+		return;
 	}
 
+	Server_TryAddItem_Implementation(WorldItem->Execute_GetItemName(WorldItem), WorldItem, WorldItem->Execute_GetItemType(WorldItem));
+}
+
+
+void UInventoryComponent::Server_TryAddItem_Implementation(const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
+{
+	FGuid Id;
+	const TScriptInterface<IInventoryItemInterface> InventoryItem = InventoryItemInterface;
+	if (InventoryItem.GetInterface()) Id = InventoryItem->Execute_GetId(InventoryItem.GetObject());
+	if (!Id.IsValid()) Id = UInventoryItemHandleAllocator::AllocateItemId();
+	
+	const bool bSuccessfullyAddedItem = EInventoryOperationResult::Result_Succeeded == ServerAddItem(Id, DatabaseId, InventoryItemInterface, Type, 0);
 	if (bDebugInventory_Server)
 	{
 		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() added item {2}: {3} + {4}({5})", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
@@ -107,20 +166,50 @@ void UInventoryComponent::Server_TryAddItem_Implementation(const FGuid& Id, cons
 		);
 	}
 	
-	Client_AddItemResponse(bSuccessfullyAddedItem, Id, DatabaseId, InventoryItemInterface, Type);
+	// The item is replicated to the client, the client only needs to know if it wasn't added
+	if (bSuccessfullyAddedItem)
+	{
+		Execute_HandleItemAdditionSuccess(this, Id, DatabaseId, InventoryItemInterface, Type);
+	}
+	else
+	{
+		Client_AddItemFailed(Id, DatabaseId, InventoryItemInterface, Type);
+	}
+}
+
+
+EInventoryOperationResult UInventoryComponent::ServerAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity)
+{
+	const TScriptInterface<IInventoryItemInterface> InventoryItem = InventoryItemInterface;
+	
+	// Adding an item by id
+	if (!InventoryItem.GetInterface())
+	{
+		const F_Item Item = Call_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type, Quantity);
+		return Item.IsValid() ? EInventoryOperationResult::Result_Succeeded : EInventoryOperationResult::Result_Failed;
+	}
+	
+	// Adding an item from the world. Don't allow players to interfere with items that are already being adjusted 
+	if (!InventoryItem->Execute_IsSafeToAdjustItem(InventoryItem.GetObject())) return EInventoryOperationResult::Result_Locked;
+	
+	// The claim can still be refused if another player was waiting in line for the item (UInventoryItemClaims)
+	InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), Character);
+	if (InventoryItem->Execute_GetPlayerPending(InventoryItem.GetObject()) != Character) return EInventoryOperationResult::Result_Locked;
+	
+	const F_Item Item = Call_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type, Quantity);
+	
+	// Remove the scope lock
+	if (InventoryItem->Execute_GetPlayerPending(InventoryItem.GetObject()) == Character) InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), nullptr);
+	return Item.IsValid() ? EInventoryOperationResult::Result_Succeeded : EInventoryOperationResult::Result_Failed;
 }
 
 
-F_Item UInventoryComponent::HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
+F_Item UInventoryComponent::HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity)
 {
-	F_Item Item = *CreateInventoryObject();
+	const FInventoryItemPool::FPooledItem PooledItem = AcquireInventoryObject();
+	F_Item& Item = *PooledItem;
 	const TScriptInterface<IInventoryItemInterface> InventoryInterface = InventoryItemInterface;
 	if (InventoryInterface.GetInterface()) Item = InventoryInterface->Execute_GetItem(InventoryInterface.GetObject());
-	if (!Item.IsValid())
-	{
-		Execute_GetDataBaseItem(this, DatabaseId, Item);
-		Item.Id = Id;
-	}
 
 	if (bDebugInventory_Server || bDebugInventory_Client)
 	{
@@ -129,44 +218,34 @@ F_Item UInventoryComponent::HandleAddItem_Implementation(const FGuid& Id, const
 		);
 	}
 	
+	// Items from the world already have their information (and their quantity), otherwise the item only references it's database definition
+	// Either way the item is merged into the stacks that have room, so the returned item is the last stack it was added to
+	FGuid StackId;
 	if (Item.IsValid())
 	{
-		Execute_InternalAddInventoryItem(this, Item);
-		return Item;
+		UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+		if (Catalog) StackId = AddStackedItem(Item.Id, Catalog->AddDefinition(Item), Item.Quantity, Item.SortOrder);
 	}
-
+	else
+	{
+		StackId = AddStackedItem(Id, ResolveItemDefId(DatabaseId), FMath::Max(Quantity, 1));
+	}
+	
+	if (StackId.IsValid() && Inventory.GetItem(StackId, Item)) return Item;
 	return FGuid();
 }
 
 
-void UInventoryComponent::Client_AddItemResponse_Implementation(const bool bSuccess, const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
+void UInventoryComponent::Client_AddItemFailed_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
 {
 	const TScriptInterface<IInventoryItemInterface> InventoryItem = InventoryItemInterface;
-	if (!bSuccess)
-	{
-		Execute_HandleItemAdditionFail(this, Id, DatabaseId, InventoryItemInterface, Type);
-		OnInventoryItemAdditionFailure.Broadcast(Id, DatabaseId, InventoryItem);
-	}
-	else
-	{
-		F_Item Item = F_Item();
-		if (ROLE_AutonomousProxy == GetOwner()->GetLocalRole()) // TODO: are extra checks on clients necessary?
-		{
-			Item = Execute_HandleAddItem(this, Id, DatabaseId, InventoryItemInterface, Type);
-		}
-		else if (ROLE_Authority == GetOwner()->GetLocalRole())
-		{
-			Execute_GetItem(this, Item, Id, Type);
-		}
-		
-		Execute_HandleItemAdditionSuccess(this, Item.Id, Item.ItemName, InventoryItemInterface, Type);
-		OnInventoryItemAdditionSuccess.Broadcast(Item, InventoryItem);
-	}
+	Execute_HandleItemAdditionFail(this, Id, DatabaseId, InventoryItemInterface, Type);
+	OnInventoryItemAdditionFailure.Broadcast(Id, DatabaseId, InventoryItem);
 	
 	if (bDebugInventory_Client)
 	{
-		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() AddItemResponse: {2}, {3} add item operation ->  {4}({5}) ",
-			*UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *FString(__FUNCTION__), bSuccess ? "succeeded" : "failed", *Execute_GetPlayerId(this), DatabaseId, *Id.ToString()
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() AddItemResponse: failed, {2} add item operation ->  {3}({4}) ",
+			*UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *FString(__FUNCTION__), *Execute_GetPlayerId(this), DatabaseId, *Id.ToString()
 		);
 	}
 }
@@ -194,9 +273,8 @@ void UInventoryComponent::HandleItemAdditionFail_Implementation(const FGuid& Id,
 
 void UInventoryComponent::HandleItemAdditionSuccess_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
 {
-	// delete the item
-	AActor* WorldItem = Cast<AActor>(InventoryItemInterface);
-	if (WorldItem) WorldItem->Destroy();
+	// Return the world item to it's pool
+	UInventoryWorldItemPool::ReleaseOrDestroy(Cast<AActor>(InventoryItemInterface));
 }
 #pragma endregion 
 
@@ -218,7 +296,7 @@ bool UInventoryComponent::TryTransferItem_Implementation(const FGuid& Id, UObjec
 	else if (Character->HasAuthority())
 	{
 		bool bFromThisInventory; 
-		const bool bSuccessfullyTransferredItem = Execute_HandleTransferItem(this, Id, OtherInventoryInterface, Type, bFromThisInventory);
+		const bool bSuccessfullyTransferredItem = Call_HandleTransferItem(this, Id, OtherInventoryInterface, Type, 0, bFromThisInventory);
 
 		// The client's have trouble accessing other client's inventories (We're just recreating the item with the ItemId)
 		const FName ItemId = GetItemId(Id, Type, OtherInventoryInterface);
@@ -233,7 +311,7 @@ bool UInventoryComponent::TryTransferItem_Implementation(const FGuid& Id, UObjec
 void UInventoryComponent::Server_TryTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type)
 {
 	bool bFromThisInventory;
-	const bool bSuccessfullyTransferredItem = Execute_HandleTransferItem(this, Id, OtherInventoryInterface, Type, bFromThisInventory);
+	const bool bSuccessfullyTransferredItem = Call_HandleTransferItem(this, Id, OtherInventoryInterface, Type, 0, bFromThisInventory);
 	FName ItemId = GetItemId(Id, Type, OtherInventoryInterface);
 
 	if (bDebugInventory_Server)
@@ -256,77 +334,31 @@ void UInventoryComponent::Server_TryTransferItem_Implementation(const FGuid& Id,
 }
 
 
-bool UInventoryComponent::HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, bool& bFromThisInventory)
+bool UInventoryComponent::HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory)
 {
-	// Find the item, and then transfer it to the other inventory
 	const TScriptInterface<IInventoryInterface> OtherInventory = OtherInventoryInterface;
-	if (!Id.IsValid() || !OtherInventory.GetInterface()) return false;
-	F_Item Item = *CreateInventoryObject();
-
-	// Search for the item in the player's inventory
-	Execute_GetItem(this, Item, Id, Type);
-	if (Item.IsValid()) bFromThisInventory = true;
-	else
-	{
-		OtherInventory->Execute_GetItem(OtherInventory.GetObject(), Item, Id, Type);
-		bFromThisInventory = false;
-	}
-
-	if (!Item.IsValid())
-	{
-		if (bDebugInventory_Server || bDebugInventory_Client)
-		{
-			UE_LOGFMT(InventoryLog, Error, "({0}) {1}() (invalid/not found) id: {2} searched in {3} and {4}'s inventory", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
-				*FString(__FUNCTION__), *Id.ToString(), *Execute_GetPlayerId(this), *OtherInventory->Execute_GetPlayerId(OtherInventory.GetObject())
-			);
-		}
-		return false;
-	}
-
-	// Transfer the item
-	if (bFromThisInventory)
-	{
-		Execute_InternalRemoveInventoryItem(this, Item.Id, Item.ItemType);
-		OtherInventory->Execute_InternalAddInventoryItem(OtherInventory.GetObject(), Item);
+	if (!Id.IsValid() || !OtherInventory.GetInterface() || OtherInventoryInterface == this) return false;
+	
+	// Only players that are viewing a container can store items in it or take items from it
+	const UInventoryContainerComponent* Container = Cast<UInventoryContainerComponent>(OtherInventoryInterface);
+	if (Container && !Container->IsViewer(this)) return false;
 
-		// Client logic
-		OtherInventory->HandleTransferItemForOtherInventoryClientLogic(Item.Id, Item.ItemName, Item.ItemType, true);
-	}
-	else
-	{
-		Execute_InternalAddInventoryItem(this, Item);
-		OtherInventory->Execute_InternalRemoveInventoryItem(OtherInventory.GetObject(), Item.Id, Item.ItemType);
-		
-		// Client logic
-		OtherInventory->HandleTransferItemForOtherInventoryClientLogic(Item.Id, Item.ItemName, Item.ItemType, false);
-	}
+	// The item is moved with a transaction, so it's claimed while it's transferred and it's never in both inventories (or neither of them)
+	bFromThisInventory = Call_ContainsItem(this, Id, Type);
+	FInventoryTransaction Transfer;
+	if (bFromThisInventory) Transfer.MoveItem(this, OtherInventoryInterface, Id, Type, Quantity);
+	else Transfer.MoveItem(OtherInventoryInterface, this, Id, Type, Quantity);
+	const EInventoryOperationResult Result = Transfer.Commit(GetTransactionClaimant(), false);
 
 	if (bDebugInventory_Server || bDebugInventory_Client)
 	{
-		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() InventoryTransfer: {2}({3}) from {4} to {5}'s inventory", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
-			*FString(__FUNCTION__), Item.ItemName, *Id.ToString(),
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() InventoryTransfer {2}: {3} ({4}) from {5} to {6}'s inventory", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), *UEnum::GetValueAsString(Result), *Id.ToString(), Quantity,
 			bFromThisInventory ? *Execute_GetPlayerId(this) : *OtherInventory->Execute_GetPlayerId(OtherInventory.GetObject()),
 			bFromThisInventory ? *OtherInventory->Execute_GetPlayerId(OtherInventory.GetObject()) : *Execute_GetPlayerId(this)
 		);
 	}
-	return true;
-}
-
-
-void UInventoryComponent::HandleTransferItemForOtherInventoryClientLogic(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem) { Client_HandleTransferItemForOtherInventory(Id, DatabaseId, Type, bAddItem); }
-void UInventoryComponent::Client_HandleTransferItemForOtherInventory_Implementation(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem)
-{
-	if (bAddItem)
-	{
-		F_Item Item = *CreateInventoryObject();
-		Execute_GetDataBaseItem(this, DatabaseId, Item);
-		Item.Id = Id;
-		Execute_InternalAddInventoryItem(this, Item);
-	}
-	else
-	{
-		Execute_InternalRemoveInventoryItem(this, Id, Type);
-	}
+	return EInventoryOperationResult::Result_Succeeded == Result;
 }
 
 
@@ -340,31 +372,7 @@ void UInventoryComponent::Client_TransferItemResponse_Implementation(const bool
 	}
 	else
 	{
-		// Handle removing or adding the item to the inventory on this character if it was transferred to them
-		if (ROLE_AutonomousProxy == GetOwner()->GetLocalRole()) // TODO: are extra checks on clients necessary?
-		{
-			// Add the item on the client
-			if (!bFromThisInventory)
-			{
-				// Execute_HandleTransferItem(this, Id, OtherInventoryInterface, Type, bWasFromThisInventory);
-				F_Item Item = *CreateInventoryObject();
-				Execute_GetDataBaseItem(this, DatabaseId, Item);
-				Item.Id = Id;
-				
-				if (Item.IsValid()) Execute_InternalAddInventoryItem(this, Item);
-				else if (bDebugInventory_Client || bDebugInventory_Server)
-				{
-					UE_LOGFMT(InventoryLog, Error, "({0}) {1}() invalid/unable to create item: {2}({3}) for {4}'s inventory",
-						*UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *FString(__FUNCTION__), DatabaseId, *Id.ToString(), *Execute_GetPlayerId(this)
-					);
-				}
-			}
-			else
-			{
-				Execute_InternalRemoveInventoryItem(this, Id, Type);
-			}
-		}
-		
+		// Both inventories are updated through replication
 		Execute_HandleTransferItemSuccess(this, Id, OtherInventoryInterface, bFromThisInventory);
 		OnInventoryItemTransferSuccess.Broadcast(Id, OtherInventory, bFromThisInventory);
 	}
@@ -415,10 +423,7 @@ bool UInventoryComponent::TryRemoveItem_Implementation(const FGuid& Id, const EI
 	}
 	else if (Character->HasAuthority())
 	{
-		UObject* SpawnedItem;
-		FName ItemId = GetItemId(Id, Type);
-		const bool bSuccessfullyRemovedItem = Execute_HandleRemoveItem(this, Id, Type, bDropItem, SpawnedItem);
-		Client_RemoveItemResponse(bSuccessfullyRemovedItem, Id, ItemId, Type, bDropItem, SpawnedItem);
+		Server_TryRemoveItem_Implementation(Id, Type, bDropItem);
 		return true;
 	}
 
@@ -428,9 +433,9 @@ bool UInventoryComponent::TryRemoveItem_Implementation(const FGuid& Id, const EI
 
 void UInventoryComponent::Server_TryRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const bool bDropItem)
 {
-	UObject* SpawnedItem;
+	UObject* SpawnedItem = nullptr;
 	FName ItemId = GetItemId(Id, Type);
-	const bool bSuccessfullyRemovedItem = Execute_HandleRemoveItem(this, Id, Type, bDropItem, SpawnedItem);
+	const bool bSuccessfullyRemovedItem = Call_HandleRemoveItem(this, Id, Type, 0, bDropItem, SpawnedItem);
 	
 	if (bDebugInventory_Server)
 	{
@@ -442,16 +447,40 @@ void UInventoryComponent::Server_TryRemoveItem_Implementation(const FGuid& Id, c
 		);
 	}
 	
-	Client_RemoveItemResponse(bSuccessfullyRemovedItem, Id, ItemId, Type, bDropItem, SpawnedItem);
+	// The removal is replicated to the client, the client only needs to know if the item wasn't removed
+	if (bSuccessfullyRemovedItem)
+	{
+		Execute_HandleRemoveItemSuccess(this, Id, Type, bDropItem, SpawnedItem);
+	}
+	else
+	{
+		Client_RemoveItemFailed(Id, Type, bDropItem);
+	}
 }
 
 
-bool UInventoryComponent::HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const bool bDropItem, UObject*& SpawnedItem)
+bool UInventoryComponent::HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const int32 Quantity, const bool bDropItem, UObject*& SpawnedItem)
 {
+	// Removing part of a stack only lowers it's quantity, and there can't be more removed than what's in the stack
+	const FInventoryItemInstance* Stack = Inventory.Find(Id);
+	if (Stack && Quantity > Stack->Quantity) return false;
+	
 	if (bDropItem)
 	{
-		F_Item Item = *CreateInventoryObject();
-		Execute_GetItem(this, Item, Id, Type);
+		const FInventoryItemPool::FPooledItem PooledItem = AcquireInventoryObject();
+		F_Item& Item = *PooledItem;
+		Call_GetItem(this, Item, Id, Type);
+		
+		// The dropped part of a stack is a new item, and a dropped item is given the next generation of it's handle so requests that still use the inventory's id are stale
+		if (Quantity > 0 && Quantity < Item.Quantity)
+		{
+			Item.Id = UInventoryItemHandleAllocator::AllocateItemId();
+			Item.Quantity = Quantity;
+		}
+		else if (Item.IsValid())
+		{
+			Item.Id = UInventoryItemHandleAllocator::ReissueItemId(Item.Id);
+		}
 		
 		if (!Item.IsValid())
 		{
@@ -478,35 +507,22 @@ bool UInventoryComponent::HandleRemoveItem_Implementation(const FGuid& Id, const
 		);
 	}
 	
-	Execute_InternalRemoveInventoryItem(this, Id, Type);
+	Call_InternalRemoveInventoryItem(this, Id, Type, Quantity);
 	return true;
 }
 
 
-void UInventoryComponent::Client_RemoveItemResponse_Implementation(const bool bSuccess, const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bDropItem, UObject* SpawnedItem)
+void UInventoryComponent::Client_RemoveItemFailed_Implementation(const FGuid& Id, const EItemType Type, const bool bDropItem)
 {
-	if (!bSuccess)
-	{
-		Execute_HandleRemoveItemFail(this, Id, Type, bDropItem, SpawnedItem);
-		OnInventoryItemRemovalFailure.Broadcast(Id, SpawnedItem);
-	}
-	else
-	{
-		if (ROLE_AutonomousProxy == GetOwner()->GetLocalRole()) // TODO: are extra checks on clients necessary?
-		{
-			Execute_HandleRemoveItem(this, Id, Type, false, SpawnedItem);
-		}
-		
-		Execute_HandleRemoveItemSuccess(this, Id, Type, bDropItem, SpawnedItem);
-		OnInventoryItemRemovalSuccess.Broadcast(Id, SpawnedItem);
-	}
+	Execute_HandleRemoveItemFail(this, Id, Type, bDropItem, nullptr);
+	OnInventoryItemRemovalFailure.Broadcast(Id, nullptr);
 	
 	if (bDebugInventory_Client)
 	{
-		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() RemoveItemResponse: {2}, {3} remove item operation ->  {4}({5}) {6}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
-			*FString(__FUNCTION__), bSuccess ? "succeeded" : "failed",
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() RemoveItemResponse: failed, {2} remove item operation ->  {3} {4}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__),
 			*Execute_GetPlayerId(this),
-			DatabaseId, *Id.ToString(),
+			*Id.ToString(),
 			bDropItem ? "(dropped)" : ""
 		);
 	}
@@ -534,249 +550,1084 @@ void UInventoryComponent::HandleRemoveItemSuccess_Implementation(const FGuid& Id
 
 
 
-#pragma region Saving and Loading
-F_InventorySaveInformation UInventoryComponent::GetInventorySaveInformation()
+#pragma region Batch Operations
+#pragma region Add Items
+bool UInventoryComponent::TryAddItems_Implementation(const TArray<F_InventoryOperationItem>& Items)
 {
-	/*
-		UPlayerSaveInformation* SaveInformation = NewObject<UPlayerSaveInformation>();
-		if (SaveInformation)
-		{
-			SaveInformation->CharacterInformation = SaveData;
-			UGameplayStatics::SaveGameToSlot(SaveInformation, SaveData.PlatformId, SaveData.NetId);
-			OnSaveData.Broadcast();
-		}
-
-		FString SlotName = SaveData.PlatformId; // + SaveData.NetId;
-		UPlayerSaveInformation* SaveInformation = Cast<UPlayerSaveInformation>(UGameplayStatics::LoadGameFromSlot(SaveData.PlatformId, SaveData.NetId));
-		if (SaveInformation) SaveData = SaveInformation->CharacterInformation;
-	*/
-	
-	TArray<FS_Item> InventoryItems;
-
-	if (!QuestItems.IsEmpty()) for (auto &[Id, Item] : QuestItems) InventoryItems.Add(CreateSavedItem(Item));
-	if (!CommonItems.IsEmpty()) for (auto &[Id, Item] : CommonItems) InventoryItems.Add(CreateSavedItem(Item));
-	if (!Weapons.IsEmpty()) for (auto &[Id, Item] : Weapons) InventoryItems.Add(CreateSavedItem(Item));
-	if (!Armors.IsEmpty()) for (auto &[Id, Item] : Armors) InventoryItems.Add(CreateSavedItem(Item));
-	if (!Materials.IsEmpty()) for (auto &[Id, Item] : Materials) InventoryItems.Add(CreateSavedItem(Item));
-	if (!Notes.IsEmpty()) for (auto &[Id, Item] : Notes) InventoryItems.Add(CreateSavedItem(Item));
-	
-	F_InventorySaveInformation SaveInformation;
-	SaveInformation.InventoryItems = InventoryItems;
-
-	return SaveInformation;
-}
+	if (!GetCharacter() || Items.IsEmpty()) return false;
 
-
-void UInventoryComponent::LoadInventoryInformation(const F_InventorySaveInformation& SaveInformation)
-{
-	if (!GetCharacter() || !Character->HasAuthority()) return;
-	if (bDebugSaveInformation)
+	// Items from the world use their own id. New items are given their id by the server
+	TArray<F_InventoryOperationItem> BatchItems = Items;
+	for (F_InventoryOperationItem& Item : BatchItems)
 	{
-		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading the [{2}][{3}]'s inventory from saved information.",
-			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
-			);
-		ListSavedInventory(SaveInformation);
+		const TScriptInterface<IInventoryItemInterface> InventoryItem = Item.InventoryItemInterface.Get();
+		Item.Id = InventoryItem.GetInterface() ? InventoryItem->Execute_GetId(InventoryItem.GetObject()) : FGuid();
 	}
 	
-	// Server logic
-	CurrentInventorySaveData = SaveInformation;
-	SaveState = ESaveState::ESave_SaveReady;
-
-	// Client logic
-	Client_BeginLoadingInventoryData();
-	
-	// Load inventory items @note We might get errors if we send over everything altogether, so this is divided into multiple functions
-	TArray<FS_Item> SavedItems;
-	for (int i = 0; i < SaveInformation.InventoryItems.Num(); i++)
+	// If the server calls the function, just handle it. Otherwise send every item to the server at once and wait for the response
+	if (Character->IsLocallyControlled())
 	{
-		SavedItems.Add(SaveInformation.InventoryItems[i]);
-		if (SavedItems.Num() >= 45)
-		{
-			Client_LoadSomeInventoryData(SavedItems);
-			SavedItems.Empty();
-		}
+		const int32 BatchId = AddPendingBatch(BatchItems);
+		Execute_AddItemsPendingClientLogic(this, BatchItems);
+		Server_TryAddItems(BatchId, BatchItems);
+		return true;
 	}
-	if (!SavedItems.IsEmpty())
+	else if (Character->HasAuthority())
 	{
-		Client_LoadSomeInventoryData(SavedItems);
+		TArray<EInventoryOperationResult> Results;
+		HandleAddItems(BatchItems, Results);
+		HandleAddItemsResult(F_InventoryBatchResult(BatchItems, Results));
+		return true;
 	}
-	
-	Client_LoadSaveDataCompleted();
-}
 
+	return false;
+}
 
-void UInventoryComponent::Client_BeginLoadingInventoryData_Implementation()
-{
-	ClientInventorySaveData.NetId = NetId;
-	ClientInventorySaveData.PlatformId = PlatformId;
 
-	SaveState = ESaveState::ESave_Pending;
-	ClientInventorySaveData.InventoryItems.Empty();
-}
-void UInventoryComponent::Client_LoadSomeInventoryData_Implementation(const TArray<FS_Item>& Items)
+void UInventoryComponent::Server_TryAddItems_Implementation(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items)
 {
-	// Retrieve some of the items that were sent from the server
-	for (FS_Item Item : Items)
+	// Only the server creates ids for new items
+	TArray<F_InventoryOperationItem> BatchItems = Items;
+	for (F_InventoryOperationItem& Item : BatchItems)
 	{
-		ClientInventorySaveData.InventoryItems.Add(Item);
+		const TScriptInterface<IInventoryItemInterface> InventoryItem = Item.InventoryItemInterface.Get();
+		Item.Id = InventoryItem.GetInterface() ? InventoryItem->Execute_GetId(InventoryItem.GetObject()) : FGuid();
 	}
-}
-void UInventoryComponent::Client_LoadSaveDataCompleted_Implementation()
-{
-	if (GetCharacter()) UE_LOGFMT(InventoryLog, Warning, "LoadSaveData finished on the {0}, inventory items: {1}", *UEnum::GetValueAsString(Character->GetLocalRole()), ClientInventorySaveData.InventoryItems.Num());
-	
-	// Update the CurrentInventorySaveData value in preparation for when the inventory is updated
-	CurrentInventorySaveData = ClientInventorySaveData;
-	SaveState = ESaveState::ESave_SaveReady;
 
-	// Clear out the pending values
-	ClientInventorySaveData.NetId = NetId;
-	ClientInventorySaveData.PlatformId = PlatformId;
-	ClientInventorySaveData.InventoryItems.Empty();
+	TArray<EInventoryOperationResult> Results;
+	HandleAddItems(BatchItems, Results);
+	Client_AddItemsResponse(BatchId, Results);
 }
 
 
-bool UInventoryComponent::UpdateInventoryInformation(const F_InventorySaveInformation& SaveInformation)
+void UInventoryComponent::HandleAddItems(TArray<F_InventoryOperationItem>& Items, TArray<EInventoryOperationResult>& OutResults)
 {
-	bool bSuccessfullySavedInventory = true;
-	if (SaveInformation.InventoryItems.IsEmpty()) return false;
+	OutResults.Reset(Items.Num());
+	Inventory.Reserve(Inventory.Num() + FMath::Min(Items.Num(), MaxBatchSize));
 
-	if (bDebugSaveInformation)
-	{
-		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading [{2}][{3}]'s inventory from saved information.",
-			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
-		);
-	}
-	
-	for (const FS_Item SavedItem : SaveInformation.InventoryItems)
+	// Claim every world item before any of them are added, so other players can't take part of the batch while it's being added (and the same item can't be added twice)
+	TArray<TScriptInterface<IInventoryItemInterface>> ClaimedItems;
+	for (int32 i = 0; i < Items.Num(); i++)
 	{
-		F_Item Item;
-		Execute_GetDataBaseItem(this, SavedItem.ItemName, Item);
+		F_InventoryOperationItem& Item = Items[i];
+		if (i >= MaxBatchSize)
+		{
+			OutResults.Add(EInventoryOperationResult::Result_Invalid);
+			continue;
+		}
 
-		// Update the item information with saved item's information
-		Item.Id = SavedItem.Id;
-		Item.SortOrder = SavedItem.SortOrder;
+		if (!Item.Id.IsValid()) Item.Id = UInventoryItemHandleAllocator::AllocateItemId();
 
-		if (Item.IsValid())
+		const TScriptInterface<IInventoryItemInterface> InventoryItem = Item.InventoryItemInterface.Get();
+		if (InventoryItem.GetInterface())
 		{
-			TMap<FGuid, F_Item>& InventoryList = GetInventoryList(Item.ItemType);
-			InventoryList.Add(Item.GetId(), Item);
+			if (!InventoryItem->Execute_IsSafeToAdjustItem(InventoryItem.GetObject()))
+			{
+				OutResults.Add(EInventoryOperationResult::Result_Locked);
+				continue;
+			}
+
+			InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), Character);
+			if (InventoryItem->Execute_GetPlayerPending(InventoryItem.GetObject()) != Character)
+			{
+				OutResults.Add(EInventoryOperationResult::Result_Locked);
+				continue;
+			}
+			ClaimedItems.Add(InventoryItem);
 		}
-		else bSuccessfullySavedInventory = false;
+		OutResults.Add(EInventoryOperationResult::Result_Succeeded);
 	}
 
-	if (bDebugSaveInformation)
+	// Add the claimed items in one pass
+	TArray<F_InventoryOperationItem> AddedItems;
+	AddedItems.Reserve(Items.Num());
+	for (int32 i = 0; i < OutResults.Num(); i++)
 	{
-		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading done, here's [{2}][{3}]'s inventory information.",
-			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
-		);
-		ListInventory();
-		
-	}
+		if (EInventoryOperationResult::Result_Succeeded != OutResults[i]) continue;
 
-	// Let the client know the save information has been completed
-	OnLoadSaveData.Broadcast(bSuccessfullySavedInventory);
-	return bSuccessfullySavedInventory;
-}
+		const F_InventoryOperationItem& Item = Items[i];
+		const F_Item AddedItem = Call_HandleAddItem(this, Item.Id, Item.DatabaseId, Item.InventoryItemInterface, Item.Type, Item.Quantity);
+		OutResults[i] = AddedItem.IsValid() ? EInventoryOperationResult::Result_Succeeded : EInventoryOperationResult::Result_Failed;
+		if (AddedItem.IsValid()) AddedItems.Add(Item);
+	}
 
+	// Remove the scope locks
+	for (const TScriptInterface<IInventoryItemInterface>& InventoryItem : ClaimedItems)
+	{
+		if (InventoryItem->Execute_GetPlayerPending(InventoryItem.GetObject()) == Character) InventoryItem->Execute_SetPlayerPending(InventoryItem.GetObject(), nullptr);
+	}
 
-void UInventoryComponent::UpdateInventoryAfterRetrievingSaveInformation()
-{
-	// if (bCharacterReady && PlayerState && PlayerState->GetSaveState() == ESaveState::ESave_SaveReady) SaveInformation();
-	if (SaveState == ESaveState::ESave_SaveReady)
+	if (bDebugInventory_Server)
 	{
-		SaveState = ESaveState::ESave_Saved;
-		UpdateInventoryInformation(CurrentInventorySaveData);
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() added {2}/{3} items to {4}'s inventory", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), AddedItems.Num(), Items.Num(), *Execute_GetPlayerId(this)
+		);
 	}
+	
+	if (!AddedItems.IsEmpty()) Execute_HandleItemsAdditionSuccess(this, AddedItems);
 }
 
 
-FS_Item UInventoryComponent::CreateSavedItem(const F_Item& Item) const
+bool UInventoryComponent::TryLootItems(const TArray<UObject*>& WorldItems)
 {
-	if (!Item.IsValid()) return FS_Item();
-	return FS_Item(Item.Id, Item.ItemName, Item.SortOrder);
-}
-#pragma endregion 
+	TArray<F_InventoryOperationItem> Items;
+	Items.Reserve(WorldItems.Num());
+	for (UObject* WorldItem : WorldItems)
+	{
+		const TScriptInterface<IInventoryItemInterface> InventoryItem = WorldItem;
+		if (!InventoryItem.GetInterface()) continue;
 
+		Items.Emplace(FGuid(), InventoryItem->Execute_GetItemName(WorldItem), InventoryItem->Execute_GetItemType(WorldItem), WorldItem);
+	}
 
+	return Execute_TryAddItems(this, Items);
+}
 
-#pragma region Utility
-F_Item UInventoryComponent::InternalGetInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch)
+
+bool UInventoryComponent::TryLootArea(const float Radius)
 {
-	F_Item Item = *CreateInventoryObject();
+	if (!GetCharacter() || Radius <= 0.0f) return false;
 
-	// Search for the item in the inventory, and return it
-	if (EItemType::Inv_None != InventorySectionToSearch)
+	if (Character->IsLocallyControlled())
 	{
-		TMap<FGuid, F_Item>& InventoryList = GetInventoryList(InventorySectionToSearch);
-		if (InventoryList.Contains(Id))
-		{
-			Item = InventoryList[Id];
-			return Item;
-		}
+		Server_TryLootArea(Radius);
+		return true;
 	}
-
-	// if nothing is specified then search through everything
-	for (int i = 0; i < static_cast<int>(EItemType::Inv_MAX); i++)
+	else if (Character->HasAuthority())
 	{
-		const EItemType ItemType = static_cast<EItemType>(i);
-		TMap<FGuid, F_Item>& InventoryList = GetInventoryList(ItemType);
-		if (InventoryList.Contains(Id))
-		{
-			Item = InventoryList[Id];
-			return Item;
+		TArray<F_InventoryOperationItem> Items;
+		TArray<EInventoryOperationResult> Results;
+		HandleLootArea(Radius, Items, Results);
+		HandleAddItemsResult(F_InventoryBatchResult(Items, Results));
+		return true;
+	}
+
+	return false;
+}
+
+
+void UInventoryComponent::Server_TryLootArea_Implementation(const float Radius)
+{
+	TArray<F_InventoryOperationItem> Items;
+	TArray<EInventoryOperationResult> Results;
+	HandleLootArea(Radius, Items, Results);
+	Client_LootAreaResponse(Items, Results);
+}
+
+
+void UInventoryComponent::HandleLootArea(const float Radius, TArray<F_InventoryOperationItem>& OutItems, TArray<EInventoryOperationResult>& OutResults)
+{
+	OutItems.Reset();
+	OutResults.Reset();
+	
+	const UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this);
+	if (!GetCharacter() || !WorldItemIndex) return;
+
+	// Don't trust the client's radius
+	TArray<FInventoryWorldItemQueryResult> NearbyItems;
+	WorldItemIndex->FindItemsInRadius(Character->GetActorLocation(), FMath::Min(Radius, MaxLootRadius), NearbyItems, MaxBatchSize);
+
+	UInventoryWorldItemManager* WorldItemManager = GetWorld()->GetSubsystem<UInventoryWorldItemManager>();
+	OutItems.Reserve(NearbyItems.Num());
+	for (const FInventoryWorldItemQueryResult& NearbyItem : NearbyItems)
+	{
+		// Lightweight items are turned into world items so they're added like any other item in the world
+		UObject* WorldItem = NearbyItem.Item;
+		if (!WorldItem && WorldItemManager) WorldItem = WorldItemManager->PromoteWorldItem(NearbyItem.Id);
+
+		const TScriptInterface<IInventoryItemInterface> InventoryItem = WorldItem;
+		if (!InventoryItem.GetInterface()) continue;
+
+		OutItems.Emplace(InventoryItem->Execute_GetId(WorldItem), InventoryItem->Execute_GetItemName(WorldItem), InventoryItem->Execute_GetItemType(WorldItem), WorldItem);
+	}
+
+	if (!OutItems.IsEmpty()) HandleAddItems(OutItems, OutResults);
+}
+
+
+void UInventoryComponent::Client_LootAreaResponse_Implementation(const TArray<F_InventoryOperationItem>& Items, const TArray<EInventoryOperationResult>& Results)
+{
+	HandleAddItemsResult(F_InventoryBatchResult(Items, Results));
+}
+
+
+void UInventoryComponent::Client_AddItemsResponse_Implementation(const int32 BatchId, const TArray<EInventoryOperationResult>& Results)
+{
+	TArray<F_InventoryOperationItem> BatchItems;
+	if (!PendingBatches.RemoveAndCopyValue(BatchId, BatchItems)) return;
+	HandleAddItemsResult(F_InventoryBatchResult(BatchItems, Results));
+}
+
+
+void UInventoryComponent::HandleAddItemsResult(const F_InventoryBatchResult& Result)
+{
+	const TArray<F_InventoryOperationItem> FailedItems = Result.GetItems(false);
+	if (!FailedItems.IsEmpty()) Execute_HandleItemsAdditionFail(this, FailedItems);
+	OnInventoryItemsAdditionResult.Broadcast(Result);
+}
+
+
+void UInventoryComponent::AddItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_AddItemPendingClientLogic(this, Item.DatabaseId, Item.InventoryItemInterface, Item.Type);
+}
+
+
+void UInventoryComponent::HandleItemsAdditionFail_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_HandleItemAdditionFail(this, Item.Id, Item.DatabaseId, Item.InventoryItemInterface, Item.Type);
+}
+
+
+void UInventoryComponent::HandleItemsAdditionSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+	// Return the world items to their pools at once, the hook for each item skips the ones that have already been released
+	TArray<AActor*> WorldItems;
+	WorldItems.Reserve(Items.Num());
+	for (const F_InventoryOperationItem& Item : Items)
+	{
+		if (AActor* WorldItem = Cast<AActor>(Item.InventoryItemInterface.Get())) WorldItems.Add(WorldItem);
+	}
+	UInventoryWorldItemPool::ReleaseOrDestroy(WorldItems);
+	
+	for (const F_InventoryOperationItem& Item : Items) Execute_HandleItemAdditionSuccess(this, Item.Id, Item.DatabaseId, Item.InventoryItemInterface, Item.Type);
+}
+#pragma endregion 
+
+
+#pragma region Transfer Items
+bool UInventoryComponent::TryTransferItems_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	if (!GetCharacter() || Items.IsEmpty() || !OtherInventoryInterface) return false;
+
+	if (Character->IsLocallyControlled())
+	{
+		const int32 BatchId = AddPendingBatch(Items);
+		Execute_TransferItemsPendingClientLogic(this, Items, OtherInventoryInterface);
+		Server_TryTransferItems(BatchId, Items, OtherInventoryInterface);
+		return true;
+	}
+	else if (Character->HasAuthority())
+	{
+		TArray<F_InventoryOperationItem> BatchItems = Items;
+		TArray<EInventoryOperationResult> Results;
+		HandleTransferItems(BatchItems, OtherInventoryInterface, Results);
+		HandleTransferItemsResult(F_InventoryBatchResult(BatchItems, Results), OtherInventoryInterface);
+		return true;
+	}
+
+	return false;
+}
+
+
+void UInventoryComponent::Server_TryTransferItems_Implementation(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	TArray<F_InventoryOperationItem> BatchItems = Items;
+	TArray<EInventoryOperationResult> Results;
+	HandleTransferItems(BatchItems, OtherInventoryInterface, Results);
+	
+	// The client only needs the results, and which inventory each item was transferred from
+	TArray<bool> FromThisInventory;
+	FromThisInventory.Reserve(BatchItems.Num());
+	for (const F_InventoryOperationItem& Item : BatchItems) FromThisInventory.Add(Item.bFromThisInventory);
+	Client_TransferItemsResponse(BatchId, Results, FromThisInventory, OtherInventoryInterface);
+}
+
+
+void UInventoryComponent::HandleTransferItems(TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface, TArray<EInventoryOperationResult>& OutResults)
+{
+	OutResults.Init(EInventoryOperationResult::Result_Invalid, Items.Num());
+	const UInventoryContainerComponent* Container = Cast<UInventoryContainerComponent>(OtherInventoryInterface);
+	if (!OtherInventoryInterface || !OtherInventoryInterface->Implements<UInventoryInterface>() || OtherInventoryInterface == this) return;
+	if (Items.Num() > MaxBatchSize || (Container && !Container->IsViewer(this))) return;
+	
+	// Every item is moved with one transaction, so either all of them are transferred or none of them are
+	FInventoryTransaction Transfer;
+	for (F_InventoryOperationItem& Item : Items)
+	{
+		Item.bFromThisInventory = Item.Id.IsValid() && Call_ContainsItem(this, Item.Id, Item.Type);
+		if (Item.bFromThisInventory) Transfer.MoveItem(this, OtherInventoryInterface, Item.Id, Item.Type, Item.Quantity);
+		else Transfer.MoveItem(OtherInventoryInterface, this, Item.Id, Item.Type, Item.Quantity);
+	}
+	const EInventoryOperationResult Result = Transfer.Commit(GetTransactionClaimant(), false);
+
+	const TArray<EInventoryOperationResult>& TransferResults = Transfer.GetResults();
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		if (EInventoryOperationResult::Result_Succeeded == Result) OutResults[i] = EInventoryOperationResult::Result_Succeeded;
+		else if (!Items[i].Id.IsValid()) OutResults[i] = EInventoryOperationResult::Result_Invalid;
+		else if (TransferResults.IsValidIndex(i) && EInventoryOperationResult::Result_Locked == TransferResults[i]) OutResults[i] = EInventoryOperationResult::Result_Locked;
+		else OutResults[i] = EInventoryOperationResult::Result_Failed;
+	}
+
+	if (bDebugInventory_Server)
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() {2}: transferring {3} items between {4} and {5}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), *UEnum::GetValueAsString(Result), Items.Num(), *Execute_GetPlayerId(this), *GetNameSafe(OtherInventoryInterface)
+		);
+	}
+}
+
+
+void UInventoryComponent::Client_TransferItemsResponse_Implementation(const int32 BatchId, const TArray<EInventoryOperationResult>& Results, const TArray<bool>& FromThisInventory, UObject* OtherInventoryInterface)
+{
+	TArray<F_InventoryOperationItem> BatchItems;
+	if (!PendingBatches.RemoveAndCopyValue(BatchId, BatchItems)) return;
+	for (int32 i = 0; i < BatchItems.Num() && i < FromThisInventory.Num(); i++) BatchItems[i].bFromThisInventory = FromThisInventory[i];
+	HandleTransferItemsResult(F_InventoryBatchResult(BatchItems, Results), OtherInventoryInterface);
+}
+
+
+void UInventoryComponent::HandleTransferItemsResult(const F_InventoryBatchResult& Result, UObject* OtherInventoryInterface)
+{
+	const TArray<F_InventoryOperationItem> FailedItems = Result.GetItems(false);
+	const TArray<F_InventoryOperationItem> TransferredItems = Result.GetItems(true);
+	if (!FailedItems.IsEmpty()) Execute_HandleTransferItemsFail(this, FailedItems, OtherInventoryInterface);
+	if (!TransferredItems.IsEmpty()) Execute_HandleTransferItemsSuccess(this, TransferredItems, OtherInventoryInterface);
+	OnInventoryItemsTransferResult.Broadcast(Result);
+}
+
+
+EInventoryOperationResult UInventoryComponent::TradeItems(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface, const TArray<F_InventoryOperationItem>& OtherItems)
+{
+	if (!GetOwner() || !GetOwner()->HasAuthority() || !OtherInventoryInterface || OtherInventoryInterface == this) return EInventoryOperationResult::Result_Invalid;
+	if (Items.Num() + OtherItems.Num() > MaxBatchSize) return EInventoryOperationResult::Result_Invalid;
+
+	FInventoryTransaction Trade;
+	for (const F_InventoryOperationItem& Item : Items) Trade.MoveItem(this, OtherInventoryInterface, Item.Id, Item.Type, Item.Quantity);
+	for (const F_InventoryOperationItem& Item : OtherItems) Trade.MoveItem(OtherInventoryInterface, this, Item.Id, Item.Type, Item.Quantity);
+	const EInventoryOperationResult Result = Trade.Commit(GetTransactionClaimant());
+
+	if (bDebugInventory_Server)
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() {2}: {3} items from {4}, {5} items from {6}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), *UEnum::GetValueAsString(Result), Items.Num(), *Execute_GetPlayerId(this), OtherItems.Num(), *GetNameSafe(OtherInventoryInterface)
+		);
+	}
+	return Result;
+}
+
+
+UObject* UInventoryComponent::GetTransactionClaimant()
+{
+	// Containers don't have a character, the items are claimed by the actor that has the inventory
+	return GetCharacter() ? static_cast<UObject*>(Character.Get()) : static_cast<UObject*>(GetOwner());
+}
+
+
+void UInventoryComponent::Client_TransactionResponse_Implementation(const F_InventoryTransactionResult& Result)
+{
+	HandleTransactionResult(Result);
+}
+
+
+void UInventoryComponent::HandleTransactionResult(const F_InventoryTransactionResult& Result)
+{
+	OnInventoryTransactionResult.Broadcast(Result);
+}
+
+
+bool UInventoryComponent::TryOpenContainer(UInventoryContainerComponent* Container)
+{
+	if (!GetCharacter() || !Container) return false;
+
+	if (Character->IsLocallyControlled())
+	{
+		Server_OpenContainer(Container);
+		return true;
+	}
+	else if (Character->HasAuthority())
+	{
+		return Container->AddViewer(this);
+	}
+
+	return false;
+}
+
+
+bool UInventoryComponent::TryCloseContainer(UInventoryContainerComponent* Container)
+{
+	if (!GetCharacter() || !Container) return false;
+
+	if (Character->IsLocallyControlled())
+	{
+		Server_CloseContainer(Container);
+		return true;
+	}
+	else if (Character->HasAuthority())
+	{
+		Container->RemoveViewer(this);
+		return true;
+	}
+
+	return false;
+}
+
+
+void UInventoryComponent::Server_OpenContainer_Implementation(UInventoryContainerComponent* Container)
+{
+	const bool bOpenedContainer = Container && Container->AddViewer(this);
+	if (bDebugInventory_Server)
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() {2} {3} {4}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), *Execute_GetPlayerId(this), bOpenedContainer ? "opened" : "failed to open", *GetNameSafe(Container ? Container->GetOwner() : nullptr)
+		);
+	}
+}
+
+
+void UInventoryComponent::Server_CloseContainer_Implementation(UInventoryContainerComponent* Container)
+{
+	if (Container) Container->RemoveViewer(this);
+}
+
+
+void UInventoryComponent::Client_ContainerContents_Implementation(UInventoryContainerComponent* Container, const TArray<FInventoryItemInstance>& Contents)
+{
+	if (Container) Container->ReceiveContents(Contents);
+}
+
+
+void UInventoryComponent::Client_ContainerChanges_Implementation(UInventoryContainerComponent* Container, const TArray<FInventoryItemInstance>& Changes, const TArray<FGuid>& Removals)
+{
+	if (Container) Container->ReceiveChanges(Changes, Removals);
+}
+
+
+void UInventoryComponent::Client_ContainerClosed_Implementation(UInventoryContainerComponent* Container)
+{
+	if (Container) Container->ClearContents();
+}
+
+
+void UInventoryComponent::TransferItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_TransferItemPendingClientLogic(this, Item.Id, OtherInventoryInterface, Item.Type);
+}
+
+
+void UInventoryComponent::HandleTransferItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_HandleTransferItemFail(this, Item.Id, OtherInventoryInterface, Item.bFromThisInventory);
+}
+
+
+void UInventoryComponent::HandleTransferItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_HandleTransferItemSuccess(this, Item.Id, OtherInventoryInterface, Item.bFromThisInventory);
+}
+#pragma endregion 
+
+
+#pragma region Remove Items
+bool UInventoryComponent::TryRemoveItems_Implementation(const TArray<F_InventoryOperationItem>& Items, const bool bDropItems)
+{
+	if (!GetCharacter() || Items.IsEmpty()) return false;
+
+	if (Character->IsLocallyControlled())
+	{
+		const int32 BatchId = AddPendingBatch(Items);
+		Execute_RemoveItemsPendingClientLogic(this, Items, bDropItems);
+		Server_TryRemoveItems(BatchId, Items, bDropItems);
+		return true;
+	}
+	else if (Character->HasAuthority())
+	{
+		TArray<EInventoryOperationResult> Results;
+		HandleRemoveItems(Items, bDropItems, Results);
+		HandleRemoveItemsResult(F_InventoryBatchResult(Items, Results), bDropItems);
+		return true;
+	}
+
+	return false;
+}
+
+
+void UInventoryComponent::Server_TryRemoveItems_Implementation(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items, const bool bDropItems)
+{
+	TArray<EInventoryOperationResult> Results;
+	HandleRemoveItems(Items, bDropItems, Results);
+	Client_RemoveItemsResponse(BatchId, Results, bDropItems);
+}
+
+
+void UInventoryComponent::HandleRemoveItems(const TArray<F_InventoryOperationItem>& Items, const bool bDropItems, TArray<EInventoryOperationResult>& OutResults)
+{
+	OutResults.Reset(Items.Num());
+
+	TArray<F_InventoryOperationItem> RemovedItems;
+	TArray<UObject*> SpawnedItems;
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		const F_InventoryOperationItem& Item = Items[i];
+		if (i >= MaxBatchSize || !Item.Id.IsValid() || !Inventory.Contains(Item.Id))
+		{
+			OutResults.Add(i >= MaxBatchSize || !Item.Id.IsValid() ? EInventoryOperationResult::Result_Invalid : EInventoryOperationResult::Result_Failed);
+			continue;
+		}
+
+		UObject* SpawnedItem = nullptr;
+		const bool bRemovedItem = Call_HandleRemoveItem(this, Item.Id, Item.Type, Item.Quantity, bDropItems, SpawnedItem);
+		OutResults.Add(bRemovedItem ? EInventoryOperationResult::Result_Succeeded : EInventoryOperationResult::Result_Failed);
+		if (bRemovedItem)
+		{
+			// The spawned items are at the same index as their item, items that weren't dropped don't have one
+			RemovedItems.Add(Item);
+			SpawnedItems.Add(SpawnedItem);
+		}
+	}
+
+	if (bDebugInventory_Server)
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() removed {2}/{3} items from {4}'s inventory {5}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()),
+			*FString(__FUNCTION__), RemovedItems.Num(), Items.Num(), *Execute_GetPlayerId(this), bDropItems ? "(dropped)" : ""
+		);
+	}
+	
+	if (!RemovedItems.IsEmpty()) Execute_HandleRemoveItemsSuccess(this, RemovedItems, bDropItems, SpawnedItems);
+}
+
+
+void UInventoryComponent::Client_RemoveItemsResponse_Implementation(const int32 BatchId, const TArray<EInventoryOperationResult>& Results, const bool bDropItems)
+{
+	TArray<F_InventoryOperationItem> BatchItems;
+	if (!PendingBatches.RemoveAndCopyValue(BatchId, BatchItems)) return;
+	HandleRemoveItemsResult(F_InventoryBatchResult(BatchItems, Results), bDropItems);
+}
+
+
+void UInventoryComponent::HandleRemoveItemsResult(const F_InventoryBatchResult& Result, const bool bDropItems)
+{
+	const TArray<F_InventoryOperationItem> FailedItems = Result.GetItems(false);
+	if (!FailedItems.IsEmpty()) Execute_HandleRemoveItemsFail(this, FailedItems, bDropItems);
+	OnInventoryItemsRemovalResult.Broadcast(Result);
+}
+
+
+void UInventoryComponent::RemoveItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, const bool bDropItems)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_RemoveItemPendingClientLogic(this, Item.Id, Item.Type, bDropItems);
+}
+
+
+void UInventoryComponent::HandleRemoveItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, const bool bDropItems)
+{
+	for (const F_InventoryOperationItem& Item : Items) Execute_HandleRemoveItemFail(this, Item.Id, Item.Type, bDropItems, nullptr);
+}
+
+
+void UInventoryComponent::HandleRemoveItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, const bool bDropItems, const TArray<UObject*>& SpawnedItems)
+{
+	for (int32 Index = 0; Index < Items.Num(); Index++)
+	{
+		Execute_HandleRemoveItemSuccess(this, Items[Index].Id, Items[Index].Type, bDropItems, SpawnedItems.IsValidIndex(Index) ? SpawnedItems[Index] : nullptr);
+	}
+}
+#pragma endregion
+
+
+int32 UInventoryComponent::AddPendingBatch(const TArray<F_InventoryOperationItem>& Items)
+{
+	const int32 BatchId = ++LastBatchId;
+	PendingBatches.Add(BatchId, Items);
+	return BatchId;
+}
+#pragma endregion
+
+
+
+
+#pragma region Replication
+void UInventoryComponent::OnInventoryItemAdded(const FInventoryItemInstance& Item)
+{
+	if (bDebugInventory_Client && !GetOwner()->HasAuthority())
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() {2} + {3}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *FString(__FUNCTION__), *Execute_GetPlayerId(this), *Item.Id.ToString());
+	}
+	
+	if (GetOwner()->HasAuthority()) RecordSaveJournalEntry(EInventorySaveOperation::Save_Add, Item);
+	if (OnInventoryItemAdditionSuccess.IsBound()) OnInventoryItemAdditionSuccess.Broadcast(Inventory.ResolveItem(Item), nullptr);
+
+	// Saved items are received like any other item
+	if (NumSavedItems > 0 && !GetOwner()->HasAuthority())
+	{
+		OnLoadSaveDataProgress.Broadcast(GetSaveDataLoadProgress());
+		FinishLoadingSaveData();
+	}
+}
+
+
+void UInventoryComponent::OnInventoryItemChanged(const FInventoryItemInstance& Item)
+{
+	if (GetOwner()->HasAuthority()) RecordSaveJournalEntry(EInventorySaveOperation::Save_Update, Item);
+	if (OnInventoryItemUpdated.IsBound()) OnInventoryItemUpdated.Broadcast(Inventory.ResolveItem(Item));
+}
+
+
+void UInventoryComponent::OnInventoryItemRemoved(const FInventoryItemInstance& Item)
+{
+	if (bDebugInventory_Client && !GetOwner()->HasAuthority())
+	{
+		UE_LOGFMT(InventoryLog, Log, "({0}) {1}() {2} - {3}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *FString(__FUNCTION__), *Execute_GetPlayerId(this), *Item.Id.ToString());
+	}
+	
+	if (GetOwner()->HasAuthority()) RecordSaveJournalEntry(EInventorySaveOperation::Save_Remove, Item);
+	if (OnInventoryItemRemovalSuccess.IsBound()) OnInventoryItemRemovalSuccess.Broadcast(Inventory.ResolveItem(Item), nullptr);
+}
+#pragma endregion
+
+
+
+
+#pragma region Saving and Loading
+F_InventorySaveInformation UInventoryComponent::GetInventorySaveInformation()
+{
+	// Writing this to a save slot on the game thread stalls the server, use the UInventorySavePipeline to save and load inventories instead
+	F_InventorySaveInformation SaveInformation;
+	if (!UInventoryItemCatalog::Get()) return SaveInformation;
+	
+	SaveInformation.InventoryItems.Reserve(Inventory.Num());
+	for (const FInventoryItemInstance& Item : Inventory.GetItems())
+	{
+		SaveInformation.InventoryItems.Add(CreateSavedItemFromInstance(Item));
+	}
+
+	SaveInformation.SaveVersion = SaveVersion;
+	return SaveInformation;
+}
+
+
+F_InventorySaveDelta UInventoryComponent::GetInventorySaveDelta(const bool bForceFullSnapshot)
+{
+	F_InventorySaveDelta SaveDelta(NetId, PlatformId);
+	SaveDelta.BaseVersion = SaveVersion;
+	SaveDelta.Version = SaveVersion;
+	if (!GetOwner() || !GetOwner()->HasAuthority()) return SaveDelta;
+	if (!bForceFullSnapshot && !HasUnsavedChanges()) return SaveDelta;
+
+	for (int32 Section = 0; Section < static_cast<int32>(EItemType::Inv_MAX); Section++)
+	{
+		if (DirtySaveSections & (1u << Section)) SaveDelta.DirtySections.Add(static_cast<EItemType>(Section));
+	}
+
+	// Save every item if there's more changes than items, otherwise just save the changes
+	SaveDelta.Version = ++SaveVersion;
+	if (bForceFullSnapshot || bNeedsFullSave || SaveJournal.Num() >= Inventory.Num())
+	{
+		SaveDelta.bFullSnapshot = true;
+		SaveDelta.InventoryItems = GetInventorySaveInformation().InventoryItems;
+	}
+	else
+	{
+		SaveDelta.Entries = MoveTemp(SaveJournal);
+	}
+
+	if (bDebugSaveInformation)
+	{
+		UE_LOGFMT(InventoryLog, Log, "{0}() [{1}][{2}] saved version {3}, snapshot: {4}, changes: {5}",
+			*FString(__FUNCTION__), NetId, PlatformId, SaveDelta.Version, SaveDelta.bFullSnapshot, SaveDelta.bFullSnapshot ? SaveDelta.InventoryItems.Num() : SaveDelta.Entries.Num()
+		);
+	}
+
+	ResetSaveJournal();
+	bNeedsFullSave = false;
+	return SaveDelta;
+}
+
+
+void UInventoryComponent::MarkInventorySaveDirty()
+{
+	SaveJournal.Empty();
+	SaveJournalLookup.Empty();
+	bNeedsFullSave = true;
+}
+
+
+bool UInventoryComponent::HasUnsavedChanges() const
+{
+	return bNeedsFullSave || DirtySaveSections != 0 || !SaveJournal.IsEmpty();
+}
+
+
+bool UInventoryComponent::IsSaveSectionDirty(const EItemType Type) const
+{
+	return (DirtySaveSections & (1u << FInventoryItemStore::GetSectionIndex(Type))) != 0;
+}
+
+
+bool UInventoryComponent::ApplyInventorySaveDelta(F_InventorySaveInformation& SaveInformation, const F_InventorySaveDelta& SaveDelta)
+{
+	// The loaded ItemDefIds are only for the items that were saved
+	SaveInformation.ItemDefIds.Reset();
+	if (SaveDelta.bFullSnapshot)
+	{
+		SaveInformation.InventoryItems = SaveDelta.InventoryItems;
+		SaveInformation.SaveVersion = SaveDelta.Version;
+		return true;
+	}
+
+	// The changes are only valid for the save they were created from
+	if (SaveDelta.BaseVersion != SaveInformation.SaveVersion) return false;
+	if (SaveDelta.Entries.IsEmpty()) return true;
+
+	TArray<FS_Item>& Items = SaveInformation.InventoryItems;
+	TMap<FGuid, int32> Indices;
+	Indices.Reserve(Items.Num());
+	for (int32 i = 0; i < Items.Num(); i++) Indices.Add(Items[i].Id, i);
+
+	for (const FS_InventorySaveJournalEntry& Entry : SaveDelta.Entries)
+	{
+		if (EInventorySaveOperation::Save_Remove == Entry.Operation)
+		{
+			// Move the last item into the removed item's place
+			int32 Index;
+			if (!Indices.RemoveAndCopyValue(Entry.Item.Id, Index)) continue;
+			if (Index != Items.Num() - 1) Indices[Items.Last().Id] = Index;
+			Items.RemoveAtSwap(Index, 1, false);
+		}
+		else if (const int32* Index = Indices.Find(Entry.Item.Id))
+		{
+			Items[*Index] = Entry.Item;
+		}
+		else
+		{
+			Indices.Add(Entry.Item.Id, Items.Add(Entry.Item));
+		}
+	}
+
+	SaveInformation.SaveVersion = SaveDelta.Version;
+	return true;
+}
+
+
+void UInventoryComponent::LoadInventoryInformation(const F_InventorySaveInformation& SaveInformation)
+{
+	if (!GetCharacter() || !Character->HasAuthority()) return;
+	if (bDebugSaveInformation)
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading the [{2}][{3}]'s inventory from saved information.",
+			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
+			);
+		ListSavedInventory(SaveInformation);
+	}
+	
+	// Server logic
+	CurrentInventorySaveData = SaveInformation;
+	SaveState = ESaveState::ESave_SaveReady;
+	SaveVersion = SaveInformation.SaveVersion;
+
+	// The items are replicated to the client as they're added, it only needs to know how many to expect
+	Client_BeginLoadingInventoryData(SaveInformation.InventoryItems.Num());
+
+	// Add the save information to the server's inventory
+	UpdateInventoryAfterRetrievingSaveInformation();
+}
+
+
+void UInventoryComponent::Client_BeginLoadingInventoryData_Implementation(const int32 NumItems)
+{
+	// The server (and it's own player) already has the items
+	if (GetOwner()->HasAuthority()) return;
+
+	SaveState = ESaveState::ESave_Pending;
+	NumSavedItems = NumItems;
+	bClientSaveSucceeded = true;
+	OnLoadSaveDataProgress.Broadcast(GetSaveDataLoadProgress());
+}
+void UInventoryComponent::Client_LoadSaveDataCompleted_Implementation(const bool bSucceeded, const int32 NumItems)
+{
+	if (GetOwner()->HasAuthority()) return;
+
+	SaveState = ESaveState::ESave_SaveReady;
+	NumSavedItems = NumItems;
+	bClientSaveSucceeded = bSucceeded;
+	FinishLoadingSaveData();
+}
+
+
+void UInventoryComponent::FinishLoadingSaveData()
+{
+	// Wait for the rest of the items if the server finished before they were replicated
+	if (SaveState != ESaveState::ESave_SaveReady || Inventory.Num() < NumSavedItems) return;
+
+	SaveState = ESaveState::ESave_Saved;
+	if (GetCharacter()) UE_LOGFMT(InventoryLog, Log, "LoadSaveData finished on the {0}, inventory items: {1}", *UEnum::GetValueAsString(Character->GetLocalRole()), Inventory.Num());
+
+	NumSavedItems = 0;
+	OnLoadSaveDataProgress.Broadcast(1.0f);
+	OnLoadSaveData.Broadcast(bClientSaveSucceeded);
+}
+
+
+bool UInventoryComponent::UpdateInventoryInformation(const F_InventorySaveInformation& SaveInformation)
+{
+	bool bSuccessfullySavedInventory = true;
+	if (SaveInformation.InventoryItems.IsEmpty()) return false;
+
+	// The items are replicated from the server, the client just needs to know it's save information has been loaded
+	if (!GetOwner()->HasAuthority())
+	{
+		OnLoadSaveData.Broadcast(bSuccessfullySavedInventory);
+		return bSuccessfullySavedInventory;
+	}
+
+	if (bDebugSaveInformation)
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading [{2}][{3}]'s inventory from saved information.",
+			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
+		);
+	}
+	
+	Inventory.Reserve(Inventory.Num() + SaveInformation.InventoryItems.Num());
+	bSuccessfullySavedInventory = AddSavedItems(SaveInformation.InventoryItems, 0, SaveInformation.InventoryItems.Num(), SaveInformation.ItemDefIds);
+
+	if (bDebugSaveInformation)
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading done, here's [{2}][{3}]'s inventory information.",
+			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
+		);
+		ListInventory();
+		
+	}
+
+	// Let the client know the save information has been completed
+	OnLoadSaveData.Broadcast(bSuccessfullySavedInventory);
+	return bSuccessfullySavedInventory;
+}
+
+
+int32 UInventoryComponent::ApplySaveInformation(const int32 MaxItems)
+{
+	if (!IsApplyingSaveInformation()) return 0;
+	const TArray<FS_Item>& SavedItems = CurrentInventorySaveData.InventoryItems;
+
+	// Clients receive the items through replication, and there's nothing to add if the save information is empty
+	if (!GetOwner()->HasAuthority() || SavedItems.IsEmpty())
+	{
+		SaveApplicationIndex = INDEX_NONE;
+		if (GetOwner()->HasAuthority()) Client_LoadSaveDataCompleted(true, Inventory.Num());
+		return 0;
+	}
+
+	if (SaveApplicationIndex == 0)
+	{
+		if (bDebugSaveInformation && GetCharacter())
+		{
+			UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading [{2}][{3}]'s inventory from saved information.",
+				*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
+			);
 		}
+		
+		Inventory.Reserve(Inventory.Num() + SavedItems.Num());
+	}
+
+	const int32 NumItems = FMath::Min(FMath::Max(MaxItems, 0), SavedItems.Num() - SaveApplicationIndex);
+	if (!AddSavedItems(SavedItems, SaveApplicationIndex, NumItems, CurrentInventorySaveData.ItemDefIds)) bSaveApplicationSucceeded = false;
+	SaveApplicationIndex += NumItems;
+	if (SaveApplicationIndex < SavedItems.Num()) return NumItems;
+
+	// Every item has been added. Future saves only need the changes from here, unless the inventory doesn't match what was saved
+	SaveApplicationIndex = INDEX_NONE;
+	ResetSaveJournal();
+	bNeedsFullSave = !bSaveApplicationSucceeded || Inventory.Num() != SavedItems.Num();
+	if (bDebugSaveInformation && GetCharacter())
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0} {1}() Loading done, here's [{2}][{3}]'s inventory information.",
+			*UEnum::GetValueAsString(Character->GetLocalRole()), *FString(__FUNCTION__), NetId, PlatformId
+		);
+		ListInventory();
 	}
+
+	// Let the client know the save information has been completed
+	OnLoadSaveData.Broadcast(bSaveApplicationSucceeded);
+	Client_LoadSaveDataCompleted(bSaveApplicationSucceeded, Inventory.Num());
+	return NumItems;
+}
+
+
+bool UInventoryComponent::AddSavedItems(const TArray<FS_Item>& Items, const int32 StartIndex, const int32 NumItems, const TConstArrayView<int32> SavedItemDefIds)
+{
+	if (NumItems <= 0 || !Items.IsValidIndex(StartIndex) || !Items.IsValidIndex(StartIndex + NumItems - 1)) return NumItems == 0;
 	
-	return Item;
+	// Use the saved ItemDefIds if the catalog hasn't changed since the items were saved, otherwise find every item in the catalog at once
+	TArray<int32> ItemDefIds;
+	if (SavedItemDefIds.Num() == Items.Num())
+	{
+		ItemDefIds.Append(SavedItemDefIds.GetData() + StartIndex, NumItems);
+	}
+	else
+	{
+		TArray<FName> DatabaseIds;
+		DatabaseIds.Reserve(NumItems);
+		for (int32 i = StartIndex; i < StartIndex + NumItems; i++) DatabaseIds.Add(Items[i].ItemName);
+		if (const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get()) Catalog->ResolveItemDefIds(DatabaseIds, ItemDefIds);
+	}
+
+	bool bAddedEveryItem = true;
+	for (int32 i = 0; i < NumItems; i++)
+	{
+		const FS_Item& SavedItem = Items[StartIndex + i];
+		const bool bAddedItem = ItemDefIds.IsValidIndex(i) && INDEX_NONE != ItemDefIds[i]
+			? Inventory.Add(FInventoryItemInstance(SavedItem.Id, SavedItem.SortOrder, ItemDefIds[i], FMath::Max(SavedItem.Quantity, 1))) != INDEX_NONE
+			: AddItemFromDatabase(SavedItem.Id, SavedItem.ItemName, SavedItem.SortOrder, SavedItem.Quantity);
+		
+		if (!bAddedItem) bAddedEveryItem = false;
+	}
+
+	return bAddedEveryItem;
+}
+
+
+void UInventoryComponent::UpdateInventoryAfterRetrievingSaveInformation()
+{
+	if (SaveState != ESaveState::ESave_SaveReady) return;
+	SaveState = ESaveState::ESave_Saved;
+	SaveApplicationIndex = 0;
+	bSaveApplicationSucceeded = true;
+
+	// Let the save scheduler add the items, so a lot of inventories loading at once are spread across multiple frames
+	if (UInventorySaveScheduler* SaveScheduler = GetWorld() ? GetWorld()->GetSubsystem<UInventorySaveScheduler>() : nullptr)
+	{
+		SaveScheduler->ScheduleSaveApplication(this);
+	}
+	else
+	{
+		ApplySaveInformation(MAX_int32);
+	}
+}
+
+
+float UInventoryComponent::GetSaveDataLoadProgress() const
+{
+	if (NumSavedItems <= 0) return SaveState == ESaveState::ESave_Pending ? 0.0f : 1.0f;
+	return FMath::Clamp(static_cast<float>(Inventory.Num()) / NumSavedItems, 0.0f, 1.0f);
 }
 
 
-void UInventoryComponent::InternalRemoveInventoryItem_Implementation(const FGuid& Id, const EItemType InventorySectionToSearch)
+FS_Item UInventoryComponent::CreateSavedItem(const F_Item& Item) const
+{
+	if (!Item.IsValid()) return FS_Item();
+	return FS_Item(Item.Id, Item.ItemName, Item.SortOrder, Item.Quantity);
+}
+
+
+FS_Item UInventoryComponent::CreateSavedItemFromInstance(const FInventoryItemInstance& Item) const
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	return FS_Item(Item.Id, Catalog ? Catalog->GetDatabaseId(Item.DefinitionId) : NAME_None, Item.SortOrder, Item.Quantity);
+}
+
+
+void UInventoryComponent::RecordSaveJournalEntry(const EInventorySaveOperation Operation, const FInventoryItemInstance& Item)
 {
-	TMap<FGuid, F_Item>& InventoryList = GetInventoryList(InventorySectionToSearch);
-	if (InventoryList.Contains(Id))
+	const F_Item* Definition = FInventoryItemStore::GetDefinition(Item.DefinitionId);
+	DirtySaveSections |= 1u << FInventoryItemStore::GetSectionIndex(Definition ? Definition->ItemType : EItemType::Inv_None);
+	if (bNeedsFullSave) return;
+
+	// Removed items only need their id
+	const FS_InventorySaveJournalEntry Entry(Operation, EInventorySaveOperation::Save_Remove != Operation ? CreateSavedItemFromInstance(Item) : FS_Item(Item.Id, FName(), Item.SortOrder, Item.Quantity));
+	
+	// Only the latest change to an item needs to be saved
+	if (const int32* Index = SaveJournalLookup.Find(Item.Id))
+	{
+		SaveJournal[*Index] = Entry;
+		return;
+	}
+
+	// Save everything next time instead of tracking every change
+	if (SaveJournal.Num() >= MaxSaveJournalEntries)
 	{
-		InventoryList.Remove(Id);
+		MarkInventorySaveDirty();
+		return;
 	}
-	// else
-	// {
-	// 	for (int i = 0; i < static_cast<int>(EItemType::Inv_MAX); i++)
-	// 	{
-	// 		const EItemType ItemType = static_cast<EItemType>(i);
-	// 		InventoryList = GetInventoryList(ItemType);
-	// 		if (InventoryList.Contains(Id))
-	// 		{
-	// 			InventoryList.Remove(Id);
-	// 			return;
-	// 		}
-	// 	}
-	// }
+
+	SaveJournalLookup.Add(Item.Id, SaveJournal.Add(Entry));
+}
+
+
+void UInventoryComponent::ResetSaveJournal()
+{
+	SaveJournal.Reset();
+	SaveJournalLookup.Reset();
+	DirtySaveSections = 0;
+}
+#pragma endregion 
+
+
+
+#pragma region Utility
+F_Item UInventoryComponent::InternalGetInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch)
+{
+	// Every section shares the same lookup, so the section to search isn't needed to find the item. The item's returned directly instead of copying it out of a pooled item
+	F_Item Item;
+	Inventory.GetItem(Id, Item);
+	return Item;
+}
+
+
+void UInventoryComponent::InternalRemoveInventoryItem_Implementation(const FGuid& Id, const EItemType InventorySectionToSearch, const int32 Quantity)
+{
+	const FInventoryItemInstance* Item = Inventory.Find(Id);
+	if (!Item) return;
+	
+	if (Quantity <= 0 || Quantity >= Item->Quantity) Inventory.Remove(Id);
+	else Inventory.SetQuantity(Id, Item->Quantity - Quantity);
 }
 
 
 void UInventoryComponent::InternalAddInventoryItem_Implementation(const F_Item& Item)
 {
-	TMap<FGuid, F_Item>& InventoryList = GetInventoryList(Item.ItemType);
-	InventoryList.Add(Item.Id, Item);
+	AddInventoryItem(Item);
+}
+
+
+FGuid UInventoryComponent::AddInventoryItem(const F_Item& Item)
+{
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Item.IsValid() || !Catalog) return FGuid();
+	return AddStackedItem(Item.Id, Catalog->AddDefinition(Item), Item.Quantity, Item.SortOrder);
+}
+
+
+int32 UInventoryComponent::GetItemCount(const FName DatabaseId) const
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	return Catalog ? Inventory.GetCount(Catalog->FindItemDefId(DatabaseId)) : 0;
+}
+
+
+TArray<FGuid> UInventoryComponent::GetItemIdsWithDatabaseId(const FName DatabaseId) const
+{
+	TArray<FGuid> Ids;
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Catalog) return Ids;
+	
+	const TConstArrayView<int32> Slots = Inventory.GetDefinitionSlots(Catalog->FindItemDefId(DatabaseId));
+	Ids.Reserve(Slots.Num());
+	for (const int32 Slot : Slots) Ids.Add(Inventory.GetItems()[Slot].Id);
+	return Ids;
 }
 
 
-TMap<FGuid, F_Item>& UInventoryComponent::GetInventoryList(EItemType InventorySectionToSearch)
+bool UInventoryComponent::HasItems(const TMap<FName, int32>& Requirements) const
 {
-	if (EItemType::Inv_QuestItem == InventorySectionToSearch) return QuestItems;
-	if (EItemType::Inv_Item == InventorySectionToSearch) return CommonItems;
-	if (EItemType::Inv_Weapon == InventorySectionToSearch) return Weapons;
-	if (EItemType::Inv_Armor == InventorySectionToSearch) return Armors;
-	if (EItemType::Inv_Material == InventorySectionToSearch) return Materials;
-	if (EItemType::Inv_Note == InventorySectionToSearch) return Notes;
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Catalog) return Requirements.IsEmpty();
 	
-	if (EItemType::Inv_Custom == InventorySectionToSearch)
+	for (const TPair<FName, int32>& Requirement : Requirements)
 	{
-		// TODO: Custom item logic here (map enums to int values)
+		if (Inventory.GetCount(Catalog->FindItemDefId(Requirement.Key)) < Requirement.Value) return false;
 	}
+	return true;
+}
 
-	return CommonItems;
+
+TArray<F_Item> UInventoryComponent::GetInventoryItems(const EItemType InventorySectionToSearch) const
+{
+	TArray<F_Item> Items;
+	Items.Reserve(Inventory.GetSection(InventorySectionToSearch).Num());
+	Inventory.ForEachItemInSection(InventorySectionToSearch, [this, &Items](const FInventoryItemInstance& Item) { Items.Add(Inventory.ResolveItem(Item)); });
+	return Items;
 }
 
 
@@ -785,7 +1636,14 @@ bool UInventoryComponent::GetItem_Implementation(F_Item& ReturnedItem, FGuid Id,
 {
 	if (!Id.IsValid()) return false;
 
-	// search for the item in the inventory
+	// search for the item in the inventory. Items are copied straight into the returned item if the event isn't overridden, so pooled items keep their memory
+	if (!IsEventOverridden(EInventoryNativeEvent::InternalGetInventoryItem))
+	{
+		if (Inventory.GetItem(Id, ReturnedItem)) return true;
+		ReturnedItem.Reset();
+		return false;
+	}
+
 	ReturnedItem = Execute_InternalGetInventoryItem(this, Id, InventorySectionToSearch);
 	if (ReturnedItem.IsValid()) return true;
 	return false;
@@ -794,14 +1652,47 @@ bool UInventoryComponent::GetItem_Implementation(F_Item& ReturnedItem, FGuid Id,
 
 bool UInventoryComponent::GetDataBaseItem_Implementation(const FName Id, F_Item& Item)
 {
-	if (!ItemDatabase || Id.IsNone()) return false;
-	if (const FInventory_ItemDatabase* ItemData = ItemDatabase->FindRow<FInventory_ItemDatabase>(Id, TEXT("Inventory Item Data Context")))
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	return Catalog && Catalog->CreateItem(Id, Item);
+}
+
+
+bool UInventoryComponent::AddItemFromDatabase(const FGuid& Id, const FName DatabaseId, const int32 SortOrder, const int32 Quantity)
+{
+	const int32 DefinitionId = ResolveItemDefId(DatabaseId);
+	return Inventory.Add(FInventoryItemInstance(Id, SortOrder, DefinitionId, FMath::Max(Quantity, 1))) != INDEX_NONE;
+}
+
+
+int32 UInventoryComponent::ResolveItemDefId(const FName DatabaseId)
+{
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Catalog) return INDEX_NONE;
+	
+	// Items that aren't in the catalog are retrieved with GetDataBaseItem (in case it's been overridden) and added to the catalog
+	int32 DefinitionId = Catalog->FindItemDefId(DatabaseId);
+	if (INDEX_NONE == DefinitionId)
 	{
-		Item = ItemData->ItemInformation;
-		Item.Id = FGuid::NewGuid();
+		F_Item Definition;
+		if (Call_GetDataBaseItem(this, DatabaseId, Definition)) DefinitionId = Catalog->AddDefinition(Definition);
 	}
+	
+	return DefinitionId;
+}
 
-	return false;
+
+FGuid UInventoryComponent::AddStackedItem(const FGuid& Id, const int32 DefinitionId, const int32 Quantity, const int32 SortOrder)
+{
+	return FInventoryItemStore::AddStacked(Id, DefinitionId, Quantity, SortOrder,
+		[this, DefinitionId](const int32 MaxStackSize) -> const FInventoryItemInstance*
+		{
+			const int32 Slot = Inventory.FindStackWithRoom(DefinitionId, MaxStackSize);
+			return INDEX_NONE != Slot ? &Inventory.GetItems()[Slot] : nullptr;
+		},
+		[this](const FGuid& StackId, const int32 StackQuantity) { Inventory.SetQuantity(StackId, StackQuantity); },
+		[this](const FInventoryItemInstance& Stack) { return INDEX_NONE != Inventory.Add(Stack); },
+		[this](const FGuid& StackId) { return Inventory.Contains(StackId); }
+	);
 }
 
 
@@ -838,22 +1729,45 @@ bool UInventoryComponent::GetCharacter()
 
 TScriptInterface<IInventoryItemInterface> UInventoryComponent::SpawnWorldItem_Implementation(const F_Item& Item, const FTransform& Location)
 {
-	if (GetWorld() && Item.WorldClass)
+	// The world class is loaded now if it hasn't been requested beforehand (UInventoryItemAssets)
+	FTransform SpawnTransform = Location;
+	FVector SpawnLocation = SpawnTransform.GetLocation();
+	SpawnLocation.Z = SpawnLocation.Z + 34.0f;
+	SpawnTransform.SetLocation(SpawnLocation);
+
+	// Items with a world mesh can be dropped as lightweight world items, which aren't actors until someone interacts with them
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings && Settings->bDropLightweightWorldItems && !Item.WorldMesh.IsNull() && GetWorld())
+	{
+		UInventoryWorldItemManager* WorldItemManager = GetWorld()->GetSubsystem<UInventoryWorldItemManager>();
+		if (WorldItemManager && WorldItemManager->AddWorldItem(Item, SpawnTransform)) return nullptr;
+	}
+	
+	UClass* WorldClass = !Item.WorldClass.IsNull() ? Cast<UClass>(UInventoryItemAssets::LoadItemAsset(Item.WorldClass.ToSoftObjectPath())) : nullptr;
+	if (GetWorld() && WorldClass)
 	{
-		FActorSpawnParameters SpawnParameters;
-		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParameters.Owner = GetOwner();
-		FTransform SpawnTransform = Location;
-		FVector SpawnLocation = SpawnTransform.GetLocation();
-		SpawnLocation.Z = SpawnLocation.Z + 34.0f;
-		SpawnTransform.SetLocation(SpawnLocation);
+		// Dropped items are reused from the world's item pool instead of spawning a new actor every time
+		AItemBase* SpawnedItem = nullptr;
+		if (UInventoryWorldItemPool* WorldItemPool = GetWorld()->GetSubsystem<UInventoryWorldItemPool>())
+		{
+			SpawnedItem = WorldItemPool->AcquireWorldItem(WorldClass, SpawnTransform, Item, ItemDatabase, GetOwner());
+		}
+		else
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParameters.Owner = GetOwner();
+			SpawnedItem = GetWorld()->SpawnActor<AItemBase>(WorldClass, SpawnTransform, SpawnParameters);
+			if (SpawnedItem)
+			{
+				SpawnedItem->Execute_SetItemInformationDatabase(SpawnedItem, ItemDatabase);
+				SpawnedItem->Execute_SetItem(SpawnedItem, Item);
+			}
+		}
 	
-		if (AItemBase* SpawnedItem = GetWorld()->SpawnActor<AItemBase>(Item.WorldClass, SpawnTransform, SpawnParameters))
+		if (SpawnedItem)
 		{
-			const TScriptInterface<IInventoryItemInterface> WorldItem = SpawnedItem;
-			SpawnedItem->Execute_SetItemInformationDatabase(SpawnedItem, ItemDatabase);
-			SpawnedItem->Execute_SetItem(SpawnedItem, Item);
-			return WorldItem;
+			return TScriptInterface<IInventoryItemInterface>(SpawnedItem);
 		}
 		else
 		{
@@ -873,7 +1787,7 @@ TScriptInterface<IInventoryItemInterface> UInventoryComponent::SpawnWorldItem_Im
 FName UInventoryComponent::GetItemId(const FGuid& Id, EItemType Type, UObject* OtherInventory)
 {
 	F_Item Item;
-	Execute_GetItem(this, Item, Id, Type);
+	Call_GetItem(this, Item, Id, Type);
 
 	if (Item.IsValid())
 	{
@@ -886,11 +1800,98 @@ FName UInventoryComponent::GetItemId(const FGuid& Id, EItemType Type, UObject* O
 		return FName();
 	}
 	
-	Inventory->Execute_GetItem(Inventory.GetObject(), Item, Id, Type);
+	Call_GetItem(Inventory.GetObject(), Item, Id, Type);
 	return Item.ItemName;
 }
 
 
+bool UInventoryComponent::IsEventOverridden(const EInventoryNativeEvent Event) const
+{
+	if (!bFoundOverriddenEvents)
+	{
+		OverriddenEvents = FInventoryNativeEvents::GetOverriddenEvents(GetClass());
+		bFoundOverriddenEvents = true;
+	}
+	return EnumHasAnyFlags(OverriddenEvents, Event);
+}
+
+
+UInventoryComponent* UInventoryComponent::GetNativeInventory(UObject* InventoryObject, const EInventoryNativeEvent Event)
+{
+	UInventoryComponent* InventoryComponent = Cast<UInventoryComponent>(InventoryObject);
+	return InventoryComponent && !InventoryComponent->IsEventOverridden(Event) ? InventoryComponent : nullptr;
+}
+
+
+bool UInventoryComponent::Call_GetItem(UObject* InventoryObject, F_Item& ReturnedItem, const FGuid& Id, const EItemType InventorySectionToSearch)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::GetItem)) return InventoryComponent->GetItem_Implementation(ReturnedItem, Id, InventorySectionToSearch);
+	return Execute_GetItem(InventoryObject, ReturnedItem, Id, InventorySectionToSearch);
+}
+
+
+F_Item UInventoryComponent::Call_InternalGetInventoryItem(UObject* InventoryObject, const FGuid& Id, const EItemType InventorySectionToSearch)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::InternalGetInventoryItem)) return InventoryComponent->InternalGetInventoryItem_Implementation(Id, InventorySectionToSearch);
+	return Execute_InternalGetInventoryItem(InventoryObject, Id, InventorySectionToSearch);
+}
+
+
+bool UInventoryComponent::Call_ContainsItem(UObject* InventoryObject, const FGuid& Id, const EItemType InventorySectionToSearch)
+{
+	if (const UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::InternalGetInventoryItem)) return InventoryComponent->Inventory.Contains(Id);
+	return Execute_InternalGetInventoryItem(InventoryObject, Id, InventorySectionToSearch).IsValid();
+}
+
+
+FGuid UInventoryComponent::Call_InternalAddInventoryItem(UObject* InventoryObject, const F_Item& Item)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::InternalAddInventoryItem)) return InventoryComponent->AddInventoryItem(Item);
+
+	UInventoryContainerComponent* Container = Cast<UInventoryContainerComponent>(InventoryObject);
+	if (Container && !Container->GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UInventoryContainerComponent, InternalAddInventoryItem))) return Container->AddContainerItem(Item);
+
+	// Other inventories don't say where the item was added, so they're trusted to have added it
+	Execute_InternalAddInventoryItem(InventoryObject, Item);
+	return Item.IsValid() ? Item.Id : FGuid();
+}
+
+
+void UInventoryComponent::Call_InternalRemoveInventoryItem(UObject* InventoryObject, const FGuid& Id, const EItemType InventorySectionToSearch, const int32 Quantity)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::InternalRemoveInventoryItem)) InventoryComponent->InternalRemoveInventoryItem_Implementation(Id, InventorySectionToSearch, Quantity);
+	else Execute_InternalRemoveInventoryItem(InventoryObject, Id, InventorySectionToSearch, Quantity);
+}
+
+
+bool UInventoryComponent::Call_GetDataBaseItem(UObject* InventoryObject, const FName Id, F_Item& Item)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::GetDataBaseItem)) return InventoryComponent->GetDataBaseItem_Implementation(Id, Item);
+	return Execute_GetDataBaseItem(InventoryObject, Id, Item);
+}
+
+
+F_Item UInventoryComponent::Call_HandleAddItem(UObject* InventoryObject, const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::HandleAddItem)) return InventoryComponent->HandleAddItem_Implementation(Id, DatabaseId, InventoryItemInterface, Type, Quantity);
+	return Execute_HandleAddItem(InventoryObject, Id, DatabaseId, InventoryItemInterface, Type, Quantity);
+}
+
+
+bool UInventoryComponent::Call_HandleTransferItem(UObject* InventoryObject, const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::HandleTransferItem)) return InventoryComponent->HandleTransferItem_Implementation(Id, OtherInventoryInterface, Type, Quantity, bFromThisInventory);
+	return Execute_HandleTransferItem(InventoryObject, Id, OtherInventoryInterface, Type, Quantity, bFromThisInventory);
+}
+
+
+bool UInventoryComponent::Call_HandleRemoveItem(UObject* InventoryObject, const FGuid& Id, const EItemType Type, const int32 Quantity, const bool bDropItem, UObject*& SpawnedItem)
+{
+	if (UInventoryComponent* InventoryComponent = GetNativeInventory(InventoryObject, EInventoryNativeEvent::HandleRemoveItem)) return InventoryComponent->HandleRemoveItem_Implementation(Id, Type, Quantity, bDropItem, SpawnedItem);
+	return Execute_HandleRemoveItem(InventoryObject, Id, Type, Quantity, bDropItem, SpawnedItem);
+}
+
+
 FString UInventoryComponent::GetPlayerId_Implementation() const
 {
 	return "[" + FString::FromInt(NetId) + "][" + PlatformId + "]";
@@ -919,12 +1920,12 @@ void UInventoryComponent::ListInventory()
 	if (!GetCharacter()) return;
 	
 	TArray<FS_Item> ClientItems; // Used for capturing both the id and the database id
-	for (auto &[Id, Item] : QuestItems) ClientItems.Add(FS_Item(Id, Item.ItemName));
-	for (auto &[Id, Item] : CommonItems) ClientItems.Add(FS_Item(Id, Item.ItemName));
-	for (auto &[Id, Item] : Weapons) ClientItems.Add(FS_Item(Id, Item.ItemName));
-	for (auto &[Id, Item] : Armors) ClientItems.Add(FS_Item(Id, Item.ItemName));
-	for (auto &[Id, Item] : Materials) ClientItems.Add(FS_Item(Id, Item.ItemName));
-	for (auto &[Id, Item] : Notes) ClientItems.Add(FS_Item(Id, Item.ItemName));
+	ClientItems.Reserve(Inventory.Num());
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	for (const FInventoryItemInstance& Item : Inventory.GetItems())
+	{
+		ClientItems.Add(FS_Item(Item.Id, Catalog ? Catalog->GetDatabaseId(Item.DefinitionId) : NAME_None, Item.SortOrder, Item.Quantity));
+	}
 	Server_ListInventory(ClientItems, Character->HasAuthority());
 }
 
@@ -947,35 +1948,16 @@ void UInventoryComponent::Server_ListInventory_Implementation(const TArray<FS_It
 	UE_LOGFMT(InventoryLog, Log, "//----------------------------------------------------------------------------------------------------------------------------------/");
 	
 	// List the server's inventory values
-	if (!Weapons.IsEmpty()) 
-	{
-		ListInventoryMap(Weapons, FString("Armaments"));
-		for (auto &[Id, Item] : Weapons) ServerInventoryList.Add(Id, Item.ItemName); 
-	}
-	if (!Armors.IsEmpty()) 
-	{
-		ListInventoryMap(Armors, FString("Armors"));
-		for (auto &[Id, Item] : Armors) ServerInventoryList.Add(Id, Item.ItemName); 
-	}
-	if (!CommonItems.IsEmpty()) 
-	{
-		ListInventoryMap(CommonItems, FString("Common Items"));
-		for (auto &[Id, Item] : CommonItems) ServerInventoryList.Add(Id, Item.ItemName); 
-	}
-	if (!QuestItems.IsEmpty()) 
-	{
-		ListInventoryMap(QuestItems, FString("Quest Items"));
-		for (auto &[Id, Item] : QuestItems) ServerInventoryList.Add(Id, Item.ItemName); 
-	}
-	if (!Materials.IsEmpty()) 
-	{
-		ListInventoryMap(Materials, FString("Materials"));
-		for (auto &[Id, Item] : Materials) ServerInventoryList.Add(Id, Item.ItemName); 
-	}
-	if (!Notes.IsEmpty()) 
+	ListInventorySection(EItemType::Inv_Weapon, FString("Armaments"));
+	ListInventorySection(EItemType::Inv_Armor, FString("Armors"));
+	ListInventorySection(EItemType::Inv_Item, FString("Common Items"));
+	ListInventorySection(EItemType::Inv_QuestItem, FString("Quest Items"));
+	ListInventorySection(EItemType::Inv_Material, FString("Materials"));
+	ListInventorySection(EItemType::Inv_Note, FString("Notes"));
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	for (const FInventoryItemInstance& Item : Inventory.GetItems())
 	{
-		ListInventoryMap(Notes, FString("Notes"));
-		for (auto &[Id, Item] : Notes) ServerInventoryList.Add(Id, Item.ItemName); 
+		ServerInventoryList.Add(Item.Id, Catalog ? Catalog->GetDatabaseId(Item.DefinitionId) : NAME_None);
 	}
 	
 	// List the inventory items on client and server
@@ -985,7 +1967,7 @@ void UInventoryComponent::Server_ListInventory_Implementation(const TArray<FS_It
 	UE_LOGFMT(InventoryLog, Log, "|~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~/");
 	UE_LOGFMT(InventoryLog, Log, "| Id                                 | OnServer | OnClient | Display Name ");
 	UE_LOGFMT(InventoryLog, Log, "|~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~/");
-	for (auto &[Id, ItemName, i] : ClientItemList) if (!AllInventoryItems.Contains(Id)) AllInventoryItems.Add(Id, ItemName);
+	for (const FS_Item& Item : ClientItemList) if (!AllInventoryItems.Contains(Item.Id)) AllInventoryItems.Add(Item.Id, Item.ItemName);
 	for (auto &[Id, ItemName] : AllInventoryItems)
 	{
 		UE_LOGFMT(InventoryLog, Log, "|  {0}  |   {1}  |   {2}  | {3}",
@@ -1001,16 +1983,16 @@ void UInventoryComponent::Server_ListInventory_Implementation(const TArray<FS_It
 }
 
 
-void UInventoryComponent::ListInventoryMap(const TMap<FGuid, F_Item>& Map, FString ListName)
+void UInventoryComponent::ListInventorySection(const EItemType Section, FString ListName)
 {
-	if (!GetCharacter()) return;
+	if (!GetCharacter() || Inventory.GetSection(Section).IsEmpty()) return;
 
 	UE_LOGFMT(InventoryLog, Log, " ");
 	UE_LOGFMT(InventoryLog, Log, "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~/");
 	UE_LOGFMT(InventoryLog, Log, "// {0} ", ListName);
 	UE_LOGFMT(InventoryLog, Log, "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~/");
 	UE_LOGFMT(InventoryLog, Log, " ");
-	for (auto &[Id, Item] : Map) ListInventoryItem(Item);
+	Inventory.ForEachItemInSection(Section, [this](const FInventoryItemInstance& Item) { ListInventoryItem(Inventory.ResolveItem(Item)); });
 }
 
 
@@ -1028,8 +2010,8 @@ void UInventoryComponent::ListInventoryItem(const F_Item& Item)
 	UE_LOGFMT(InventoryLog, Log, "| Id: {0} ->  {1}", Item.ItemName, *Item.Id.ToString());
 	UE_LOGFMT(InventoryLog, Log, "| Type: {0}", *UEnum::GetValueAsString(Item.ItemType));
 	UE_LOGFMT(InventoryLog, Log, "| Description: {0}", *Item.Description);
-	UE_LOGFMT(InventoryLog, Log, "| ActualClass: {0}", Item.ActualClass ? *Item.ActualClass->GetName() : *FString("null"));
-	UE_LOGFMT(InventoryLog, Log, "| WorldClass: {0}", Item.WorldClass ? *Item.WorldClass->GetName() : *FString("null"));
+	UE_LOGFMT(InventoryLog, Log, "| ActualClass: {0}", !Item.ActualClass.IsNull() ? *Item.ActualClass.ToString() : *FString("null"));
+	UE_LOGFMT(InventoryLog, Log, "| WorldClass: {0}", !Item.WorldClass.IsNull() ? *Item.WorldClass.ToString() : *FString("null"));
 	UE_LOGFMT(InventoryLog, Log, "|--------------------------------------------//");
 	UE_LOGFMT(InventoryLog, Log, " ");
 }
@@ -0,0 +1,344 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventoryContainerComponent.h"
+
+#include "Inventory/InventoryComponent.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+
+UInventoryContainerComponent::UInventoryContainerComponent()
+{
+	// The container only replicates whether it's open, the contents are sent to the players that are viewing it
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+
+void UInventoryContainerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UInventoryContainerComponent, bOpen);
+}
+
+
+void UInventoryContainerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Closed containers don't need to be checked for replication
+	AActor* Owner = GetOwner();
+	if (bDormantWhenClosed && Owner && Owner->HasAuthority() && !bOpen && Owner->NetDormancy == DORM_Awake)
+	{
+		Owner->SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+
+void UInventoryContainerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetWorld()) GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+	Viewers.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+TArray<F_Item> UInventoryContainerComponent::GetContainerItems() const
+{
+	TArray<F_Item> ContainerItems;
+	ContainerItems.Reserve(Items.Num());
+	for (const FInventoryItemInstance& Item : Items)
+	{
+		F_Item ResolvedItem = FInventoryItemStore::ResolveItem(Item);
+		if (ResolvedItem.IsValid()) ContainerItems.Add(MoveTemp(ResolvedItem));
+	}
+	return ContainerItems;
+}
+
+
+bool UInventoryContainerComponent::IsViewer(const UInventoryComponent* Inventory) const
+{
+	return Inventory && Viewers.ContainsByPredicate([Inventory](const TWeakObjectPtr<UInventoryComponent>& Viewer) { return Viewer.Get() == Inventory; });
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Viewers																			//
+//----------------------------------------------------------------------------------//
+bool UInventoryContainerComponent::AddViewer(UInventoryComponent* Inventory)
+{
+	const AActor* Owner = GetOwner();
+	const AActor* ViewerActor = Inventory ? Inventory->GetOwner() : nullptr;
+	if (!Owner || !Owner->HasAuthority() || !ViewerActor) return false;
+	if (FVector::Dist(ViewerActor->GetActorLocation(), Owner->GetActorLocation()) > MaxViewDistance) return false;
+
+	// The contents are generated the first time anyone opens the container
+	if (!bGenerated)
+	{
+		bGenerated = true;
+		GenerateContents();
+		ChangedItems.Reset();
+		RemovedItems.Reset();
+	}
+
+	if (!IsViewer(Inventory)) Viewers.Add(Inventory);
+	Inventory->Client_ContainerContents(this, Items);
+	SetOpen(true);
+
+	if (!GetWorld()->GetTimerManager().IsTimerActive(ViewerTimer))
+	{
+		GetWorld()->GetTimerManager().SetTimer(ViewerTimer, this, &UInventoryContainerComponent::UpdateViewers, 0.5f, true);
+	}
+	return true;
+}
+
+
+void UInventoryContainerComponent::RemoveViewer(UInventoryComponent* Inventory)
+{
+	if (!Inventory || !IsViewer(Inventory)) return;
+
+	Viewers.RemoveAll([Inventory](const TWeakObjectPtr<UInventoryComponent>& Viewer) { return Viewer.Get() == Inventory; });
+	Inventory->Client_ContainerClosed(this);
+	if (Viewers.IsEmpty())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(ViewerTimer);
+		SetOpen(false);
+	}
+}
+
+
+void UInventoryContainerComponent::UpdateViewers()
+{
+	const AActor* Owner = GetOwner();
+	if (!Owner) return;
+
+	const TArray<TWeakObjectPtr<UInventoryComponent>> CurrentViewers = Viewers;
+	for (const TWeakObjectPtr<UInventoryComponent>& Viewer : CurrentViewers)
+	{
+		const AActor* ViewerActor = Viewer.IsValid() ? Viewer->GetOwner() : nullptr;
+		if (!ViewerActor)
+		{
+			Viewers.Remove(Viewer);
+		}
+		else if (FVector::Dist(ViewerActor->GetActorLocation(), Owner->GetActorLocation()) > MaxViewDistance)
+		{
+			RemoveViewer(Viewer.Get());
+		}
+	}
+
+	if (Viewers.IsEmpty())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(ViewerTimer);
+		SetOpen(false);
+	}
+}
+
+
+void UInventoryContainerComponent::SetOpen(const bool bIsOpen)
+{
+	if (bOpen == bIsOpen) return;
+	bOpen = bIsOpen;
+
+	// The last update (the container closing) is sent before the actor goes dormant
+	AActor* Owner = GetOwner();
+	if (bDormantWhenClosed && Owner) Owner->SetNetDormancy(bOpen ? DORM_Awake : DORM_DormantAll);
+	OnContainerOpenChanged.Broadcast(this);
+}
+
+
+void UInventoryContainerComponent::OnRep_Open()
+{
+	OnContainerOpenChanged.Broadcast(this);
+}
+
+
+void UInventoryContainerComponent::MarkItemChanged(const FGuid& Id, const bool bRemoved)
+{
+	if (Viewers.IsEmpty() || !GetWorld()) return;
+
+	const bool bScheduled = !ChangedItems.IsEmpty() || !RemovedItems.IsEmpty();
+	if (bRemoved)
+	{
+		ChangedItems.Remove(Id);
+		RemovedItems.AddUnique(Id);
+	}
+	else
+	{
+		ChangedItems.AddUnique(Id);
+	}
+
+	if (!bScheduled) GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UInventoryContainerComponent::SendChanges);
+}
+
+
+void UInventoryContainerComponent::SendChanges()
+{
+	TArray<FInventoryItemInstance> Changes;
+	Changes.Reserve(ChangedItems.Num());
+	for (const FGuid& Id : ChangedItems)
+	{
+		const int32 Index = FindItemIndex(Id);
+		if (Index != INDEX_NONE) Changes.Add(Items[Index]);
+	}
+
+	for (const TWeakObjectPtr<UInventoryComponent>& Viewer : Viewers)
+	{
+		if (Viewer.IsValid()) Viewer->Client_ContainerChanges(this, Changes, RemovedItems);
+	}
+
+	ChangedItems.Reset();
+	RemovedItems.Reset();
+}
+
+
+void UInventoryContainerComponent::ReceiveContents(const TArray<FInventoryItemInstance>& Contents)
+{
+	// A listen server's player views the server's container, the contents are already there
+	if (!GetOwner() || !GetOwner()->HasAuthority()) Items = Contents;
+	OnContainerUpdated.Broadcast(this);
+}
+
+
+void UInventoryContainerComponent::ReceiveChanges(const TArray<FInventoryItemInstance>& Changes, const TArray<FGuid>& Removals)
+{
+	if (!GetOwner() || !GetOwner()->HasAuthority())
+	{
+		for (const FGuid& Id : Removals)
+		{
+			const int32 Index = FindItemIndex(Id);
+			if (Index != INDEX_NONE) Items.RemoveAtSwap(Index, 1, false);
+		}
+
+		for (const FInventoryItemInstance& Change : Changes)
+		{
+			const int32 Index = FindItemIndex(Change.Id);
+			if (Index != INDEX_NONE) Items[Index] = Change;
+			else Items.Add(Change);
+		}
+	}
+
+	OnContainerUpdated.Broadcast(this);
+}
+
+
+void UInventoryContainerComponent::ClearContents()
+{
+	if (!GetOwner() || !GetOwner()->HasAuthority()) Items.Empty();
+	OnContainerUpdated.Broadcast(this);
+}
+
+
+int32 UInventoryContainerComponent::FindItemIndex(const FGuid& Id) const
+{
+	return Items.IndexOfByPredicate([&Id](const FInventoryItemInstance& Item) { return Item.Id == Id; });
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Contents																			//
+//----------------------------------------------------------------------------------//
+void UInventoryContainerComponent::GenerateContents_Implementation()
+{
+	// Each container has it's own seed, so containers with the same loot table don't all have the same items
+	const AActor* Owner = GetOwner();
+	const int32 Seed = LootSeed != 0 ? HashCombine(LootSeed, Owner ? GetTypeHash(Owner->GetFName()) : 0) : FMath::Rand();
+	FRandomStream Stream(Seed);
+
+	for (const F_InventoryContainerLoot& Item : Loot)
+	{
+		if (Item.DatabaseId.IsNone() || Stream.FRand() > Item.Chance) continue;
+
+		F_Item LootItem;
+		if (!Execute_GetDataBaseItem(this, Item.DatabaseId, LootItem)) continue;
+		LootItem.Quantity = Stream.RandRange(FMath::Max(Item.MinQuantity, 1), FMath::Max(Item.MinQuantity, Item.MaxQuantity));
+		Execute_InternalAddInventoryItem(this, LootItem);
+	}
+}
+
+
+F_Item UInventoryContainerComponent::InternalGetInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch)
+{
+	const int32 Index = FindItemIndex(Id);
+	return Index != INDEX_NONE ? FInventoryItemStore::ResolveItem(Items[Index]) : F_Item();
+}
+
+
+void UInventoryContainerComponent::InternalAddInventoryItem_Implementation(const F_Item& Item)
+{
+	AddContainerItem(Item);
+}
+
+
+FGuid UInventoryContainerComponent::AddContainerItem(const F_Item& Item)
+{
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Item.IsValid() || !Catalog) return FGuid();
+
+	// The items are stacked the same way as the inventory component's
+	const int32 DefinitionId = Catalog->AddDefinition(Item);
+	return FInventoryItemStore::AddStacked(Item.Id, DefinitionId, Item.Quantity, Item.SortOrder,
+		[this, DefinitionId](const int32 MaxStackSize) -> const FInventoryItemInstance*
+		{
+			return Items.FindByPredicate([DefinitionId, MaxStackSize](const FInventoryItemInstance& Stack) { return Stack.DefinitionId == DefinitionId && Stack.Quantity < MaxStackSize; });
+		},
+		[this](const FGuid& StackId, const int32 StackQuantity)
+		{
+			Items[FindItemIndex(StackId)].Quantity = StackQuantity;
+			MarkItemChanged(StackId, false);
+		},
+		[this](const FInventoryItemInstance& Stack)
+		{
+			Items.Add(Stack);
+			MarkItemChanged(Stack.Id, false);
+			return true;
+		},
+		[this](const FGuid& StackId) { return FindItemIndex(StackId) != INDEX_NONE; }
+	);
+}
+
+
+void UInventoryContainerComponent::InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch, const int32 Quantity)
+{
+	const int32 Index = FindItemIndex(Id);
+	if (Index == INDEX_NONE) return;
+
+	if (Quantity <= 0 || Quantity >= Items[Index].Quantity)
+	{
+		Items.RemoveAtSwap(Index, 1, false);
+		MarkItemChanged(Id, true);
+	}
+	else
+	{
+		Items[Index].Quantity -= Quantity;
+		MarkItemChanged(Id, false);
+	}
+}
+
+
+bool UInventoryContainerComponent::GetItem_Implementation(F_Item& ReturnedItem, FGuid Id, EItemType InventorySectionToSearch)
+{
+	ReturnedItem = Execute_InternalGetInventoryItem(this, Id, InventorySectionToSearch);
+	return ReturnedItem.IsValid();
+}
+
+
+bool UInventoryContainerComponent::GetDataBaseItem_Implementation(const FName Id, F_Item& Item)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	return Catalog && Catalog->CreateItem(Id, Item);
+}
+
+
+FString UInventoryContainerComponent::GetPlayerId_Implementation() const
+{
+	return GetNameSafe(GetOwner());
+}
@@ -13,7 +13,7 @@ void IInventoryInterface::AddItemPendingClientLogic_Implementation(FName Databas
 {
 }
 
-F_Item IInventoryInterface::HandleAddItem_Implementation(const FGuid& Id, FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type)
+F_Item IInventoryInterface::HandleAddItem_Implementation(const FGuid& Id, FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity)
 {
 	return F_Item();
 }
@@ -35,7 +35,7 @@ void IInventoryInterface::TransferItemPendingClientLogic_Implementation(const FG
 {
 }
 
-bool IInventoryInterface::HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, bool& bFromThisInventory)
+bool IInventoryInterface::HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory)
 {
 	return false;
 }
@@ -48,10 +48,6 @@ void IInventoryInterface::HandleTransferItemSuccess_Implementation(const FGuid&
 {
 }
 
-void IInventoryInterface::HandleTransferItemForOtherInventoryClientLogic(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem)
-{
-}
-
 bool IInventoryInterface::TryRemoveItem_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem)
 {
 	return false;
@@ -61,7 +57,7 @@ void IInventoryInterface::RemoveItemPendingClientLogic_Implementation(const FGui
 {
 }
 
-bool IInventoryInterface::HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem, UObject*& SpawnedItem)
+bool IInventoryInterface::HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const int32 Quantity, bool bDropItem, UObject*& SpawnedItem)
 {
 	return false;
 }
@@ -74,6 +70,57 @@ void IInventoryInterface::HandleRemoveItemSuccess_Implementation(const FGuid& Id
 {
 }
 
+bool IInventoryInterface::TryAddItems_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+	return false;
+}
+
+bool IInventoryInterface::TryTransferItems_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+	return false;
+}
+
+bool IInventoryInterface::TryRemoveItems_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems)
+{
+	return false;
+}
+
+void IInventoryInterface::AddItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+}
+
+void IInventoryInterface::HandleItemsAdditionFail_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+}
+
+void IInventoryInterface::HandleItemsAdditionSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items)
+{
+}
+
+void IInventoryInterface::TransferItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+}
+
+void IInventoryInterface::HandleTransferItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+}
+
+void IInventoryInterface::HandleTransferItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface)
+{
+}
+
+void IInventoryInterface::RemoveItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems)
+{
+}
+
+void IInventoryInterface::HandleRemoveItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems)
+{
+}
+
+void IInventoryInterface::HandleRemoveItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems, const TArray<UObject*>& SpawnedItems)
+{
+}
+
 
 F_Item IInventoryInterface::InternalGetInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch)
 {
@@ -84,7 +131,7 @@ void IInventoryInterface::InternalAddInventoryItem_Implementation(const F_Item&
 {
 }
 
-void IInventoryInterface::InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch)
+void IInventoryInterface::InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch, int32 Quantity)
 {
 }
 
@@ -108,6 +155,11 @@ F_Item* IInventoryInterface::CreateInventoryObject() const
 	return new F_Item();
 }
 
+void IInventoryInterface::ResetInventoryObject(F_Item& Item) const
+{
+	Item.Reset();
+}
+
 TScriptInterface<IInventoryItemInterface> IInventoryInterface::SpawnWorldItem_Implementation(const F_Item& Item, const FTransform& Location)
 {
 	return nullptr;
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventoryItemPool.h"
+
+int64 FInventoryItemPool::TotalAllocations = 0;
+
+
+FInventoryItemPool::~FInventoryItemPool()
+{
+	ensureMsgf(NumInUse == 0, TEXT("An inventory item pool was destroyed while %d of it's items were still in use"), NumInUse);
+}
+
+
+void FInventoryItemPool::SetAllocator(TFunction<F_Item*()>&& InAllocate, TFunction<void(F_Item&)>&& InReset)
+{
+	// Items from the previous allocator might be a different type
+	Empty();
+	Allocate = MoveTemp(InAllocate);
+	Reset = MoveTemp(InReset);
+}
+
+
+FInventoryItemPool::FPooledItem FInventoryItemPool::Acquire()
+{
+	NumInUse++;
+	if (!FreeItems.IsEmpty()) return FPooledItem(this, FreeItems.Pop(false).Release());
+
+	F_Item* Item = Allocate ? Allocate() : nullptr;
+	if (!Item) Item = new F_Item();
+	NumAllocations++;
+	TotalAllocations++;
+	return FPooledItem(this, Item);
+}
+
+
+void FInventoryItemPool::Empty()
+{
+	FreeItems.Empty();
+}
+
+
+void FInventoryItemPool::Release(F_Item* Item)
+{
+	NumInUse--;
+	if (FreeItems.Num() >= MaxFreeItems)
+	{
+		delete Item;
+		return;
+	}
+
+	if (Reset) Reset(*Item);
+	else Item->Reset();
+	FreeItems.Emplace(Item);
+}
@@ -0,0 +1,405 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventoryItemStore.h"
+
+#include "Item/InventoryItemCatalog.h"
+#include "Item/InventoryItemHandleAllocator.h"
+
+
+bool FInventoryItemInstance::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FInventoryItemHandle::NetSerializeId(Ar, Id);
+
+	// ItemDefIds aren't the same on every machine, the definition is only sent as it's ItemDefId if the client's catalog has it too
+	UInventoryItemCatalog::NetSerializeItemDefId(Ar, Map, DefinitionId);
+
+	// Offset by one so the default sort order (-1) is packed into a single byte
+	uint32 PackedSortOrder = static_cast<uint32>(SortOrder + 1);
+	uint32 PackedQuantity = static_cast<uint32>(FMath::Max(Quantity, 0));
+	Ar.SerializeIntPacked(PackedSortOrder);
+	Ar.SerializeIntPacked(PackedQuantity);
+	if (Ar.IsLoading())
+	{
+		SortOrder = static_cast<int32>(PackedSortOrder) - 1;
+		Quantity = static_cast<int32>(PackedQuantity);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+
+bool FInventoryItemStore::ItemsHaveObjectReferences()
+{
+	TArray<const FStructProperty*> EncounteredStructProperties;
+	for (TFieldIterator<FProperty> Property(FInventoryItemInstance::StaticStruct()); Property; ++Property)
+	{
+		if (Property->ContainsObjectReference(EncounteredStructProperties)) return true;
+	}
+	return false;
+}
+
+
+int32 FInventoryItemStore::Add(const FInventoryItemInstance& Item)
+{
+	const F_Item* Definition = GetDefinition(Item.DefinitionId);
+	if (!Item.Id.IsValid() || !Definition) return INDEX_NONE;
+	const int32 Section = GetSectionIndex(Definition->ItemType);
+
+	// Replace the item if it's already in the inventory, and move it to it's new section if the type changed
+	if (const int32* ExistingSlot = SlotLookup.Find(Item.Id))
+	{
+		const int32 Slot = *ExistingSlot;
+		FInventoryItemInstance& ExistingItem = Items[Slot];
+
+		// An older generation of the item's handle can't replace it, a newer generation takes it's place
+		if (UInventoryItemHandleAllocator::IsStaleItemId(Item.Id, ExistingItem.Id)) return INDEX_NONE;
+
+		// Only copy the item information, the replication id needs to stay the same
+		RemoveFromDefinition(Slot);
+		ExistingItem.Id = Item.Id;
+		ExistingItem.SortOrder = Item.SortOrder;
+		ExistingItem.DefinitionId = Item.DefinitionId;
+		ExistingItem.Quantity = Item.Quantity;
+		AddToDefinition(Slot);
+		MarkItemDirty(ExistingItem);
+
+		FInventorySlotSection& SlotSection = SlotSections[Slot];
+		if (SlotSection.Section != Section)
+		{
+			TArray<int32>& PreviousSection = Sections[SlotSection.Section];
+			PreviousSection.RemoveAtSwap(SlotSection.Position, 1, false);
+			if (PreviousSection.IsValidIndex(SlotSection.Position)) SlotSections[PreviousSection[SlotSection.Position]].Position = SlotSection.Position;
+
+			SlotSection.Section = Section;
+			SlotSection.Position = Sections[Section].Add(Slot);
+		}
+
+		if (Listener) Listener->OnInventoryItemChanged(ExistingItem);
+		return Slot;
+	}
+
+	const int32 Slot = Items.Add(Item);
+	SlotSections.AddUninitialized();
+	AddToLookup(Slot, Section);
+	MarkItemDirty(Items[Slot]);
+
+	if (Listener) Listener->OnInventoryItemAdded(Items[Slot]);
+	return Slot;
+}
+
+
+int32 FInventoryItemStore::Add(const F_Item& Item)
+{
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Item.IsValid() || !Catalog) return INDEX_NONE;
+	return Add(FInventoryItemInstance(Item.Id, Item.SortOrder, Catalog->AddDefinition(Item), FMath::Max(Item.Quantity, 1)));
+}
+
+
+bool FInventoryItemStore::Remove(const FGuid& Id)
+{
+	// Stale handles don't remove the current generation of the item
+	const int32* FoundSlot = SlotLookup.Find(Id);
+	if (!FoundSlot || Items[*FoundSlot].Id != Id) return false;
+	const int32 Slot = *FoundSlot;
+	SlotLookup.Remove(Id);
+	const FInventoryItemInstance RemovedItem = Items[Slot];
+
+	// Remove the slot from it's section and definition, and update the position of the slots that took it's place
+	const FInventorySlotSection SlotSection = SlotSections[Slot];
+	TArray<int32>& Section = Sections[SlotSection.Section];
+	Section.RemoveAtSwap(SlotSection.Position, 1, false);
+	if (Section.IsValidIndex(SlotSection.Position)) SlotSections[Section[SlotSection.Position]].Position = SlotSection.Position;
+	RemoveFromDefinition(Slot);
+
+	// Move the last item into the empty slot so the items stay packed
+	const int32 LastSlot = Items.Num() - 1;
+	if (Slot != LastSlot)
+	{
+		const FInventorySlotSection& MovedSlotSection = SlotSections[LastSlot];
+		SlotLookup.Add(Items[LastSlot].Id, Slot);
+		Sections[MovedSlotSection.Section][MovedSlotSection.Position] = Slot;
+		DefinitionSlots.FindChecked(Items[LastSlot].DefinitionId).Slots[MovedSlotSection.DefinitionPosition] = Slot;
+	}
+
+	Items.RemoveAtSwap(Slot, 1, false);
+	SlotSections.RemoveAtSwap(Slot, 1, false);
+	MarkArrayDirty();
+
+	if (Listener) Listener->OnInventoryItemRemoved(RemovedItem);
+	return true;
+}
+
+
+bool FInventoryItemStore::SetQuantity(const FGuid& Id, const int32 Quantity)
+{
+	const int32* Slot = SlotLookup.Find(Id);
+	if (!Slot || Items[*Slot].Id != Id) return false;
+	if (Quantity <= 0) return Remove(Id);
+
+	FInventoryItemInstance& Item = Items[*Slot];
+	if (Item.Quantity == Quantity) return true;
+
+	DefinitionSlots.FindChecked(Item.DefinitionId).Quantity += Quantity - Item.Quantity;
+	Item.Quantity = Quantity;
+	MarkItemDirty(Item);
+
+	if (Listener) Listener->OnInventoryItemChanged(Item);
+	return true;
+}
+
+
+int32 FInventoryItemStore::FindStackWithRoom(const int32 DefinitionId, const int32 MaxStackSize) const
+{
+	for (const int32 Slot : GetDefinitionSlots(DefinitionId))
+	{
+		if (Items[Slot].Quantity < MaxStackSize) return Slot;
+	}
+	return INDEX_NONE;
+}
+
+
+const FInventoryItemInstance* FInventoryItemStore::Find(const FGuid& Id) const
+{
+	const int32* Slot = SlotLookup.Find(Id);
+	return Slot && Items[*Slot].Id == Id ? &Items[*Slot] : nullptr;
+}
+
+
+bool FInventoryItemStore::GetItem(const FGuid& Id, F_Item& OutItem) const
+{
+	const FInventoryItemInstance* Item = Find(Id);
+	const F_Item* Definition = Item ? GetDefinition(Item->DefinitionId) : nullptr;
+	if (!Definition) return false;
+
+	// Copied into the item that's passed in, so pooled items reuse the memory of their strings
+	OutItem = *Definition;
+	OutItem.Id = Item->Id;
+	OutItem.SortOrder = Item->SortOrder;
+	OutItem.Quantity = Item->Quantity;
+	return true;
+}
+
+
+F_Item FInventoryItemStore::ResolveItem(const FInventoryItemInstance& Item)
+{
+	const F_Item* Definition = GetDefinition(Item.DefinitionId);
+	if (!Definition) return F_Item();
+
+	F_Item ResolvedItem = *Definition;
+	ResolvedItem.Id = Item.Id;
+	ResolvedItem.SortOrder = Item.SortOrder;
+	ResolvedItem.Quantity = Item.Quantity;
+	return ResolvedItem;
+}
+
+
+FGuid FInventoryItemStore::AddStacked(const FGuid& Id, const int32 DefinitionId, const int32 Quantity, const int32 SortOrder,
+	const TFunctionRef<const FInventoryItemInstance*(int32 MaxStackSize)> FindStackWithRoom,
+	const TFunctionRef<void(const FGuid& StackId, int32 StackQuantity)> SetQuantity,
+	const TFunctionRef<bool(const FInventoryItemInstance& Stack)> AddStack,
+	const TFunctionRef<bool(const FGuid& StackId)> Contains)
+{
+	const F_Item* Definition = GetDefinition(DefinitionId);
+	if (!Definition || Quantity <= 0) return FGuid();
+	const int32 MaxStackSize = FMath::Max(Definition->MaxStackSize, 1);
+	
+	// Fill the stacks that have room first
+	FGuid StackId;
+	int32 RemainingQuantity = Quantity;
+	while (RemainingQuantity > 0 && MaxStackSize > 1)
+	{
+		const FInventoryItemInstance* Stack = FindStackWithRoom(MaxStackSize);
+		if (!Stack) break;
+		
+		const int32 AddedQuantity = FMath::Min(RemainingQuantity, MaxStackSize - Stack->Quantity);
+		StackId = Stack->Id;
+		SetQuantity(StackId, Stack->Quantity + AddedQuantity);
+		RemainingQuantity -= AddedQuantity;
+	}
+	
+	// Then add new stacks for the rest. The first new stack keeps the item's id
+	FGuid NewStackId = !Contains(Id) ? Id : FGuid();
+	while (RemainingQuantity > 0)
+	{
+		if (!NewStackId.IsValid()) NewStackId = UInventoryItemHandleAllocator::AllocateItemId();
+		const int32 StackQuantity = FMath::Min(RemainingQuantity, MaxStackSize);
+		if (!AddStack(FInventoryItemInstance(NewStackId, SortOrder, DefinitionId, StackQuantity))) break;
+		
+		StackId = NewStackId;
+		NewStackId = FGuid();
+		RemainingQuantity -= StackQuantity;
+	}
+	
+	return StackId;
+}
+
+
+void FInventoryItemStore::Reserve(const int32 Number)
+{
+	Items.Reserve(Number);
+	SlotLookup.Reserve(Number);
+	SlotSections.Reserve(Number);
+}
+
+
+void FInventoryItemStore::Empty()
+{
+	Items.Empty();
+	SlotLookup.Empty();
+	SlotSections.Empty();
+	for (TArray<int32>& Section : Sections) Section.Empty();
+	DefinitionSlots.Empty();
+	MarkArrayDirty();
+}
+
+
+const F_Item* FInventoryItemStore::GetDefinition(const int32 DefinitionId)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	return Catalog ? Catalog->GetDefinition(DefinitionId) : nullptr;
+}
+
+
+int32 FInventoryItemStore::GetSectionIndex(const EItemType Type)
+{
+	if (EItemType::Inv_Custom == Type || EItemType::Inv_None == Type || EItemType::Inv_MAX == Type)
+	{
+		// TODO: Custom item logic here (map enums to int values)
+		return static_cast<int32>(EItemType::Inv_Item);
+	}
+
+	return static_cast<int32>(Type);
+}
+
+
+
+
+#pragma region Replication
+void FInventoryItemStore::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+	for (const int32 Index : RemovedIndices)
+	{
+		if (Items.IsValidIndex(Index)) ReplicatedRemovals.Add(Items[Index]);
+	}
+}
+
+
+void FInventoryItemStore::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+	for (const int32 Index : AddedIndices)
+	{
+		if (Items.IsValidIndex(Index)) ReplicatedAdditions.Add(Items[Index]);
+	}
+}
+
+
+void FInventoryItemStore::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+	for (const int32 Index : ChangedIndices)
+	{
+		if (Items.IsValidIndex(Index)) ReplicatedChanges.Add(Items[Index]);
+	}
+}
+
+
+void FInventoryItemStore::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	// Items are only moved around when they're added or removed, and the sections need to be rebuilt if an item's definition changes. Anything else is just a quantity or sort order
+	if (!ReplicatedAdditions.IsEmpty() || !ReplicatedRemovals.IsEmpty() || !UpdateChangedItems())
+	{
+		RebuildLookup();
+	}
+
+	// Let the inventory know about the changes once the lookups are valid
+	if (Listener)
+	{
+		for (const FInventoryItemInstance& Item : ReplicatedRemovals) Listener->OnInventoryItemRemoved(Item);
+		for (const FInventoryItemInstance& Item : ReplicatedAdditions) Listener->OnInventoryItemAdded(Item);
+		for (const FInventoryItemInstance& Item : ReplicatedChanges) Listener->OnInventoryItemChanged(Item);
+	}
+
+	ReplicatedRemovals.Reset();
+	ReplicatedAdditions.Reset();
+	ReplicatedChanges.Reset();
+}
+
+
+bool FInventoryItemStore::UpdateChangedItems()
+{
+	TArray<int32, TInlineAllocator<8>> ChangedDefinitions;
+	for (const FInventoryItemInstance& Item : ReplicatedChanges)
+	{
+		// The slot has to still be the same item, in the slot list of the same definition
+		const int32* Slot = SlotLookup.Find(Item.Id);
+		if (!Slot || !Items.IsValidIndex(*Slot) || Items[*Slot].Id != Item.Id) return false;
+
+		const FInventoryDefinitionSlots* Definition = DefinitionSlots.Find(Items[*Slot].DefinitionId);
+		const int32 Position = SlotSections[*Slot].DefinitionPosition;
+		if (!Definition || !Definition->Slots.IsValidIndex(Position) || Definition->Slots[Position] != *Slot) return false;
+
+		ChangedDefinitions.AddUnique(Items[*Slot].DefinitionId);
+	}
+
+	// The previous quantities have already been replaced, so the totals are counted again from each definition's stacks
+	for (const int32 DefinitionId : ChangedDefinitions)
+	{
+		FInventoryDefinitionSlots& Definition = DefinitionSlots.FindChecked(DefinitionId);
+		Definition.Quantity = 0;
+		for (const int32 Slot : Definition.Slots) Definition.Quantity += Items[Slot].Quantity;
+	}
+
+	return true;
+}
+
+
+void FInventoryItemStore::RebuildLookup()
+{
+	SlotLookup.Reset();
+	SlotLookup.Reserve(Items.Num());
+	SlotSections.SetNumUninitialized(Items.Num(), false);
+	for (TArray<int32>& Section : Sections) Section.Reset();
+	for (TPair<int32, FInventoryDefinitionSlots>& Definition : DefinitionSlots)
+	{
+		Definition.Value.Slots.Reset();
+		Definition.Value.Quantity = 0;
+	}
+
+	for (int32 Slot = 0; Slot < Items.Num(); Slot++)
+	{
+		const F_Item* Definition = GetDefinition(Items[Slot].DefinitionId);
+		AddToLookup(Slot, GetSectionIndex(Definition ? Definition->ItemType : EItemType::Inv_None));
+	}
+}
+
+
+void FInventoryItemStore::AddToLookup(const int32 Slot, const int32 Section)
+{
+	SlotLookup.Add(Items[Slot].Id, Slot);
+	SlotSections[Slot].Section = Section;
+	SlotSections[Slot].Position = Sections[Section].Add(Slot);
+	AddToDefinition(Slot);
+}
+
+
+void FInventoryItemStore::AddToDefinition(const int32 Slot)
+{
+	FInventoryDefinitionSlots& Definition = DefinitionSlots.FindOrAdd(Items[Slot].DefinitionId);
+	SlotSections[Slot].DefinitionPosition = Definition.Slots.Add(Slot);
+	Definition.Quantity += Items[Slot].Quantity;
+}
+
+
+void FInventoryItemStore::RemoveFromDefinition(const int32 Slot)
+{
+	FInventoryDefinitionSlots* Definition = DefinitionSlots.Find(Items[Slot].DefinitionId);
+	if (!Definition) return;
+
+	const int32 Position = SlotSections[Slot].DefinitionPosition;
+	Definition->Slots.RemoveAtSwap(Position, 1, false);
+	Definition->Quantity -= Items[Slot].Quantity;
+	if (Definition->Slots.IsValidIndex(Position)) SlotSections[Definition->Slots[Position]].DefinitionPosition = Position;
+}
+#pragma endregion
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventoryNativeEvents.h"
+
+#include "Inventory/InventoryInterface.h"
+#include "Misc/ScopeLock.h"
+
+TMap<TObjectKey<UClass>, EInventoryNativeEvent> FInventoryNativeEvents::OverriddenEvents;
+FCriticalSection FInventoryNativeEvents::OverriddenEventsLock;
+
+
+EInventoryNativeEvent FInventoryNativeEvents::GetOverriddenEvents(const UClass* Class)
+{
+	if (!Class) return EInventoryNativeEvent::None;
+
+	FScopeLock Lock(&OverriddenEventsLock);
+	if (const EInventoryNativeEvent* Events = OverriddenEvents.Find(TObjectKey<UClass>(Class))) return *Events;
+
+#if WITH_EDITOR
+	// Recompiling a blueprint reuses it's class, so the events are found again once the blueprint's objects have been replaced
+	static bool bResetOnReinstance = false;
+	if (!bResetOnReinstance)
+	{
+		FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { ResetOverriddenEvents(); });
+		bResetOnReinstance = true;
+	}
+#endif
+
+	EInventoryNativeEvent Events = EInventoryNativeEvent::None;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, GetItem))) Events |= EInventoryNativeEvent::GetItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, InternalGetInventoryItem))) Events |= EInventoryNativeEvent::InternalGetInventoryItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, InternalAddInventoryItem))) Events |= EInventoryNativeEvent::InternalAddInventoryItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, InternalRemoveInventoryItem))) Events |= EInventoryNativeEvent::InternalRemoveInventoryItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, GetDataBaseItem))) Events |= EInventoryNativeEvent::GetDataBaseItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, HandleAddItem))) Events |= EInventoryNativeEvent::HandleAddItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, HandleTransferItem))) Events |= EInventoryNativeEvent::HandleTransferItem;
+	if (IsOverridden(Class, GET_FUNCTION_NAME_CHECKED(IInventoryInterface, HandleRemoveItem))) Events |= EInventoryNativeEvent::HandleRemoveItem;
+
+	OverriddenEvents.Add(TObjectKey<UClass>(Class), Events);
+	return Events;
+}
+
+
+void FInventoryNativeEvents::ResetOverriddenEvents()
+{
+	FScopeLock Lock(&OverriddenEventsLock);
+	OverriddenEvents.Reset();
+}
+
+
+bool FInventoryNativeEvents::IsOverridden(const UClass* Class, const FName FunctionName)
+{
+	// Native classes use the interface's function (which calls the native implementation), blueprints that override an event have their own script function
+	const UFunction* Function = Class->FindFunctionByName(FunctionName);
+	return Function && !Function->HasAnyFunctionFlags(FUNC_Native);
+}
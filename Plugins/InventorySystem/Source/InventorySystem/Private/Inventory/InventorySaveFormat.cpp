@@ -0,0 +1,313 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventorySaveFormat.h"
+
+#include "Item/InventoryItemHandle.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+bool FInventorySaveFormat::Write(const F_InventorySaveInformation& SaveInformation, TArray<uint8>& OutData, const FInventorySaveFormatOptions& Options)
+{
+	const TArray<FS_Item>& Items = SaveInformation.InventoryItems;
+	const bool bHasItemDefIds = Options.ItemDefIds.Num() == Items.Num();
+
+	// Each kind of item is only saved once, and the items just save it's index
+	TMap<FName, int32> NameIndices;
+	TArray<FName> Names;
+	TArray<int32> NameItemDefIds;
+	TArray<int32> ItemNameIndices;
+	ItemNameIndices.Reserve(Items.Num());
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		int32 NameIndex;
+		if (const int32* ExistingIndex = NameIndices.Find(Items[i].ItemName))
+		{
+			NameIndex = *ExistingIndex;
+		}
+		else
+		{
+			NameIndex = Names.Add(Items[i].ItemName);
+			NameItemDefIds.Add(bHasItemDefIds ? Options.ItemDefIds[i] : INDEX_NONE);
+			NameIndices.Add(Items[i].ItemName, NameIndex);
+		}
+
+		ItemNameIndices.Add(NameIndex);
+	}
+
+	// Encode the information
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+	int32 NetId = SaveInformation.NetId;
+	FString PlatformId = SaveInformation.PlatformId;
+	int32 SaveVersion = SaveInformation.SaveVersion;
+	Writer << NetId << PlatformId << SaveVersion;
+
+	uint32 NumNames = Names.Num();
+	Writer.SerializeIntPacked(NumNames);
+	for (int32 i = 0; i < Names.Num(); i++)
+	{
+		uint32 ItemDefId = static_cast<uint32>(NameItemDefIds[i] + 1);
+		FString Name = Names[i].ToString();
+		Writer.SerializeIntPacked(ItemDefId);
+		Writer << Name;
+	}
+
+	// Items are saved with their handle, the ids that didn't come from a handle are saved after the records (in the same order as their items)
+	TArray<FInventoryItemRecord> Records;
+	TArray<FGuid> LegacyIds;
+	Records.Reserve(Items.Num());
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		FInventoryItemHandle Handle;
+		if (!FInventoryItemHandle::FromGuid(Items[i].Id, Handle))
+		{
+			Handle = FInventoryItemHandle();
+			LegacyIds.Add(Items[i].Id);
+		}
+
+		Records.Add(FInventoryItemRecord(Handle.GetValue(), ItemNameIndices[i], Items[i].SortOrder, Items[i].Quantity));
+	}
+	FInventoryItemRecord::SerializeArray(Writer, Records);
+
+	uint32 NumLegacyIds = LegacyIds.Num();
+	Writer.SerializeIntPacked(NumLegacyIds);
+	for (FGuid& Id : LegacyIds) Writer << Id;
+
+	if (Writer.IsError() || Payload.Num() > MaxPayloadSize) return false;
+
+	// Split the information into blocks, and only keep the compressed blocks that are smaller
+	TArray<uint8> Body;
+	TArray<uint8> CompressedBlock;
+	FMemoryWriter BodyWriter(Body);
+	int32 NumBlocks = 0;
+	for (int32 Offset = 0; Offset < Payload.Num(); Offset += BlockSize, NumBlocks++)
+	{
+		const int32 UncompressedSize = FMath::Min(BlockSize, Payload.Num() - Offset);
+		const uint8* BlockData = Payload.GetData() + Offset;
+		int32 StoredSize = UncompressedSize;
+		if (Options.bCompress)
+		{
+			int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, UncompressedSize);
+			CompressedBlock.SetNumUninitialized(CompressedSize, false);
+			if (FCompression::CompressMemory(NAME_Zlib, CompressedBlock.GetData(), CompressedSize, BlockData, UncompressedSize) && CompressedSize < UncompressedSize)
+			{
+				BlockData = CompressedBlock.GetData();
+				StoredSize = CompressedSize;
+			}
+		}
+
+		uint32 PackedUncompressedSize = UncompressedSize;
+		uint32 PackedStoredSize = StoredSize;
+		BodyWriter.SerializeIntPacked(PackedUncompressedSize);
+		BodyWriter.SerializeIntPacked(PackedStoredSize);
+		BodyWriter.Serialize(const_cast<uint8*>(BlockData), StoredSize);
+	}
+
+	// Add the header
+	uint32 FileMagic = Magic;
+	uint16 Version = Version_Latest;
+	uint16 Flags = Options.bCompress ? Flag_Compressed : 0;
+	uint32 CatalogHash = bHasItemDefIds ? Options.CatalogHash : 0;
+	int32 PayloadSize = Payload.Num();
+	uint32 Checksum = FCrc::MemCrc32(Body.GetData(), Body.Num());
+
+	OutData.Reset(HeaderSize + Body.Num());
+	FMemoryWriter HeaderWriter(OutData);
+	HeaderWriter << FileMagic << Version << Flags << CatalogHash << PayloadSize << NumBlocks << Checksum;
+	OutData.Append(Body);
+	return !BodyWriter.IsError() && !HeaderWriter.IsError();
+}
+
+
+bool FInventorySaveFormat::Read(const TConstArrayView<uint8> Data, F_InventorySaveInformation& OutSaveInformation, const uint32 CatalogHash, TArray<int32>* OutItemDefIds)
+{
+	if (!IsSaveFormat(Data)) return false;
+
+	FMemoryReaderView HeaderReader(Data);
+	uint32 FileMagic = 0;
+	uint16 Version = 0;
+	uint16 Flags = 0;
+	uint32 SavedCatalogHash = 0;
+	int32 PayloadSize = 0;
+	int32 NumBlocks = 0;
+	uint32 Checksum = 0;
+	HeaderReader << FileMagic << Version << Flags << SavedCatalogHash << PayloadSize << NumBlocks << Checksum;
+	if (HeaderReader.IsError() || Version < Version_Initial || Version > Version_Latest) return false;
+	if (PayloadSize < 0 || PayloadSize > MaxPayloadSize || NumBlocks < 0) return false;
+
+	// Don't load anything that's been corrupted
+	const TConstArrayView<uint8> Body = Data.RightChop(HeaderSize);
+	if (FCrc::MemCrc32(Body.GetData(), Body.Num()) != Checksum) return false;
+
+	// Decompress the blocks
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(PayloadSize);
+	FMemoryReaderView BodyReader(Body);
+	int32 Offset = 0;
+	for (int32 Block = 0; Block < NumBlocks; Block++)
+	{
+		uint32 UncompressedSize = 0;
+		uint32 StoredSize = 0;
+		BodyReader.SerializeIntPacked(UncompressedSize);
+		BodyReader.SerializeIntPacked(StoredSize);
+		if (BodyReader.IsError() || UncompressedSize > static_cast<uint32>(BlockSize) || UncompressedSize > static_cast<uint32>(PayloadSize - Offset)) return false;
+		if (StoredSize > static_cast<uint32>(BodyReader.TotalSize() - BodyReader.Tell())) return false;
+
+		const uint8* StoredData = Body.GetData() + BodyReader.Tell();
+		if (StoredSize == UncompressedSize)
+		{
+			FMemory::Memcpy(Payload.GetData() + Offset, StoredData, StoredSize);
+		}
+		else if (!(Flags & Flag_Compressed) || !FCompression::UncompressMemory(NAME_Zlib, Payload.GetData() + Offset, UncompressedSize, StoredData, StoredSize))
+		{
+			return false;
+		}
+
+		BodyReader.Seek(BodyReader.Tell() + StoredSize);
+		Offset += UncompressedSize;
+	}
+	if (Offset != PayloadSize) return false;
+
+	// Decode the information
+	FMemoryReader Reader(Payload);
+	F_InventorySaveInformation SaveInformation;
+	Reader << SaveInformation.NetId << SaveInformation.PlatformId << SaveInformation.SaveVersion;
+
+	uint32 NumNames = 0;
+	Reader.SerializeIntPacked(NumNames);
+	if (Reader.IsError() || NumNames > static_cast<uint32>(PayloadSize)) return false;
+
+	TArray<FName> Names;
+	TArray<int32> NameItemDefIds;
+	Names.Reserve(NumNames);
+	NameItemDefIds.Reserve(NumNames);
+	for (uint32 i = 0; i < NumNames; i++)
+	{
+		uint32 ItemDefId = 0;
+		FString Name;
+		Reader.SerializeIntPacked(ItemDefId);
+		Reader << Name;
+		Names.Add(FName(*Name));
+		NameItemDefIds.Add(static_cast<int32>(ItemDefId) - 1);
+	}
+
+	// The ItemDefIds are only valid if the catalog hasn't changed since the information was saved
+	const bool bUseItemDefIds = OutItemDefIds && CatalogHash != 0 && CatalogHash == SavedCatalogHash;
+	TArray<int32> ItemDefIds;
+	if (Version >= Version_ItemRecords)
+	{
+		TArray<FInventoryItemRecord> Records;
+		TArray<FGuid> RecordIds;
+		if (Version >= Version_PackedRecordIds)
+		{
+			if (!FInventoryItemRecord::SerializeArray(Reader, Records)) return false;
+
+			uint32 NumLegacyIds = 0;
+			Reader.SerializeIntPacked(NumLegacyIds);
+			if (Reader.IsError() || NumLegacyIds > static_cast<uint32>(Records.Num())) return false;
+
+			int32 LegacyIndex = 0;
+			TArray<FGuid> LegacyIds;
+			LegacyIds.SetNum(NumLegacyIds);
+			for (FGuid& Id : LegacyIds) Reader << Id;
+
+			RecordIds.Reserve(Records.Num());
+			for (const FInventoryItemRecord& Record : Records)
+			{
+				if (Record.HasHandle()) RecordIds.Add(FInventoryItemHandle(Record.GetHandle()).ToGuid());
+				else if (LegacyIds.IsValidIndex(LegacyIndex)) RecordIds.Add(LegacyIds[LegacyIndex++]);
+				else return false;
+			}
+		}
+		else
+		{
+			// Records from before they saved handles had the item's guid, and the first ones didn't have a quantity
+			uint32 NumRecords = 0;
+			Reader.SerializeIntPacked(NumRecords);
+			const int32 RecordSize = sizeof(FGuid) + (Version >= Version_ItemStacks ? 3 : 2) * sizeof(int32);
+			if (Reader.IsError() || static_cast<int64>(NumRecords) * RecordSize > Reader.TotalSize() - Reader.Tell()) return false;
+
+			Records.SetNum(NumRecords);
+			RecordIds.SetNum(NumRecords);
+			for (int32 i = 0; i < Records.Num(); i++)
+			{
+				Reader << RecordIds[i] << Records[i].DefinitionIndex << Records[i].SortOrder;
+				if (Version >= Version_ItemStacks) Reader << Records[i].Quantity;
+			}
+			if (Reader.IsError()) return false;
+		}
+
+		if (bUseItemDefIds) ItemDefIds.Reserve(Records.Num());
+		SaveInformation.InventoryItems.Reserve(Records.Num());
+		for (int32 i = 0; i < Records.Num(); i++)
+		{
+			const FInventoryItemRecord& Record = Records[i];
+			if (!Names.IsValidIndex(Record.DefinitionIndex)) return false;
+			SaveInformation.InventoryItems.Add(FS_Item(RecordIds[i], Names[Record.DefinitionIndex], Record.SortOrder, FMath::Max(Record.Quantity, 1)));
+			if (bUseItemDefIds) ItemDefIds.Add(NameItemDefIds[Record.DefinitionIndex]);
+		}
+
+		OutSaveInformation = MoveTemp(SaveInformation);
+		if (OutItemDefIds) *OutItemDefIds = MoveTemp(ItemDefIds);
+		return true;
+	}
+
+	// Older versions saved each item separately
+	uint32 NumItems = 0;
+	Reader.SerializeIntPacked(NumItems);
+	const int32 MinItemSize = Version >= Version_ItemHandles ? sizeof(uint64) : sizeof(FGuid);
+	if (Reader.IsError() || NumItems > static_cast<uint32>(PayloadSize / MinItemSize)) return false;
+
+	if (bUseItemDefIds) ItemDefIds.Reserve(NumItems);
+	SaveInformation.InventoryItems.Reserve(NumItems);
+	for (uint32 i = 0; i < NumItems; i++)
+	{
+		FGuid Id;
+		uint32 NameIndex = 0;
+		uint32 SortOrder = 0;
+		if (Version >= Version_ItemHandles)
+		{
+			Reader.SerializeIntPacked(NameIndex);
+			if (NameIndex & 1)
+			{
+				uint64 HandleValue = 0;
+				Reader << HandleValue;
+				Id = FInventoryItemHandle(HandleValue).ToGuid();
+			}
+			else
+			{
+				Reader << Id;
+			}
+			NameIndex >>= 1;
+		}
+		else
+		{
+			Reader << Id;
+			Reader.SerializeIntPacked(NameIndex);
+		}
+		Reader.SerializeIntPacked(SortOrder);
+		if (Reader.IsError() || NameIndex >= NumNames) return false;
+
+		SaveInformation.InventoryItems.Add(FS_Item(Id, Names[NameIndex], static_cast<int32>(SortOrder) - 1));
+		if (bUseItemDefIds) ItemDefIds.Add(NameItemDefIds[NameIndex]);
+	}
+
+	OutSaveInformation = MoveTemp(SaveInformation);
+	if (OutItemDefIds) *OutItemDefIds = MoveTemp(ItemDefIds);
+	return true;
+}
+
+
+bool FInventorySaveFormat::IsSaveFormat(const TConstArrayView<uint8> Data)
+{
+	if (Data.Num() < HeaderSize) return false;
+
+	uint32 FileMagic = 0;
+	FMemoryReaderView Reader(Data);
+	Reader << FileMagic;
+	return Magic == FileMagic;
+}
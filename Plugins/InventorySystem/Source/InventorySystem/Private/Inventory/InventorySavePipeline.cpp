@@ -0,0 +1,296 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventorySavePipeline.h"
+
+#include "InventorySystemSettings.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Async/Async.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/InventorySaveFormat.h"
+#include "Inventory/InventorySaveGameObject.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Kismet/GameplayStatics.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+
+
+namespace InventorySavePipeline
+{
+	/** Identifies legacy save games that were compressed before they were written ("INVZ"), followed by the uncompressed size */
+	constexpr uint32 CompressedSaveTag = 0x5A564E49;
+	constexpr int32 CompressedHeaderSize = sizeof(uint32) + sizeof(int32);
+
+	/** Roughly how much memory each saved item uses while it's being written (the captured item, it's encoded information, and the compressed data) */
+	constexpr int64 MemoryPerSavedItem = 128;
+
+	/** Decompresses a legacy save game if it was compressed. Save games that weren't compressed are left as they are. Safe to call on any thread */
+	bool DecompressLegacySaveData(TArray<uint8>& Data)
+	{
+		if (Data.Num() < CompressedHeaderSize) return true;
+
+		FMemoryReader Reader(Data);
+		uint32 Tag = 0;
+		int32 UncompressedSize = 0;
+		Reader << Tag << UncompressedSize;
+		if (CompressedSaveTag != Tag) return true;
+		if (UncompressedSize < 0) return false;
+
+		TArray<uint8> UncompressedData;
+		UncompressedData.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, UncompressedData.GetData(), UncompressedSize, Data.GetData() + CompressedHeaderSize, Data.Num() - CompressedHeaderSize)) return false;
+
+		Data = MoveTemp(UncompressedData);
+		return true;
+	}
+}
+
+
+
+
+void UInventorySavePipeline::Deinitialize()
+{
+	// Don't lose anyone's save information when the game shuts down
+	FlushSaves();
+	Super::Deinitialize();
+}
+
+
+bool UInventorySavePipeline::SaveInventory(UInventoryComponent* Inventory, const FString& SlotName, const int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted, const bool bForce)
+{
+	if (!Inventory || SlotName.IsEmpty()) return false;
+	if (!bForce && !Inventory->HasUnsavedChanges())
+	{
+		OnCompleted.ExecuteIfBound(SlotName, true);
+		return true;
+	}
+
+	// Capture every item. Clients can't save their inventory, and won't return a snapshot
+	F_InventorySaveDelta Snapshot = Inventory->GetInventorySaveDelta(true);
+	if (!Snapshot.bFullSnapshot) return false;
+
+	F_InventorySaveInformation SaveInformation(Snapshot.NetId, Snapshot.PlatformId, MoveTemp(Snapshot.InventoryItems));
+	SaveInformation.SaveVersion = Snapshot.Version;
+
+	FInventorySaveRequest Request = CreateSaveRequest(MoveTemp(SaveInformation), SlotName, UserIndex, OnCompleted);
+	Request.Inventory = Inventory;
+	QueueSave(MoveTemp(Request));
+	return true;
+}
+
+
+bool UInventorySavePipeline::SaveInventoryInformation(const F_InventorySaveInformation& SaveInformation, const FString& SlotName, const int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted)
+{
+	if (SlotName.IsEmpty()) return false;
+
+	F_InventorySaveInformation CapturedInformation = SaveInformation;
+	QueueSave(CreateSaveRequest(MoveTemp(CapturedInformation), SlotName, UserIndex, OnCompleted));
+	return true;
+}
+
+
+void UInventorySavePipeline::LoadInventoryInformation(const FString& SlotName, const int32 UserIndex, const FOnInventoryLoadCompletedDelegate& OnCompleted)
+{
+	// The newest information for the slot is the save that's waiting or being written
+	const FString SlotKey = GetSlotKey(SlotName, UserIndex);
+	const FInventorySaveRequest* Save = PendingSaves.Find(SlotKey);
+	if (!Save) Save = InFlightSaves.Find(SlotKey);
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const uint32 CatalogHash = Catalog ? Catalog->GetCatalogHash() : 0;
+	if (Save && Save->SaveInformation)
+	{
+		F_InventorySaveInformation SaveInformation = *Save->SaveInformation;
+		if (CatalogHash != 0 && Save->CatalogHash == CatalogHash) SaveInformation.ItemDefIds = Save->ItemDefIds;
+		OnCompleted.ExecuteIfBound(SlotName, SaveInformation, true);
+		return;
+	}
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!SaveSystem || SlotName.IsEmpty())
+	{
+		OnCompleted.ExecuteIfBound(SlotName, F_InventorySaveInformation(), false);
+		return;
+	}
+
+	// The catalog's hash is retrieved here, the ItemDefIds are only read if it's the same as when the information was saved
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [SaveSystem, SlotName, UserIndex, CatalogHash, OnCompleted]()
+	{
+		TArray<uint8> Data;
+		bool bLoaded = SaveSystem->LoadGame(false, *SlotName, UserIndex, Data);
+		if (bLoaded && FInventorySaveFormat::IsSaveFormat(Data))
+		{
+			F_InventorySaveInformation SaveInformation;
+			bLoaded = FInventorySaveFormat::Read(Data, SaveInformation, CatalogHash, &SaveInformation.ItemDefIds);
+			AsyncTask(ENamedThreads::GameThread, [SlotName, OnCompleted, bLoaded, SaveInformation = MoveTemp(SaveInformation)]()
+			{
+				OnCompleted.ExecuteIfBound(SlotName, SaveInformation, bLoaded);
+			});
+			return;
+		}
+
+		// Legacy save games are UInventorySaveGameObjects, which can only be created on the game thread
+		bLoaded = bLoaded && InventorySavePipeline::DecompressLegacySaveData(Data);
+		AsyncTask(ENamedThreads::GameThread, [SlotName, OnCompleted, bLoaded, Data = MoveTemp(Data)]()
+		{
+			const UInventorySaveGameObject* SaveObject = bLoaded ? Cast<UInventorySaveGameObject>(UGameplayStatics::LoadGameFromMemory(Data)) : nullptr;
+			OnCompleted.ExecuteIfBound(SlotName, SaveObject ? SaveObject->InventorySaveInformation : F_InventorySaveInformation(), SaveObject != nullptr);
+		});
+	});
+}
+
+
+void UInventorySavePipeline::FlushSaves()
+{
+	while (IsSaving())
+	{
+		StartPendingSaves(true);
+
+		// Wait for the saves here instead of on the game thread. The completions that are sent to the game thread afterwards are ignored
+		TArray<TPair<FString, int32>> Saves;
+		for (const TPair<FString, FInventorySaveRequest>& Save : InFlightSaves) Saves.Emplace(Save.Key, Save.Value.RequestId);
+		for (const TPair<FString, int32>& Save : Saves)
+		{
+			const FInventorySaveRequest* Request = InFlightSaves.Find(Save.Key);
+			if (Request && Request->RequestId == Save.Value) OnSaveCompleted(Save.Key, Save.Value, Request->Task.GetResult());
+		}
+	}
+}
+
+
+FInventorySaveRequest UInventorySavePipeline::CreateSaveRequest(F_InventorySaveInformation&& SaveInformation, const FString& SlotName, const int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted)
+{
+	FInventorySaveRequest Request;
+	Request.SlotName = SlotName;
+	Request.UserIndex = UserIndex;
+	Request.EstimatedSize = SaveInformation.InventoryItems.Num() * InventorySavePipeline::MemoryPerSavedItem;
+	if (OnCompleted.IsBound()) Request.Callbacks.Add(OnCompleted);
+
+	// Save the ItemDefIds while the catalog can be used
+	if (const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get())
+	{
+		TArray<FName> DatabaseIds;
+		DatabaseIds.Reserve(SaveInformation.InventoryItems.Num());
+		for (const FS_Item& Item : SaveInformation.InventoryItems) DatabaseIds.Add(Item.ItemName);
+		Catalog->ResolveItemDefIds(DatabaseIds, Request.ItemDefIds);
+		Request.CatalogHash = Catalog->GetCatalogHash();
+	}
+
+	Request.SaveInformation = MakeShared<F_InventorySaveInformation, ESPMode::ThreadSafe>(MoveTemp(SaveInformation));
+	return Request;
+}
+
+
+void UInventorySavePipeline::QueueSave(FInventorySaveRequest&& Request)
+{
+	const FString SlotKey = GetSlotKey(Request.SlotName, Request.UserIndex);
+	if (FInventorySaveRequest* PendingSave = PendingSaves.Find(SlotKey))
+	{
+		// Replace the waiting save with the newer information. If it was a different inventory, it needs to save everything next time
+		if (PendingSave->Inventory.IsValid() && PendingSave->Inventory != Request.Inventory) PendingSave->Inventory->MarkInventorySaveDirty();
+		Request.Callbacks.Insert(PendingSave->Callbacks, 0);
+		*PendingSave = MoveTemp(Request);
+	}
+	else
+	{
+		PendingSaves.Add(SlotKey, MoveTemp(Request));
+		PendingOrder.Add(SlotKey);
+	}
+
+	StartPendingSaves();
+}
+
+
+void UInventorySavePipeline::StartPendingSaves(const bool bIgnoreLimits)
+{
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	const int64 MaxMemory = static_cast<int64>(Settings->MaxSaveMemoryInFlight) * 1024 * 1024;
+
+	for (int32 i = 0; i < PendingOrder.Num();)
+	{
+		// Only one save is written to a slot at a time, so the saves are written in order
+		const FString SlotKey = PendingOrder[i];
+		if (InFlightSaves.Contains(SlotKey))
+		{
+			i++;
+			continue;
+		}
+
+		// There's always at least one save being written, regardless of it's size
+		FInventorySaveRequest& Request = PendingSaves[SlotKey];
+		if (!bIgnoreLimits && !InFlightSaves.IsEmpty())
+		{
+			if (InFlightSaves.Num() >= Settings->MaxConcurrentSaves || InFlightMemory + Request.EstimatedSize > MaxMemory) return;
+		}
+
+		FInventorySaveRequest StartedRequest = MoveTemp(Request);
+		PendingSaves.Remove(SlotKey);
+		PendingOrder.RemoveAt(i);
+		StartSave(SlotKey, MoveTemp(StartedRequest));
+	}
+}
+
+
+void UInventorySavePipeline::StartSave(const FString& SlotKey, FInventorySaveRequest&& Request)
+{
+	Request.RequestId = ++LastRequestId;
+	InFlightMemory += Request.EstimatedSize;
+
+	// The save information isn't edited once it's been captured, and it's shared with the task until the save has completed
+	TSharedPtr<const F_InventorySaveInformation, ESPMode::ThreadSafe> SaveInformation = Request.SaveInformation;
+	FInventorySaveFormatOptions Options;
+	Options.bCompress = GetDefault<UInventorySystemSettings>()->bCompressSaveGames;
+	Options.CatalogHash = Request.CatalogHash;
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	const FString SlotName = Request.SlotName;
+	const int32 UserIndex = Request.UserIndex;
+	const int32 RequestId = Request.RequestId;
+	TWeakObjectPtr<UInventorySavePipeline> WeakThis(this);
+
+	Request.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, SaveSystem, SaveInformation, ItemDefIds = Request.ItemDefIds, Options, SlotKey, SlotName, UserIndex, RequestId]() mutable
+	{
+		TArray<uint8> Data;
+		Options.ItemDefIds = ItemDefIds;
+		bool bSuccess = SaveSystem && SaveInformation && FInventorySaveFormat::Write(*SaveInformation, Data, Options);
+		if (bSuccess) bSuccess = SaveSystem->SaveGame(false, *SlotName, UserIndex, Data);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotKey, RequestId, bSuccess]()
+		{
+			if (UInventorySavePipeline* Pipeline = WeakThis.Get()) Pipeline->OnSaveCompleted(SlotKey, RequestId, bSuccess);
+		});
+
+		return bSuccess;
+	});
+
+	InFlightSaves.Add(SlotKey, MoveTemp(Request));
+}
+
+
+void UInventorySavePipeline::OnSaveCompleted(const FString& SlotKey, const int32 RequestId, const bool bSuccess)
+{
+	FInventorySaveRequest* Request = InFlightSaves.Find(SlotKey);
+	if (!Request || Request->RequestId != RequestId) return;
+
+	const FInventorySaveRequest CompletedRequest = MoveTemp(*Request);
+	InFlightSaves.Remove(SlotKey);
+	InFlightMemory -= CompletedRequest.EstimatedSize;
+
+	// The inventory thinks it's been saved, so the next save needs to be everything
+	if (!bSuccess)
+	{
+		UE_LOGFMT(InventoryLog, Error, "{0}() failed to save the inventory to slot {1} ({2})!", *FString(__FUNCTION__), CompletedRequest.SlotName, CompletedRequest.UserIndex);
+		if (CompletedRequest.Inventory.IsValid()) CompletedRequest.Inventory->MarkInventorySaveDirty();
+	}
+
+	for (const FOnInventorySaveCompletedDelegate& Callback : CompletedRequest.Callbacks) Callback.ExecuteIfBound(CompletedRequest.SlotName, bSuccess);
+	OnInventorySaved.Broadcast(CompletedRequest.SlotName, CompletedRequest.UserIndex, bSuccess);
+
+	StartPendingSaves();
+}
+
+
+FString UInventorySavePipeline::GetSlotKey(const FString& SlotName, const int32 UserIndex)
+{
+	return FString::Printf(TEXT("%s:%d"), *SlotName, UserIndex);
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventorySaveScheduler.h"
+
+#include "InventorySystemSettings.h"
+#include "Inventory/InventoryComponent.h"
+
+
+void FInventorySaveSchedulerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (!Scheduler) return;
+	Scheduler->ProcessPendingInventories();
+
+	// Stop ticking once everything has been added
+	if (Scheduler->IsIdle()) SetTickFunctionEnable(false);
+}
+
+
+
+
+void UInventorySaveScheduler::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The tick is only enabled while there's save information that's waiting to be added
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	TickFunction.Scheduler = this;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = !IsIdle();
+	TickFunction.TickGroup = Settings->SaveApplicationTickGroup;
+	TickFunction.EndTickGroup = Settings->SaveApplicationTickGroup;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+
+void UInventorySaveScheduler::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered()) TickFunction.UnRegisterTickFunction();
+	TickFunction.Scheduler = nullptr;
+	PendingInventories.Empty();
+
+	Super::Deinitialize();
+}
+
+
+void UInventorySaveScheduler::ScheduleSaveApplication(UInventoryComponent* Inventory)
+{
+	if (!Inventory) return;
+	PendingInventories.AddUnique(Inventory);
+
+	// Add what this frame's budget allows right away, and the rest during the save application tick group
+	if (GetDefault<UInventorySystemSettings>()->bApplySaveInformationImmediately) ProcessPendingInventories();
+	if (!IsIdle() && TickFunction.IsTickFunctionRegistered()) TickFunction.SetTickFunctionEnable(true);
+}
+
+
+void UInventorySaveScheduler::ProcessPendingInventories()
+{
+	// Inventories are added in the order they were scheduled, so every player's save information is eventually added
+	while (!PendingInventories.IsEmpty())
+	{
+		const int32 Budget = GetRemainingBudget();
+		if (Budget <= 0) return;
+
+		UInventoryComponent* Inventory = PendingInventories[0].Get();
+		if (Inventory && Inventory->IsApplyingSaveInformation())
+		{
+			RemainingBudget -= Inventory->ApplySaveInformation(Budget);
+			if (Inventory->IsApplyingSaveInformation()) continue;
+		}
+
+		PendingInventories.RemoveAt(0, 1, false);
+	}
+}
+
+
+int32 UInventorySaveScheduler::GetRemainingBudget()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		const int32 SaveItemsPerFrame = GetDefault<UInventorySystemSettings>()->SaveItemsPerFrame;
+		BudgetFrame = GFrameCounter;
+		RemainingBudget = SaveItemsPerFrame > 0 ? SaveItemsPerFrame : MAX_int32;
+	}
+
+	return RemainingBudget;
+}
+
+
+bool UInventorySaveScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
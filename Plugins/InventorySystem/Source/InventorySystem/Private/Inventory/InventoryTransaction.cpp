@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Inventory/InventoryTransaction.h"
+
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/InventoryInterface.h"
+#include "Item/InventoryItemClaims.h"
+#include "Item/InventoryItemHandleAllocator.h"
+#include "Logging/StructuredLog.h"
+
+
+void FInventoryTransaction::AddItem(UObject* Inventory, const FName DatabaseId, const int32 Quantity)
+{
+	FOperation& Operation = Operations.AddDefaulted_GetRef();
+	Operation.To = Inventory;
+	Operation.DatabaseId = DatabaseId;
+	Operation.Quantity = FMath::Max(Quantity, 1);
+}
+
+
+void FInventoryTransaction::RemoveItem(UObject* Inventory, const FGuid& Id, const EItemType Type, const int32 Quantity)
+{
+	FOperation& Operation = Operations.AddDefaulted_GetRef();
+	Operation.From = Inventory;
+	Operation.Id = Id;
+	Operation.Type = Type;
+	Operation.Quantity = FMath::Max(Quantity, 0);
+}
+
+
+void FInventoryTransaction::MoveItem(UObject* From, UObject* To, const FGuid& Id, const EItemType Type, const int32 Quantity)
+{
+	FOperation& Operation = Operations.AddDefaulted_GetRef();
+	Operation.From = From;
+	Operation.To = To;
+	Operation.Id = Id;
+	Operation.Type = Type;
+	Operation.Quantity = FMath::Max(Quantity, 0);
+}
+
+
+bool FInventoryTransaction::Validate()
+{
+	const auto IsInventory = [](const TWeakObjectPtr<UObject>& Inventory) { return Inventory.IsValid() && Inventory->Implements<UInventoryInterface>(); };
+
+	// How much of each stack is left once the changes before it are made
+	TMap<TPair<UObject*, FGuid>, int32> RemainingQuantities;
+
+	bool bValid = true;
+	Results.Reset(Operations.Num());
+	for (FOperation& Operation : Operations)
+	{
+		Operation.Item = F_Item();
+		EInventoryOperationResult Result = EInventoryOperationResult::Result_Succeeded;
+
+		if ((Operation.From.IsExplicitlyNull() && Operation.To.IsExplicitlyNull())
+			|| (!Operation.From.IsExplicitlyNull() && !IsInventory(Operation.From))
+			|| (!Operation.To.IsExplicitlyNull() && !IsInventory(Operation.To)))
+		{
+			Result = EInventoryOperationResult::Result_Invalid;
+		}
+		else if (!Operation.From.IsExplicitlyNull())
+		{
+			// Removing or moving an item, there needs to be enough of the item left in the inventory
+			const F_Item Item = Operation.Id.IsValid() ? UInventoryComponent::Call_InternalGetInventoryItem(Operation.From.Get(), Operation.Id, Operation.Type) : F_Item();
+			int32& Remaining = RemainingQuantities.FindOrAdd(TPair<UObject*, FGuid>(Operation.From.Get(), Operation.Id), Item.IsValid() ? Item.Quantity : 0);
+			const int32 Quantity = Operation.Quantity > 0 ? Operation.Quantity : Remaining;
+
+			if (!Item.IsValid() || Quantity <= 0 || Quantity > Remaining)
+			{
+				Result = EInventoryOperationResult::Result_Failed;
+			}
+			else
+			{
+				Remaining -= Quantity;
+				Operation.Item = Item;
+				Operation.Item.Quantity = Quantity;
+			}
+		}
+		else
+		{
+			// Adding an item from the database
+			F_Item Item;
+			if (Operation.DatabaseId.IsNone() || !UInventoryComponent::Call_GetDataBaseItem(Operation.To.Get(), Operation.DatabaseId, Item) || !Item.IsValid())
+			{
+				Result = EInventoryOperationResult::Result_Failed;
+			}
+			else
+			{
+				Operation.Item = Item;
+				Operation.Item.Quantity = Operation.Quantity;
+			}
+		}
+
+		Results.Add(Result);
+		bValid &= EInventoryOperationResult::Result_Succeeded == Result;
+	}
+
+	return bValid;
+}
+
+
+EInventoryOperationResult FInventoryTransaction::Commit(UObject* Claimant, const bool bNotifyParticipants)
+{
+	const TArray<UObject*> Participants = GetParticipants();
+	if (bCommitted || Participants.IsEmpty()) return EInventoryOperationResult::Result_Invalid;
+
+	// Claim every item that's removed or moved, so nobody else can change them until the transaction is finished. Claims the claimant already had are kept afterwards
+	UInventoryItemClaims* Claims = UInventoryItemClaims::Get(Participants[0]);
+	UObject* ClaimOwner = Claimant ? Claimant : Participants[0];
+	TArray<FGuid> ClaimedIds = GetClaimedIds();
+	TArray<FGuid> HeldIds;
+	if (Claims && !ClaimedIds.IsEmpty())
+	{
+		for (const FGuid& Id : ClaimedIds)
+		{
+			if (Claims->GetClaimant(Id) == ClaimOwner) HeldIds.Add(Id);
+		}
+
+		TArray<EInventoryItemClaimResult> ClaimResults;
+		// Transactions aren't retried, so they don't wait in line for the items
+		if (!Claims->TryClaimAll(ClaimedIds, ClaimOwner, 0.0f, &ClaimResults, false))
+		{
+			Results.Reset(Operations.Num());
+			for (const FOperation& Operation : Operations)
+			{
+				const int32 Index = ClaimedIds.IndexOfByKey(Operation.Id);
+				const bool bLocked = Index != INDEX_NONE && ClaimResults.IsValidIndex(Index) && EInventoryItemClaimResult::Claim_Succeeded != ClaimResults[Index];
+				Results.Add(bLocked ? EInventoryOperationResult::Result_Locked : EInventoryOperationResult::Result_Failed);
+			}
+
+			if (bNotifyParticipants) Notify(EInventoryOperationResult::Result_Locked);
+			return EInventoryOperationResult::Result_Locked;
+		}
+	}
+
+	const bool bValid = Validate();
+	if (bValid)
+	{
+		Apply();
+		bCommitted = true;
+	}
+	else
+	{
+		UE_LOGFMT(InventoryLog, Verbose, "{0}() aborted a transaction with {1} changes across {2} inventories, nothing was changed", *FString(__FUNCTION__), Operations.Num(), Participants.Num());
+	}
+
+	if (Claims)
+	{
+		ClaimedIds.RemoveAll([&HeldIds](const FGuid& Id) { return HeldIds.Contains(Id); });
+		Claims->ReleaseAll(ClaimedIds, ClaimOwner);
+	}
+
+	const EInventoryOperationResult Result = bValid ? EInventoryOperationResult::Result_Succeeded : EInventoryOperationResult::Result_Failed;
+	if (bNotifyParticipants) Notify(Result);
+	return Result;
+}
+
+
+TArray<UObject*> FInventoryTransaction::GetParticipants() const
+{
+	TArray<UObject*> Participants;
+	for (const FOperation& Operation : Operations)
+	{
+		if (Operation.From.IsValid()) Participants.AddUnique(Operation.From.Get());
+		if (Operation.To.IsValid()) Participants.AddUnique(Operation.To.Get());
+	}
+	return Participants;
+}
+
+
+void FInventoryTransaction::Apply()
+{
+	for (FOperation& Operation : Operations)
+	{
+		if (Operation.From.IsExplicitlyNull()) continue;
+		UInventoryComponent::Call_InternalRemoveInventoryItem(Operation.From.Get(), Operation.Id, Operation.Item.ItemType, Operation.Item.Quantity);
+	}
+
+	TSet<FGuid> MovedIds;
+	for (FOperation& Operation : Operations)
+	{
+		if (Operation.To.IsExplicitlyNull()) continue;
+
+		// Moving part of a stack splits it, and the items that are moved are a new stack. If none of the stack is left, the first part that's moved keeps the stack's id
+		if (!Operation.From.IsExplicitlyNull())
+		{
+			bool bAlreadyMoved = false;
+			MovedIds.Add(Operation.Id, &bAlreadyMoved);
+			if (bAlreadyMoved || UInventoryComponent::Call_ContainsItem(Operation.From.Get(), Operation.Id, Operation.Item.ItemType))
+			{
+				Operation.Item.Id = UInventoryItemHandleAllocator::AllocateItemId();
+			}
+		}
+
+		if (UInventoryComponent::Call_InternalAddInventoryItem(Operation.To.Get(), Operation.Item).IsValid() || Operation.From.IsExplicitlyNull()) continue;
+
+		// The item was already removed, put it back so it isn't lost
+		UE_LOGFMT(InventoryLog, Warning, "{0}() {1}({2}) couldn't be added to {3}, it was returned to {4}", *FString(__FUNCTION__), Operation.Item.ItemName, *Operation.Id.ToString(),
+			*GetNameSafe(Operation.To.Get()), *GetNameSafe(Operation.From.Get()));
+		if (!UInventoryComponent::Call_ContainsItem(Operation.From.Get(), Operation.Id, Operation.Item.ItemType)) Operation.Item.Id = Operation.Id;
+		UInventoryComponent::Call_InternalAddInventoryItem(Operation.From.Get(), Operation.Item);
+	}
+}
+
+
+void FInventoryTransaction::Notify(const EInventoryOperationResult Result) const
+{
+	TMap<UInventoryComponent*, F_InventoryTransactionResult> ParticipantResults;
+	const auto GetParticipantResult = [&ParticipantResults, Result](const TWeakObjectPtr<UObject>& Inventory) -> F_InventoryTransactionResult*
+	{
+		UInventoryComponent* InventoryComponent = Cast<UInventoryComponent>(Inventory.Get());
+		if (!InventoryComponent) return nullptr;
+
+		F_InventoryTransactionResult* ParticipantResult = ParticipantResults.Find(InventoryComponent);
+		if (!ParticipantResult) ParticipantResult = &ParticipantResults.Add(InventoryComponent, F_InventoryTransactionResult(Result));
+		return ParticipantResult;
+	};
+
+	// Changes that weren't validated only have what was staged
+	for (const FOperation& Operation : Operations)
+	{
+		const bool bResolved = Operation.Item.IsValid();
+		const FName DatabaseId = bResolved ? Operation.Item.ItemName : Operation.DatabaseId;
+		const EItemType Type = bResolved ? Operation.Item.ItemType : Operation.Type;
+		const int32 Quantity = bResolved ? Operation.Item.Quantity : Operation.Quantity;
+
+		if (F_InventoryTransactionResult* From = GetParticipantResult(Operation.From))
+		{
+			From->RemovedItems.Emplace(Operation.Id, DatabaseId, Type, nullptr, Quantity);
+		}
+		if (F_InventoryTransactionResult* To = GetParticipantResult(Operation.To))
+		{
+			To->AddedItems.Emplace(bResolved ? Operation.Item.Id : Operation.Id, DatabaseId, Type, nullptr, Quantity);
+		}
+	}
+
+	for (const TPair<UInventoryComponent*, F_InventoryTransactionResult>& ParticipantResult : ParticipantResults)
+	{
+		ParticipantResult.Key->Client_TransactionResponse(ParticipantResult.Value);
+	}
+}
+
+
+TArray<FGuid> FInventoryTransaction::GetClaimedIds() const
+{
+	TArray<FGuid> Ids;
+	for (const FOperation& Operation : Operations)
+	{
+		if (!Operation.From.IsExplicitlyNull() && Operation.Id.IsValid()) Ids.AddUnique(Operation.Id);
+	}
+	return Ids;
+}
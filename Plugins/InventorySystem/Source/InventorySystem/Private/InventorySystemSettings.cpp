@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InventorySystemSettings.h"
+
+#include "Engine/DataTable.h"
+
+
+UInventorySystemSettings::UInventorySystemSettings()
+{
+	ItemDatabase = TSoftObjectPtr<UDataTable>(FSoftObjectPath(TEXT("/InventorySystem/DB_InventoryItems.DB_InventoryItems")));
+	bApplySaveInformationImmediately = true;
+	SaveApplicationTickGroup = TG_PostUpdateWork;
+	SaveItemsPerFrame = 1000;
+	bCompressSaveGames = true;
+	MaxConcurrentSaves = 2;
+	MaxSaveMemoryInFlight = 64;
+	ItemHandleServerId = 0;
+	ItemHandleBlockSize = 65536;
+	ItemClaimLeaseDuration = 5.0f;
+	ItemClaimQueueTimeout = 1.0f;
+	MaxResidentItemAssets = 256;
+	bLoadCosmeticAssetsOnServer = false;
+	WorldItemPoolSize = 64;
+	bDropLightweightWorldItems = false;
+	WorldItemRegionSize = 20000.0f;
+	WorldItemRegionCullDistance = 25000.0f;
+	PromotedWorldItemLifetime = 10.0f;
+	WorldItemIndexCellSize = 1000.0f;
+}
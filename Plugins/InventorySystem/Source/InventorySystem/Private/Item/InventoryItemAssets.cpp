@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryItemAssets.h"
+
+#include "InventorySystemSettings.h"
+#include "Engine/Texture2D.h"
+#include "Item/InventoryItemCatalog.h"
+
+UInventoryItemAssets* UInventoryItemAssets::ItemAssets = nullptr;
+
+
+void UInventoryItemAssets::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	MaxResidentAssets = Settings ? FMath::Max(Settings->MaxResidentItemAssets, 1) : 256;
+	bLoadCosmeticAssets = !IsRunningDedicatedServer() || (Settings && Settings->bLoadCosmeticAssetsOnServer);
+	ItemAssets = this;
+}
+
+
+void UInventoryItemAssets::Deinitialize()
+{
+	ReleaseAllAssets();
+	if (ItemAssets == this) ItemAssets = nullptr;
+	Super::Deinitialize();
+}
+
+
+void UInventoryItemAssets::RequestItemAssets(const TConstArrayView<int32> ItemDefIds, const EInventoryItemAssets Assets, FStreamableDelegate OnLoaded)
+{
+	TArray<FSoftObjectPath> Paths;
+	for (const int32 ItemDefId : ItemDefIds)
+	{
+		GetAssetPaths(ItemDefId, Assets, Paths);
+	}
+
+	if (Paths.IsEmpty())
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// Each asset has it's own handle so the least recently used ones can be released individually
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (!FindResidentAsset(Path) && !ResidentSlots.Contains(Path))
+		{
+			AddResidentAsset(Path, StreamableManager.RequestAsyncLoad(Path));
+		}
+	}
+
+	// The streamable manager keeps this handle until it's finished, and it's released once the callback's been called
+	StreamableManager.RequestAsyncLoad(Paths, MoveTemp(OnLoaded));
+	ReleaseUnusedAssets();
+}
+
+
+void UInventoryItemAssets::LoadItemAssets(const TArray<FName>& DatabaseIds, const int32 Assets, const FOnInventoryItemAssetsLoadedDelegate& OnLoaded)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Catalog)
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	TArray<int32> ItemDefIds;
+	Catalog->ResolveItemDefIds(DatabaseIds, ItemDefIds);
+	RequestItemAssets(ItemDefIds, static_cast<EInventoryItemAssets>(Assets), FStreamableDelegate::CreateWeakLambda(this, [OnLoaded]() { OnLoaded.ExecuteIfBound(); }));
+}
+
+
+UTexture2D* UInventoryItemAssets::GetItemIcon(const FName DatabaseId)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const F_Item* Definition = Catalog ? Catalog->FindDefinition(DatabaseId) : nullptr;
+	if (!Definition) return nullptr;
+
+	// Icons that are referenced by something else are already loaded
+	if (UObject* Icon = FindResidentAsset(Definition->Image.ToSoftObjectPath())) return Cast<UTexture2D>(Icon);
+	return Definition->Image.Get();
+}
+
+
+UClass* UInventoryItemAssets::GetItemClass(const FName DatabaseId, const bool bWorldClass)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const F_Item* Definition = Catalog ? Catalog->FindDefinition(DatabaseId) : nullptr;
+	if (!Definition) return nullptr;
+
+	const FSoftObjectPath& Path = bWorldClass ? Definition->WorldClass.ToSoftObjectPath() : Definition->ActualClass.ToSoftObjectPath();
+	if (UObject* Class = FindResidentAsset(Path)) return Cast<UClass>(Class);
+	return Cast<UClass>(Path.ResolveObject());
+}
+
+
+UObject* UInventoryItemAssets::LoadAssetSynchronous(const FSoftObjectPath& Path, const bool bCosmetic)
+{
+	if (Path.IsNull() || (bCosmetic && !bLoadCosmeticAssets)) return nullptr;
+	if (UObject* Asset = FindResidentAsset(Path)) return Asset;
+
+	// The asset might still be loading from a request
+	if (const int32* Slot = ResidentSlots.Find(Path))
+	{
+		const TSharedPtr<FStreamableHandle>& Handle = ResidentAssets[*Slot].Handle;
+		if (Handle.IsValid())
+		{
+			Handle->WaitUntilComplete();
+			return Handle->GetLoadedAsset();
+		}
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestSyncLoad(Path);
+	UObject* Asset = Handle.IsValid() ? Handle->GetLoadedAsset() : nullptr;
+	AddResidentAsset(Path, MoveTemp(Handle));
+	ReleaseUnusedAssets();
+	return Asset;
+}
+
+
+UObject* UInventoryItemAssets::LoadItemAsset(const FSoftObjectPath& Path, const bool bCosmetic)
+{
+	if (ItemAssets) return ItemAssets->LoadAssetSynchronous(Path, bCosmetic);
+	return Path.TryLoad();
+}
+
+
+void UInventoryItemAssets::ReleaseAllAssets()
+{
+	for (FResidentAsset& ResidentAsset : ResidentAssets)
+	{
+		if (ResidentAsset.Handle.IsValid()) ResidentAsset.Handle->ReleaseHandle();
+	}
+
+	ResidentAssets.Empty();
+	FreeSlots.Empty();
+	ResidentSlots.Empty();
+	MostRecentlyUsed = INDEX_NONE;
+	LeastRecentlyUsed = INDEX_NONE;
+}
+
+
+void UInventoryItemAssets::GetAssetPaths(const int32 ItemDefId, const EInventoryItemAssets Assets, TArray<FSoftObjectPath>& OutPaths) const
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const F_Item* Definition = Catalog ? Catalog->GetDefinition(ItemDefId) : nullptr;
+	if (!Definition) return;
+
+	if (EnumHasAnyFlags(Assets, EInventoryItemAssets::Icon) && bLoadCosmeticAssets && !Definition->Image.IsNull()) OutPaths.AddUnique(Definition->Image.ToSoftObjectPath());
+	if (EnumHasAnyFlags(Assets, EInventoryItemAssets::ActualClass) && !Definition->ActualClass.IsNull()) OutPaths.AddUnique(Definition->ActualClass.ToSoftObjectPath());
+	if (EnumHasAnyFlags(Assets, EInventoryItemAssets::WorldClass) && !Definition->WorldClass.IsNull()) OutPaths.AddUnique(Definition->WorldClass.ToSoftObjectPath());
+	if (EnumHasAnyFlags(Assets, EInventoryItemAssets::WorldMesh) && bLoadCosmeticAssets && !Definition->WorldMesh.IsNull()) OutPaths.AddUnique(Definition->WorldMesh.ToSoftObjectPath());
+}
+
+
+UObject* UInventoryItemAssets::FindResidentAsset(const FSoftObjectPath& Path)
+{
+	const int32* Slot = ResidentSlots.Find(Path);
+	if (!Slot) return nullptr;
+
+	LinkMostRecentlyUsed(*Slot);
+	const FResidentAsset& ResidentAsset = ResidentAssets[*Slot];
+	return ResidentAsset.Handle.IsValid() ? ResidentAsset.Handle->GetLoadedAsset() : nullptr;
+}
+
+
+void UInventoryItemAssets::AddResidentAsset(const FSoftObjectPath& Path, TSharedPtr<FStreamableHandle> Handle)
+{
+	if (!Handle.IsValid()) return;
+
+	const int32 Slot = !FreeSlots.IsEmpty() ? FreeSlots.Pop(false) : ResidentAssets.AddDefaulted();
+	FResidentAsset& ResidentAsset = ResidentAssets[Slot];
+	ResidentAsset.Path = Path;
+	ResidentAsset.Handle = MoveTemp(Handle);
+	ResidentSlots.Add(Path, Slot);
+	LinkMostRecentlyUsed(Slot);
+}
+
+
+void UInventoryItemAssets::ReleaseUnusedAssets()
+{
+	// Assets that are still loading are kept, they're part of a request that hasn't finished
+	int32 Slot = LeastRecentlyUsed;
+	while (Slot != INDEX_NONE && ResidentSlots.Num() > MaxResidentAssets)
+	{
+		FResidentAsset& ResidentAsset = ResidentAssets[Slot];
+		const int32 PreviousSlot = ResidentAsset.Previous;
+		if (!ResidentAsset.Handle.IsValid() || !ResidentAsset.Handle->IsLoadingInProgress())
+		{
+			if (ResidentAsset.Handle.IsValid()) ResidentAsset.Handle->ReleaseHandle();
+			Unlink(Slot);
+			ResidentSlots.Remove(ResidentAsset.Path);
+			ResidentAsset = FResidentAsset();
+			FreeSlots.Add(Slot);
+		}
+
+		Slot = PreviousSlot;
+	}
+}
+
+
+void UInventoryItemAssets::LinkMostRecentlyUsed(const int32 Slot)
+{
+	if (Slot == MostRecentlyUsed) return;
+
+	Unlink(Slot);
+	FResidentAsset& ResidentAsset = ResidentAssets[Slot];
+	ResidentAsset.Next = MostRecentlyUsed;
+	if (MostRecentlyUsed != INDEX_NONE) ResidentAssets[MostRecentlyUsed].Previous = Slot;
+	MostRecentlyUsed = Slot;
+	if (LeastRecentlyUsed == INDEX_NONE) LeastRecentlyUsed = Slot;
+}
+
+
+void UInventoryItemAssets::Unlink(const int32 Slot)
+{
+	FResidentAsset& ResidentAsset = ResidentAssets[Slot];
+	if (ResidentAsset.Previous != INDEX_NONE) ResidentAssets[ResidentAsset.Previous].Next = ResidentAsset.Next;
+	else if (MostRecentlyUsed == Slot) MostRecentlyUsed = ResidentAsset.Next;
+	if (ResidentAsset.Next != INDEX_NONE) ResidentAssets[ResidentAsset.Next].Previous = ResidentAsset.Previous;
+	else if (LeastRecentlyUsed == Slot) LeastRecentlyUsed = ResidentAsset.Previous;
+
+	ResidentAsset.Previous = INDEX_NONE;
+	ResidentAsset.Next = INDEX_NONE;
+}
@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryItemCatalog.h"
+
+#include "InventorySystemSettings.h"
+#include "Engine/DataTable.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/InventoryItemStore.h"
+#include "Item/InventoryItemHandleAllocator.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/Crc.h"
+
+UInventoryItemCatalog* UInventoryItemCatalog::Catalog = nullptr;
+
+
+void UInventoryItemCatalog::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Catalog = this;
+
+	// Object references belong in the item definitions, every inventory item referencing them adds to the garbage collector's reference gathering
+	ensureMsgf(!FInventoryItemStore::ItemsHaveObjectReferences(), TEXT("FInventoryItemInstance references objects, add them to the item's definition (F_Item) instead"));
+
+	// Build the catalog from the item database
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings && !Settings->ItemDatabase.IsNull())
+	{
+		RegisterDatabase(Settings->ItemDatabase.LoadSynchronous());
+	}
+}
+
+
+void UInventoryItemCatalog::Deinitialize()
+{
+	for (UDataTable* Database : Databases)
+	{
+		if (Database) Database->OnDataTableChanged().RemoveAll(this);
+	}
+
+	if (Catalog == this) Catalog = nullptr;
+	Super::Deinitialize();
+}
+
+
+void UInventoryItemCatalog::RegisterDatabase(UDataTable* Database)
+{
+	if (!Database || Databases.Contains(Database)) return;
+	if (Database->GetRowStruct() != FInventory_ItemDatabase::StaticStruct())
+	{
+		UE_LOGFMT(InventoryLog, Error, "{0}() {1} isn't an inventory item database!", *FString(__FUNCTION__), *GetNameSafe(Database));
+		return;
+	}
+
+	Databases.Add(Database);
+	AddDatabaseRows(Database);
+
+	// Keep the definitions up to date if the database is edited
+	Database->OnDataTableChanged().AddWeakLambda(this, [this, Database]() { AddDatabaseRows(Database); });
+}
+
+
+void UInventoryItemCatalog::AddDatabaseRows(UDataTable* Database)
+{
+	if (!Database) return;
+
+	const TMap<FName, uint8*>& Rows = Database->GetRowMap();
+	Definitions.Reserve(Definitions.Num() + Rows.Num());
+	DatabaseIds.Reserve(DatabaseIds.Num() + Rows.Num());
+	ItemDefIds.Reserve(ItemDefIds.Num() + Rows.Num());
+	DefinitionHashes.Reserve(DefinitionHashes.Num() + Rows.Num());
+
+	for (const TPair<FName, uint8*>& Row : Rows)
+	{
+		const FInventory_ItemDatabase* ItemData = reinterpret_cast<const FInventory_ItemDatabase*>(Row.Value);
+		if (ItemData) SetDefinition(Row.Key, ItemData->ItemInformation);
+	}
+}
+
+
+int32 UInventoryItemCatalog::AddDefinition(const F_Item& Item)
+{
+	if (Item.ItemName.IsNone()) return INDEX_NONE;
+
+	const int32 ItemDefId = FindItemDefId(Item.ItemName);
+	if (INDEX_NONE != ItemDefId && !IsPendingDefinition(ItemDefId)) return ItemDefId;
+	return SetDefinition(Item.ItemName, Item);
+}
+
+
+int32 UInventoryItemCatalog::FindOrAddPendingItemDefId(const FName DatabaseId)
+{
+	if (DatabaseId.IsNone()) return INDEX_NONE;
+
+	int32 ItemDefId = FindItemDefId(DatabaseId);
+	if (INDEX_NONE != ItemDefId) return ItemDefId;
+
+	F_Item Definition;
+	Definition.ItemName = DatabaseId;
+	ItemDefId = SetDefinition(DatabaseId, Definition);
+	PendingDefinitions.Add(ItemDefId);
+	return ItemDefId;
+}
+
+
+void UInventoryItemCatalog::NetSerializeItemDefId(FArchive& Ar, UPackageMap* Map, int32& ItemDefId)
+{
+	// ItemDefIds the client has in common with the server are sent as they are, everything else is sent as it's database id
+	uint8 bSharedItemDefId = Ar.IsSaving() && Catalog && Catalog->IsSharedItemDefId(Map, ItemDefId);
+	Ar.SerializeBits(&bSharedItemDefId, 1);
+	if (bSharedItemDefId)
+	{
+		uint32 PackedItemDefId = Ar.IsSaving() ? static_cast<uint32>(ItemDefId) : 0;
+		Ar.SerializeIntPacked(PackedItemDefId);
+		if (Ar.IsLoading())
+		{
+			ItemDefId = Catalog && Catalog->Definitions.IsValidIndex(static_cast<int32>(PackedItemDefId)) ? static_cast<int32>(PackedItemDefId) : INDEX_NONE;
+		}
+		return;
+	}
+
+	FName DatabaseId = Ar.IsSaving() && Catalog ? Catalog->GetDatabaseId(ItemDefId) : NAME_None;
+	Ar << DatabaseId;
+
+	if (Ar.IsLoading())
+	{
+		ItemDefId = Catalog ? Catalog->FindOrAddPendingItemDefId(DatabaseId) : INDEX_NONE;
+	}
+}
+
+
+void UInventoryItemCatalog::SetClientCatalog(UNetConnection* Connection, const int32 NumDefinitions, const uint32 ClientCatalogHash)
+{
+	if (!Connection) return;
+
+	// Definitions are only ever added to the end, so both catalogs have the same ItemDefIds up to the definition where their hashes are the same
+	const bool bSharedCatalog = DefinitionHashes.IsValidIndex(NumDefinitions - 1) && DefinitionHashes[NumDefinitions - 1] == ClientCatalogHash;
+	for (auto It = SharedDefinitions.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr()) It.RemoveCurrent();
+	}
+
+	SharedDefinitions.Add(Connection, bSharedCatalog ? NumDefinitions : 0);
+	UE_LOGFMT(InventoryLog, Log, "{0}() {1} has {2} of the {3} item definitions in common with the server", *FString(__FUNCTION__), *GetNameSafe(Connection), bSharedCatalog ? NumDefinitions : 0, Definitions.Num());
+}
+
+
+bool UInventoryItemCatalog::IsSharedItemDefId(UPackageMap* Map, const int32 ItemDefId) const
+{
+	if (ItemDefId < 0 || SharedDefinitions.IsEmpty()) return false;
+
+	UPackageMapClient* PackageMap = Cast<UPackageMapClient>(Map);
+	const int32* NumShared = PackageMap ? SharedDefinitions.Find(PackageMap->GetConnection()) : nullptr;
+	return NumShared && ItemDefId < *NumShared;
+}
+
+
+bool UInventoryItemCatalog::CreateItem(const FName DatabaseId, F_Item& OutItem) const
+{
+	const int32 ItemDefId = FindItemDefId(DatabaseId);
+	const F_Item* Definition = GetDefinition(ItemDefId);
+	if (DatabaseId.IsNone() || !Definition || IsPendingDefinition(ItemDefId)) return false;
+
+	OutItem = *Definition;
+	OutItem.Id = UInventoryItemHandleAllocator::AllocateItemId();
+	return true;
+}
+
+
+int32 UInventoryItemCatalog::SetDefinition(const FName DatabaseId, const F_Item& Item)
+{
+	int32 ItemDefId = FindItemDefId(DatabaseId);
+	if (INDEX_NONE == ItemDefId)
+	{
+		ItemDefId = Definitions.AddDefaulted();
+		DatabaseIds.Add(DatabaseId);
+		ItemDefIds.Add(DatabaseId, ItemDefId);
+		CatalogHash = FCrc::StrCrc32(*DatabaseId.ToString().ToLower(), CatalogHash);
+		DefinitionHashes.Add(CatalogHash);
+	}
+
+	// The definition only holds the shared information, the instance information is stored on each item
+	F_Item& Definition = Definitions[ItemDefId];
+	Definition = Item;
+	Definition.Id = FGuid();
+	Definition.SortOrder = -1;
+	Definition.Quantity = 1;
+	if (Definition.ItemName.IsNone()) Definition.ItemName = DatabaseId;
+
+	if (PendingDefinitions.Remove(ItemDefId) > 0) OnPendingDefinitionAdded.Broadcast(ItemDefId);
+	return ItemDefId;
+}
+
+
+void UInventoryItemCatalog::ResolveItemDefIds(const TConstArrayView<FName> InDatabaseIds, TArray<int32>& OutItemDefIds) const
+{
+	OutItemDefIds.Reset(InDatabaseIds.Num());
+	for (const FName DatabaseId : InDatabaseIds)
+	{
+		OutItemDefIds.Add(FindItemDefId(DatabaseId));
+	}
+}
+
+
+void UInventoryItemCatalog::ResolveDefinitions(const TConstArrayView<int32> InItemDefIds, TArray<const F_Item*>& OutDefinitions) const
+{
+	OutDefinitions.Reset(InItemDefIds.Num());
+	for (const int32 ItemDefId : InItemDefIds)
+	{
+		OutDefinitions.Add(GetDefinition(ItemDefId));
+	}
+}
+
+
+bool UInventoryItemCatalog::GetItemDefinition(const FName DatabaseId, F_Item& Item) const
+{
+	const F_Item* Definition = FindDefinition(DatabaseId);
+	if (!Definition) return false;
+
+	Item = *Definition;
+	return true;
+}
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryItemClaims.h"
+
+#include "InventorySystemSettings.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
+#include "Inventory/InventoryComponent.h"
+#include "Logging/StructuredLog.h"
+
+
+void UInventoryItemClaims::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings)
+	{
+		LeaseDuration = FMath::Max(Settings->ItemClaimLeaseDuration, 0.1f);
+		QueueTimeout = FMath::Max(Settings->ItemClaimQueueTimeout, 0.0f);
+	}
+}
+
+
+void UInventoryItemClaims::Deinitialize()
+{
+	if (GetWorld()) GetWorld()->GetTimerManager().ClearTimer(ExpiredClaimsTimer);
+	Claims.Empty();
+
+	Super::Deinitialize();
+}
+
+
+void UInventoryItemClaims::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	if (InWorld.GetNetMode() == NM_Client) return;
+
+	// Claims are checked when they're used, this just keeps the table from holding onto claims nobody's asked about
+	InWorld.GetTimerManager().SetTimer(ExpiredClaimsTimer, this, &UInventoryItemClaims::RemoveExpiredClaims, 1.0f, true);
+}
+
+
+UInventoryItemClaims* UInventoryItemClaims::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UInventoryItemClaims>() : nullptr;
+}
+
+
+FGuid UInventoryItemClaims::GetObjectClaimId(const UObject* Object)
+{
+	// Item ids are never made with the first three parts empty
+	return Object ? FGuid(0, 0, 0, Object->GetUniqueID() + 1) : FGuid();
+}
+
+
+EInventoryItemClaimResult UInventoryItemClaims::TryClaim(const FGuid& Id, UObject* Claimant, const float Lease, const bool bWaitInLine)
+{
+	const double Time = GetTime();
+	const EInventoryItemClaimResult Result = CheckClaim(Id, Claimant, Time, bWaitInLine);
+	if (EInventoryItemClaimResult::Claim_Succeeded == Result) SetClaim(Id, Claimant, Time, Lease);
+	return Result;
+}
+
+
+bool UInventoryItemClaims::TryClaimAll(const TConstArrayView<FGuid> Ids, UObject* Claimant, const float Lease, TArray<EInventoryItemClaimResult>* OutResults, const bool bWaitInLine)
+{
+	// Check every item before claiming any of them
+	const double Time = GetTime();
+	bool bClaimable = true;
+	if (OutResults) OutResults->Reset(Ids.Num());
+	for (const FGuid& Id : Ids)
+	{
+		const EInventoryItemClaimResult Result = CheckClaim(Id, Claimant, Time, bWaitInLine);
+		bClaimable &= EInventoryItemClaimResult::Claim_Succeeded == Result;
+		if (OutResults) OutResults->Add(Result);
+	}
+
+	if (!bClaimable) return false;
+	for (const FGuid& Id : Ids)
+	{
+		SetClaim(Id, Claimant, Time, Lease);
+	}
+
+	return true;
+}
+
+
+void UInventoryItemClaims::Release(const FGuid& Id, UObject* Claimant)
+{
+	FClaim* Claim = Claims.Find(Id);
+	if (!Claim || !Claimant || Claim->Claimant != Claimant) return;
+
+	Claim->Claimant.Reset();
+	Stats.NumReleased++;
+	Stats.NumActive = FMath::Max(Stats.NumActive - 1, 0);
+
+	// The first claimant in line has a chance to claim the item before anyone else
+	if (Claim->Waiters.IsEmpty()) Claims.Remove(Id);
+	else NotifyNextWaiter(Id, *Claim, GetTime());
+}
+
+
+void UInventoryItemClaims::ReleaseAll(const TConstArrayView<FGuid> Ids, UObject* Claimant)
+{
+	for (const FGuid& Id : Ids)
+	{
+		Release(Id, Claimant);
+	}
+}
+
+
+bool UInventoryItemClaims::IsClaimed(const FGuid& Id) const
+{
+	const FClaim* Claim = Claims.Find(Id);
+	return Claim && Claim->IsActive(GetTime());
+}
+
+
+UObject* UInventoryItemClaims::GetClaimant(const FGuid& Id) const
+{
+	const FClaim* Claim = Claims.Find(Id);
+	return Claim && Claim->IsActive(GetTime()) ? Claim->Claimant.Get() : nullptr;
+}
+
+
+void UInventoryItemClaims::ListClaimStats() const
+{
+	UE_LOGFMT(InventoryLog, Log, "//----------------------------------------------------------------------------------------------------------------------------//");
+	UE_LOGFMT(InventoryLog, Log, "// Item claims: active: {0} (peak {1}), claimed: {2}, contended: {3}, queued: {4}, released: {5}, expired: {6}",
+		Stats.NumActive, Stats.PeakActive, Stats.NumClaimed, Stats.NumContended, Stats.NumQueued, Stats.NumReleased, Stats.NumExpired
+	);
+	UE_LOGFMT(InventoryLog, Log, "//----------------------------------------------------------------------------------------------------------------------------//");
+}
+
+
+bool UInventoryItemClaims::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+EInventoryItemClaimResult UInventoryItemClaims::CheckClaim(const FGuid& Id, UObject* Claimant, const double Time, const bool bWaitInLine)
+{
+	if (!Id.IsValid() || !Claimant) return EInventoryItemClaimResult::Claim_Invalid;
+
+	FClaim* Claim = Claims.Find(Id);
+	if (!Claim) return EInventoryItemClaimResult::Claim_Succeeded;
+
+	// Claims that ran out (or whose claimant is gone) are released when someone else asks for the item
+	if (!Claim->Claimant.IsExplicitlyNull() && !Claim->IsActive(Time))
+	{
+		Claim->Claimant.Reset();
+		Stats.NumExpired++;
+		Stats.NumActive = FMath::Max(Stats.NumActive - 1, 0);
+		if (!Claim->Waiters.IsEmpty()) Claim->Waiters[0].ExpireTime = FMath::Max(Claim->Waiters[0].ExpireTime, Time + QueueTimeout);
+	}
+
+	const auto WaitInLine = [this, Claim, Claimant, Time, bWaitInLine]()
+	{
+		if (!bWaitInLine) return;
+
+		const double ExpireTime = FMath::Max(Claim->ExpireTime, Time) + QueueTimeout;
+		FWaiter* Waiter = Claim->Waiters.FindByPredicate([Claimant](const FWaiter& Other) { return Other.Claimant == Claimant; });
+		if (Waiter) Waiter->ExpireTime = FMath::Max(Waiter->ExpireTime, ExpireTime);
+		else Claim->Waiters.Add(FWaiter{Claimant, ExpireTime});
+	};
+
+	if (Claim->IsActive(Time))
+	{
+		if (Claim->Claimant == Claimant) return EInventoryItemClaimResult::Claim_Succeeded;
+
+		Stats.NumContended++;
+		OnClaimContended.Broadcast(Id, Claim->Claimant.Get(), Claimant);
+		WaitInLine();
+		return EInventoryItemClaimResult::Claim_Contended;
+	}
+
+	// The item is free, the first claimant in line that's still waiting gets it. Each claimant that gives up passes their turn to the next one
+	while (!Claim->Waiters.IsEmpty() && (!Claim->Waiters[0].Claimant.IsValid() || Claim->Waiters[0].ExpireTime <= Time))
+	{
+		const double PreviousExpireTime = Claim->Waiters[0].ExpireTime;
+		Claim->Waiters.RemoveAt(0, 1, false);
+		if (!Claim->Waiters.IsEmpty()) Claim->Waiters[0].ExpireTime = FMath::Max(Claim->Waiters[0].ExpireTime, PreviousExpireTime + QueueTimeout);
+	}
+
+	if (!Claim->Waiters.IsEmpty() && Claim->Waiters[0].Claimant != Claimant)
+	{
+		Stats.NumQueued++;
+		OnClaimContended.Broadcast(Id, Claim->Waiters[0].Claimant.Get(), Claimant);
+		WaitInLine();
+		return EInventoryItemClaimResult::Claim_Queued;
+	}
+
+	return EInventoryItemClaimResult::Claim_Succeeded;
+}
+
+
+void UInventoryItemClaims::SetClaim(const FGuid& Id, UObject* Claimant, const double Time, const float Lease)
+{
+	FClaim& Claim = Claims.FindOrAdd(Id);
+	if (Claim.Claimant != Claimant)
+	{
+		Stats.NumClaimed++;
+		Stats.NumActive++;
+		Stats.PeakActive = FMath::Max(Stats.PeakActive, Stats.NumActive);
+	}
+
+	Claim.Claimant = Claimant;
+	Claim.ExpireTime = Time + (Lease > 0.0f ? Lease : LeaseDuration);
+	Claim.Waiters.RemoveAll([Claimant](const FWaiter& Waiter) { return Waiter.Claimant == Claimant; });
+}
+
+
+void UInventoryItemClaims::RemoveExpiredClaims()
+{
+	const double Time = GetTime();
+	TArray<FGuid> ExpiredIds;
+	for (auto Claim = Claims.CreateIterator(); Claim; ++Claim)
+	{
+		if (!Claim->Value.Claimant.IsExplicitlyNull() && !Claim->Value.IsActive(Time))
+		{
+			Claim->Value.Claimant.Reset();
+			Stats.NumExpired++;
+			Stats.NumActive = FMath::Max(Stats.NumActive - 1, 0);
+			ExpiredIds.Add(Claim->Key);
+		}
+
+		if (Claim->Value.Claimant.IsExplicitlyNull())
+		{
+			Claim->Value.Waiters.RemoveAll([Time](const FWaiter& Waiter) { return !Waiter.Claimant.IsValid() || Waiter.ExpireTime <= Time; });
+			if (Claim->Value.Waiters.IsEmpty()) Claim.RemoveCurrent();
+		}
+	}
+
+	// The waiters are told once the table isn't being iterated, they'll usually try to claim the item right away
+	for (const FGuid& Id : ExpiredIds)
+	{
+		if (FClaim* Claim = Claims.Find(Id)) NotifyNextWaiter(Id, *Claim, Time);
+	}
+}
+
+
+void UInventoryItemClaims::NotifyNextWaiter(const FGuid& Id, FClaim& Claim, const double Time)
+{
+	if (Claim.Waiters.IsEmpty()) return;
+
+	Claim.Waiters[0].ExpireTime = Time + QueueTimeout;
+	UObject* Waiter = Claim.Waiters[0].Claimant.Get();
+	if (Waiter) OnClaimAvailable.Broadcast(Id, Waiter);
+}
+
+
+double UInventoryItemClaims::GetTime() const
+{
+	return GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryItemHandle.h"
+
+
+bool FInventoryItemHandle::FromGuid(const FGuid& Id, FInventoryItemHandle& OutHandle)
+{
+	if (Id.A != GuidTagA || Id.B != GuidTagB) return false;
+
+	OutHandle = FInventoryItemHandle((static_cast<uint64>(Id.C) << 32) | Id.D);
+	return OutHandle.IsValid();
+}
+
+
+void FInventoryItemHandle::NetSerializeId(FArchive& Ar, FGuid& Id)
+{
+	FInventoryItemHandle Handle;
+	uint8 bIsHandle = Ar.IsSaving() && FromGuid(Id, Handle);
+	Ar.SerializeBits(&bIsHandle, 1);
+
+	if (bIsHandle)
+	{
+		Ar << Handle.Value;
+		if (Ar.IsLoading()) Id = Handle.ToGuid();
+	}
+	else
+	{
+		Ar << Id;
+	}
+}
+
+
+bool FInventoryItemHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Value;
+	bOutSuccess = true;
+	return true;
+}
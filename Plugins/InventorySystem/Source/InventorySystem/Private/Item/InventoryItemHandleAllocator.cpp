@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryItemHandleAllocator.h"
+
+#include "InventorySystemSettings.h"
+#include "Inventory/InventoryComponent.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+UInventoryItemHandleAllocator* UInventoryItemHandleAllocator::Allocator = nullptr;
+
+
+void UInventoryItemHandleAllocator::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	int32 Id = Settings ? Settings->ItemHandleServerId : 0;
+	FParse::Value(FCommandLine::Get(), TEXT("InventoryServerId="), Id);
+	ServerId = static_cast<uint16>(FMath::Clamp(Id, 0, static_cast<int32>(MAX_uint16)));
+	BlockSize = Settings ? FMath::Max(Settings->ItemHandleBlockSize, 1) : 65536;
+
+	// Every dedicated server uses the same handles if they're all left on the default id, and their items collide once they share save games
+	if (0 == ServerId && IsRunningDedicatedServer())
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0}() This dedicated server is using the default item handle server id (0). If more than one server shares save games, give each one a different ItemHandleServerId or launch it with -InventoryServerId=", *FString(__FUNCTION__));
+	}
+
+	// Continue after the last block this server reserved, the handles before it might already be in use
+	uint64 ReservedEnd = 1;
+	FString SavedBlock;
+	if (FFileHelper::LoadFileToString(SavedBlock, *GetBlockFilePath()))
+	{
+		LexFromString(ReservedEnd, *SavedBlock.TrimStartAndEnd());
+		ReservedEnd = FMath::Max<uint64>(ReservedEnd, 1);
+	}
+
+	NextSequence.store(ReservedEnd);
+	BlockEnd.store(ReservedEnd);
+	Allocator = this;
+}
+
+
+void UInventoryItemHandleAllocator::Deinitialize()
+{
+	if (Allocator == this) Allocator = nullptr;
+	Super::Deinitialize();
+}
+
+
+FInventoryItemHandle UInventoryItemHandleAllocator::Allocate()
+{
+	const uint64 Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+
+	// The sequence would wrap around into handles that are already in use
+	if (Sequence > FInventoryItemHandle::SequenceMask)
+	{
+		if (!bExhausted.exchange(true))
+		{
+			UE_LOGFMT(InventoryLog, Error, "{0}() Server {1} has run out of item handles! New items are given guids, use a different server id for this server", *FString(__FUNCTION__), ServerId);
+		}
+		return FInventoryItemHandle();
+	}
+
+	if (Sequence >= BlockEnd.load(std::memory_order_acquire))
+	{
+		ReserveBlock(Sequence);
+	}
+
+	return FInventoryItemHandle(ServerId, Sequence, 0);
+}
+
+
+FGuid UInventoryItemHandleAllocator::AllocateItemId()
+{
+	const FInventoryItemHandle Handle = Allocator ? Allocator->Allocate() : FInventoryItemHandle();
+	return Handle.IsValid() ? Handle.ToGuid() : FGuid::NewGuid();
+}
+
+
+FGuid UInventoryItemHandleAllocator::ReissueItemId(const FGuid& Id)
+{
+	FInventoryItemHandle Handle;
+	return FInventoryItemHandle::FromGuid(Id, Handle) ? Handle.NextGeneration().ToGuid() : Id;
+}
+
+
+bool UInventoryItemHandleAllocator::IsStaleItemId(const FGuid& Id, const FGuid& CurrentId)
+{
+	FInventoryItemHandle Handle, CurrentHandle;
+	return FInventoryItemHandle::FromGuid(Id, Handle) && FInventoryItemHandle::FromGuid(CurrentId, CurrentHandle) && Handle.IsStale(CurrentHandle);
+}
+
+
+void UInventoryItemHandleAllocator::ReserveBlock(const uint64 Sequence)
+{
+	FScopeLock Lock(&BlockLock);
+
+	// Another thread already reserved this block
+	if (Sequence < BlockEnd.load(std::memory_order_relaxed)) return;
+
+	// The block is saved before it's used, so a crash never reuses a handle
+	const uint64 NewBlockEnd = Sequence + BlockSize;
+	if (!FFileHelper::SaveStringToFile(LexToString(NewBlockEnd), *GetBlockFilePath()))
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0}() Failed to save the reserved item handles for server {1}, handles might be reused if the server restarts", *FString(__FUNCTION__), ServerId);
+	}
+
+	BlockEnd.store(NewBlockEnd, std::memory_order_release);
+}
+
+
+FString UInventoryItemHandleAllocator::GetBlockFilePath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("Inventory") / FString::Printf(TEXT("ItemHandles_%u.txt"), ServerId);
+}
+
+
+bool UInventoryItemHandleAllocator::IsItemHandleId(const FGuid& Id)
+{
+	FInventoryItemHandle Handle;
+	return FInventoryItemHandle::FromGuid(Id, Handle);
+}
+
+
+int32 UInventoryItemHandleAllocator::GetItemServerId(const FGuid& Id)
+{
+	FInventoryItemHandle Handle;
+	return FInventoryItemHandle::FromGuid(Id, Handle) ? Handle.GetServerId() : -1;
+}
@@ -3,6 +3,18 @@
 
 #include "Item/InventoryItemInterface.h"
 
+#include "GameFramework/Character.h"
+#include "Item/InventoryItemClaims.h"
+
+
+/** Returns the id an item is claimed with. Items without an id (like items that haven't been given one yet) are claimed by their object instead */
+static FGuid GetItemClaimId(const UObject* Object)
+{
+	const FGuid Id = IInventoryItemInterface::Execute_GetId(Object);
+	return Id.IsValid() ? Id : UInventoryItemClaims::GetObjectClaimId(Object);
+}
+
+
 F_Item IInventoryItemInterface::GetItem_Implementation() const
 {
 	return F_Item();
@@ -33,16 +45,29 @@ void IInventoryItemInterface::SetId_Implementation(const FGuid& Id)
 
 bool IInventoryItemInterface::IsSafeToAdjustItem_Implementation() const
 {
-	return true;
+	// Items are claimed by their id in the world's claim table (UInventoryItemClaims)
+	const UObject* Object = _getUObject();
+	const UInventoryItemClaims* Claims = UInventoryItemClaims::Get(Object);
+	return !Claims || !Claims->IsClaimed(GetItemClaimId(Object));
 }
 
 void IInventoryItemInterface::SetPlayerPending_Implementation(ACharacter* Player)
 {
+	UObject* Object = _getUObject();
+	UInventoryItemClaims* Claims = UInventoryItemClaims::Get(Object);
+	if (!Claims) return;
+
+	const FGuid Id = GetItemClaimId(Object);
+	// Interactions aren't retried, so players don't wait in line for the item (they'd only keep everyone else from it)
+	if (Player) Claims->TryClaim(Id, Player, 0.0f, false);
+	else Claims->Release(Id, Claims->GetClaimant(Id));
 }
 
 ACharacter* IInventoryItemInterface::GetPlayerPending_Implementation()
 {
-	return nullptr;
+	const UObject* Object = _getUObject();
+	const UInventoryItemClaims* Claims = UInventoryItemClaims::Get(Object);
+	return Claims ? Cast<ACharacter>(Claims->GetClaimant(GetItemClaimId(Object))) : nullptr;
 }
 
 void IInventoryItemInterface::SetItemInformationDatabase_Implementation(UDataTable* Database)
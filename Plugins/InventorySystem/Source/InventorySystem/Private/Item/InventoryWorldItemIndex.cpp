@@ -0,0 +1,266 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryWorldItemIndex.h"
+
+#include "InventorySystemSettings.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+
+void UInventoryWorldItemIndex::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings) CellSize = FMath::Max(Settings->WorldItemIndexCellSize, 100.0f);
+}
+
+
+void UInventoryWorldItemIndex::Deinitialize()
+{
+	Entries.Empty();
+	Cells.Empty();
+	ItemEntries.Empty();
+	LightweightEntries.Empty();
+
+	Super::Deinitialize();
+}
+
+
+UInventoryWorldItemIndex* UInventoryWorldItemIndex::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UInventoryWorldItemIndex>() : nullptr;
+}
+
+
+void UInventoryWorldItemIndex::AddWorldItem(UObject* Item, const FVector& Location)
+{
+	if (!Item) return;
+
+	const int32* EntryIndex = ItemEntries.Find(Item);
+	ItemEntries.Add(Item, SetEntry(EntryIndex ? *EntryIndex : INDEX_NONE, Item, FGuid(), Location));
+}
+
+
+void UInventoryWorldItemIndex::UpdateWorldItem(const AActor* Item)
+{
+	const int32* EntryIndex = Item ? ItemEntries.Find(Item) : nullptr;
+	if (EntryIndex) SetEntry(*EntryIndex, Entries[*EntryIndex].Item.Get(), FGuid(), Item->GetActorLocation());
+}
+
+
+void UInventoryWorldItemIndex::RemoveWorldItem(const UObject* Item)
+{
+	int32 EntryIndex;
+	if (Item && ItemEntries.RemoveAndCopyValue(Item, EntryIndex)) RemoveEntry(EntryIndex);
+}
+
+
+void UInventoryWorldItemIndex::AddLightweightItem(const FGuid& Id, const FVector& Location)
+{
+	if (!Id.IsValid()) return;
+
+	const int32* EntryIndex = LightweightEntries.Find(Id);
+	LightweightEntries.Add(Id, SetEntry(EntryIndex ? *EntryIndex : INDEX_NONE, nullptr, Id, Location));
+}
+
+
+void UInventoryWorldItemIndex::RemoveLightweightItem(const FGuid& Id)
+{
+	int32 EntryIndex;
+	if (LightweightEntries.RemoveAndCopyValue(Id, EntryIndex)) RemoveEntry(EntryIndex);
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Queries																			//
+//----------------------------------------------------------------------------------//
+bool UInventoryWorldItemIndex::FindItemsInRadius(const FVector& Origin, const float Radius, TArray<FInventoryWorldItemQueryResult>& OutItems, const int32 MaxItems) const
+{
+	OutItems.Reset();
+	if (Radius <= 0.0f) return false;
+
+	const FIntPoint Min = GetCell(Origin - FVector(Radius));
+	const FIntPoint Max = GetCell(Origin + FVector(Radius));
+	const auto AnyItem = [](const FVector&) { return true; };
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			GatherCell(FIntPoint(X, Y), Origin, FMath::Square(Radius), AnyItem, OutItems);
+		}
+	}
+
+	SortResults(OutItems, MaxItems);
+	return !OutItems.IsEmpty();
+}
+
+
+bool UInventoryWorldItemIndex::FindNearestItems(const FVector& Origin, const int32 NumItems, const float MaxRadius, TArray<FInventoryWorldItemQueryResult>& OutItems) const
+{
+	OutItems.Reset();
+	if (NumItems <= 0 || MaxRadius <= 0.0f) return false;
+
+	// Check the rings of cells around the origin. Every cell that hasn't been checked is at least Ring * CellSize away, so once there's enough items closer than that the search is finished
+	const FIntPoint Center = GetCell(Origin);
+	const int32 MaxRing = FMath::CeilToInt32(MaxRadius / CellSize);
+	const double MaxDistanceSquared = FMath::Square(MaxRadius);
+	const auto AnyItem = [](const FVector&) { return true; };
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		if (Ring == 0)
+		{
+			GatherCell(Center, Origin, MaxDistanceSquared, AnyItem, OutItems);
+		}
+		else
+		{
+			for (int32 Offset = -Ring; Offset <= Ring; Offset++)
+			{
+				GatherCell(Center + FIntPoint(Offset, -Ring), Origin, MaxDistanceSquared, AnyItem, OutItems);
+				GatherCell(Center + FIntPoint(Offset, Ring), Origin, MaxDistanceSquared, AnyItem, OutItems);
+			}
+			for (int32 Offset = -Ring + 1; Offset < Ring; Offset++)
+			{
+				GatherCell(Center + FIntPoint(-Ring, Offset), Origin, MaxDistanceSquared, AnyItem, OutItems);
+				GatherCell(Center + FIntPoint(Ring, Offset), Origin, MaxDistanceSquared, AnyItem, OutItems);
+			}
+		}
+
+		if (OutItems.Num() >= NumItems)
+		{
+			SortResults(OutItems, NumItems);
+			if (OutItems.Last().Distance <= Ring * CellSize) break;
+		}
+	}
+
+	SortResults(OutItems, NumItems);
+	return !OutItems.IsEmpty();
+}
+
+
+bool UInventoryWorldItemIndex::FindItemsInCone(const FVector& Origin, const FVector& Direction, const float Radius, const float HalfAngle, TArray<FInventoryWorldItemQueryResult>& OutItems, const int32 MaxItems) const
+{
+	OutItems.Reset();
+	const FVector ConeDirection = Direction.GetSafeNormal();
+	if (Radius <= 0.0f || ConeDirection.IsZero()) return false;
+
+	const double MinDot = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(HalfAngle, 0.0f, 180.0f)));
+	const auto InCone = [&Origin, &ConeDirection, MinDot](const FVector& Location)
+	{
+		const FVector ToItem = (Location - Origin).GetSafeNormal();
+		return ToItem.IsZero() || FVector::DotProduct(ToItem, ConeDirection) >= MinDot;
+	};
+
+	const FIntPoint Min = GetCell(Origin - FVector(Radius));
+	const FIntPoint Max = GetCell(Origin + FVector(Radius));
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			GatherCell(FIntPoint(X, Y), Origin, FMath::Square(Radius), InCone, OutItems);
+		}
+	}
+
+	SortResults(OutItems, MaxItems);
+	return !OutItems.IsEmpty();
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Grid																				//
+//----------------------------------------------------------------------------------//
+bool UInventoryWorldItemIndex::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+FIntPoint UInventoryWorldItemIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+
+int32 UInventoryWorldItemIndex::SetEntry(int32 EntryIndex, UObject* Item, const FGuid& Id, const FVector& Location)
+{
+	const FIntPoint Cell = GetCell(Location);
+	if (EntryIndex != INDEX_NONE && Entries.IsValidIndex(EntryIndex))
+	{
+		// Items that stay in the same cell only need their location updated
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.Location = Location;
+		if (Entry.Cell == Cell) return EntryIndex;
+
+		if (TArray<int32>* PreviousCell = Cells.Find(Entry.Cell))
+		{
+			PreviousCell->RemoveSingleSwap(EntryIndex, false);
+			if (PreviousCell->IsEmpty()) Cells.Remove(Entry.Cell);
+		}
+		Entry.Cell = Cell;
+	}
+	else
+	{
+		EntryIndex = Entries.Add(FEntry{Item, Id, Location, Cell});
+	}
+
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+	return EntryIndex;
+}
+
+
+void UInventoryWorldItemIndex::RemoveEntry(const int32 EntryIndex)
+{
+	if (!Entries.IsValidIndex(EntryIndex)) return;
+
+	const FIntPoint Cell = Entries[EntryIndex].Cell;
+	if (TArray<int32>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, false);
+		if (CellEntries->IsEmpty()) Cells.Remove(Cell);
+	}
+
+	Entries.RemoveAt(EntryIndex);
+}
+
+
+template<typename FilterType>
+void UInventoryWorldItemIndex::GatherCell(const FIntPoint& Cell, const FVector& Origin, const double MaxDistanceSquared, FilterType&& Filter, TArray<FInventoryWorldItemQueryResult>& OutItems) const
+{
+	const TArray<int32>* CellEntries = Cells.Find(Cell);
+	if (!CellEntries) return;
+
+	for (const int32 EntryIndex : *CellEntries)
+	{
+		const FEntry& Entry = Entries[EntryIndex];
+		const double DistanceSquared = FVector::DistSquared(Origin, Entry.Location);
+		if (DistanceSquared > MaxDistanceSquared || !Filter(Entry.Location)) continue;
+
+		// Pooled items are hidden on clients, the server removes them when they're released
+		UObject* Item = nullptr;
+		if (!Entry.Id.IsValid())
+		{
+			Item = Entry.Item.Get();
+			const AActor* Actor = Cast<AActor>(Item);
+			if (!Item || (Actor && Actor->IsHidden())) continue;
+		}
+
+		FInventoryWorldItemQueryResult& Result = OutItems.AddDefaulted_GetRef();
+		Result.Item = Item;
+		Result.Id = Entry.Id;
+		Result.Location = Entry.Location;
+		Result.Distance = FMath::Sqrt(DistanceSquared);
+	}
+}
+
+
+void UInventoryWorldItemIndex::SortResults(TArray<FInventoryWorldItemQueryResult>& OutItems, const int32 MaxItems)
+{
+	OutItems.Sort([](const FInventoryWorldItemQueryResult& A, const FInventoryWorldItemQueryResult& B) { return A.Distance < B.Distance; });
+	if (MaxItems > 0 && OutItems.Num() > MaxItems) OutItems.SetNum(MaxItems, false);
+}
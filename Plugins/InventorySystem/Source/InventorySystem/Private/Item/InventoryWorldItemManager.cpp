@@ -0,0 +1,278 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryWorldItemManager.h"
+
+#include "InventorySystemSettings.h"
+#include "TimerManager.h"
+#include "Engine/DataTable.h"
+#include "Engine/World.h"
+#include "Inventory/InventoryComponent.h"
+#include "Item/InventoryItemAssets.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Item/InventoryWorldItemPool.h"
+#include "Item/ItemBase.h"
+#include "Logging/StructuredLog.h"
+
+
+void UInventoryWorldItemManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings)
+	{
+		RegionSize = FMath::Max(Settings->WorldItemRegionSize, 1000.0f);
+		PromotedItemLifetime = FMath::Max(Settings->PromotedWorldItemLifetime, 0.0f);
+	}
+}
+
+
+void UInventoryWorldItemManager::Deinitialize()
+{
+	if (GetWorld()) GetWorld()->GetTimerManager().ClearTimer(PromotedItemsTimer);
+	Regions.Empty();
+	ItemRegions.Empty();
+	PromotedItems.Empty();
+
+	Super::Deinitialize();
+}
+
+
+void UInventoryWorldItemManager::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	if (InWorld.GetNetMode() == NM_Client) return;
+
+	InWorld.GetTimerManager().SetTimer(PromotedItemsTimer, this, &UInventoryWorldItemManager::UpdatePromotedItems, 1.0f, true);
+}
+
+
+bool UInventoryWorldItemManager::AddWorldItem(const F_Item& Item, const FTransform& Transform)
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!GetWorld() || GetWorld()->GetNetMode() == NM_Client || !Catalog || !Item.Id.IsValid()) return false;
+
+	const int32 DefinitionId = Catalog->FindItemDefId(Item.ItemName);
+	if (DefinitionId == INDEX_NONE)
+	{
+		UE_LOGFMT(InventoryLog, Warning, "{0}() {1} isn't in the item catalog, it can't be a lightweight world item", *FString(__FUNCTION__), Item.ItemName);
+		return false;
+	}
+
+	const FVector Location = Transform.GetLocation();
+	const FIntPoint Cell = GetRegionCell(Location);
+	AInventoryWorldItemRegion* Region = FindOrCreateRegion(Cell, Location);
+	if (!Region) return false;
+
+	// An item that's being added again (a promoted item that's dropped) is moved to it's new region
+	if (const FIntPoint* PreviousCell = ItemRegions.Find(Item.Id))
+	{
+		if (*PreviousCell != Cell)
+		{
+			if (AInventoryWorldItemRegion* PreviousRegion = GetRegion(*PreviousCell)) PreviousRegion->RemoveItem(Item.Id);
+		}
+	}
+
+	Region->AddItem(FInventoryWorldItemRecord(Item.Id, DefinitionId, FMath::Max(Item.Quantity, 1), Location, Transform.Rotator()));
+	ItemRegions.Add(Item.Id, Cell);
+	return true;
+}
+
+
+bool UInventoryWorldItemManager::RemoveWorldItem(const FGuid& Id)
+{
+	FIntPoint Cell;
+	if (!ItemRegions.RemoveAndCopyValue(Id, Cell)) return false;
+
+	AInventoryWorldItemRegion* Region = GetRegion(Cell);
+	return Region && Region->RemoveItem(Id);
+}
+
+
+bool UInventoryWorldItemManager::FindWorldItem(const FGuid& Id, FInventoryWorldItemRecord& Record) const
+{
+	// The server knows which region every item is in, clients search the regions they've received
+	if (const FIntPoint* Cell = ItemRegions.Find(Id))
+	{
+		const AInventoryWorldItemRegion* Region = GetRegion(*Cell);
+		const FInventoryWorldItemRecord* Item = Region ? Region->FindItem(Id) : nullptr;
+		if (Item) Record = *Item;
+		return Item != nullptr;
+	}
+
+	for (const TPair<FIntPoint, TObjectPtr<AInventoryWorldItemRegion>>& Region : Regions)
+	{
+		const FInventoryWorldItemRecord* Item = Region.Value ? Region.Value->FindItem(Id) : nullptr;
+		if (Item)
+		{
+			Record = *Item;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+FGuid UInventoryWorldItemManager::FindWorldItemFromHit(const FHitResult& Hit) const
+{
+	const AInventoryWorldItemRegion* Region = Cast<AInventoryWorldItemRegion>(Hit.GetActor());
+	return Region ? Region->FindItemFromInstance(Hit.GetComponent(), Hit.Item) : FGuid();
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Promotion																		//
+//----------------------------------------------------------------------------------//
+AItemBase* UInventoryWorldItemManager::PromoteWorldItem(const FGuid& Id)
+{
+	if (AItemBase* WorldItem = GetPromotedWorldItem(Id)) return WorldItem;
+
+	const FIntPoint* Cell = ItemRegions.Find(Id);
+	AInventoryWorldItemRegion* Region = Cell ? GetRegion(*Cell) : nullptr;
+	const FInventoryWorldItemRecord* Item = Region ? Region->FindItem(Id) : nullptr;
+	if (!Item) return nullptr;
+
+	const FInventoryWorldItemRecord Record = *Item;
+	const F_Item ItemInformation = Record.ResolveItem();
+	UClass* WorldClass = !ItemInformation.WorldClass.IsNull() ? Cast<UClass>(UInventoryItemAssets::LoadItemAsset(ItemInformation.WorldClass.ToSoftObjectPath())) : nullptr;
+	if (!WorldClass) return nullptr;
+
+	// The world item uses the default item database, the item's information comes from the catalog
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	UDataTable* Database = Settings ? Settings->ItemDatabase.Get() : nullptr;
+
+	AItemBase* WorldItem = nullptr;
+	if (UInventoryWorldItemPool* WorldItemPool = GetWorld()->GetSubsystem<UInventoryWorldItemPool>())
+	{
+		WorldItem = WorldItemPool->AcquireWorldItem(WorldClass, Record.GetTransform(), ItemInformation, Database);
+	}
+	if (!WorldItem) return nullptr;
+
+	Region->RemoveItem(Id);
+	ItemRegions.Remove(Id);
+
+	FInventoryPromotedWorldItem& PromotedItem = PromotedItems.Add(Id);
+	PromotedItem.WorldItem = WorldItem;
+	PromotedItem.Record = Record;
+	PromotedItem.PromotedTime = GetWorld()->GetTimeSeconds();
+	return WorldItem;
+}
+
+
+bool UInventoryWorldItemManager::DemoteWorldItem(const FGuid& Id)
+{
+	FInventoryPromotedWorldItem PromotedItem;
+	if (!PromotedItems.RemoveAndCopyValue(Id, PromotedItem)) return false;
+
+	AItemBase* WorldItem = PromotedItem.WorldItem.Get();
+	if (!IsValid(WorldItem) || WorldItem->IsInPool()) return false;
+
+	// The stack could have been partially picked up while it was an actor
+	const F_Item Item = WorldItem->Execute_GetItem(WorldItem);
+	if (Item.Id != Id) return false;
+
+	FInventoryWorldItemRecord Record = PromotedItem.Record;
+	Record.Quantity = FMath::Max(Item.Quantity, 1);
+	const FIntPoint Cell = GetRegionCell(Record.Location);
+	AInventoryWorldItemRegion* Region = FindOrCreateRegion(Cell, Record.Location);
+	if (!Region) return false;
+
+	Region->AddItem(Record);
+	ItemRegions.Add(Id, Cell);
+	UInventoryWorldItemPool::ReleaseOrDestroy(WorldItem);
+	return true;
+}
+
+
+AItemBase* UInventoryWorldItemManager::GetPromotedWorldItem(const FGuid& Id) const
+{
+	const FInventoryPromotedWorldItem* PromotedItem = PromotedItems.Find(Id);
+	AItemBase* WorldItem = PromotedItem ? PromotedItem->WorldItem.Get() : nullptr;
+	return IsValid(WorldItem) && !WorldItem->IsInPool() ? WorldItem : nullptr;
+}
+
+
+void UInventoryWorldItemManager::UpdatePromotedItems()
+{
+	if (PromotedItems.IsEmpty()) return;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	TArray<FGuid> ExpiredItems;
+	for (auto PromotedItem = PromotedItems.CreateIterator(); PromotedItem; ++PromotedItem)
+	{
+		// Items that have been picked up have been returned to the pool, or reused for another item
+		const AItemBase* WorldItem = PromotedItem->Value.WorldItem.Get();
+		if (!IsValid(WorldItem) || WorldItem->IsInPool() || WorldItem->Execute_GetId(WorldItem) != PromotedItem->Key)
+		{
+			PromotedItem.RemoveCurrent();
+			continue;
+		}
+
+		if (Time - PromotedItem->Value.PromotedTime >= PromotedItemLifetime && WorldItem->Execute_IsSafeToAdjustItem(WorldItem))
+		{
+			ExpiredItems.Add(PromotedItem->Key);
+		}
+	}
+
+	for (const FGuid& Id : ExpiredItems)
+	{
+		DemoteWorldItem(Id);
+	}
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Regions																			//
+//----------------------------------------------------------------------------------//
+FIntPoint UInventoryWorldItemManager::GetRegionCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / RegionSize), FMath::FloorToInt32(Location.Y / RegionSize));
+}
+
+
+AInventoryWorldItemRegion* UInventoryWorldItemManager::GetRegion(const FIntPoint& Cell) const
+{
+	const TObjectPtr<AInventoryWorldItemRegion>* Region = Regions.Find(Cell);
+	return Region && IsValid(*Region) ? Region->Get() : nullptr;
+}
+
+
+void UInventoryWorldItemManager::RegisterRegion(AInventoryWorldItemRegion* Region)
+{
+	if (IsValid(Region)) Regions.Add(GetRegionCell(Region->GetActorLocation()), Region);
+}
+
+
+void UInventoryWorldItemManager::UnregisterRegion(AInventoryWorldItemRegion* Region)
+{
+	if (!Region) return;
+
+	const FIntPoint Cell = GetRegionCell(Region->GetActorLocation());
+	if (GetRegion(Cell) == Region) Regions.Remove(Cell);
+}
+
+
+bool UInventoryWorldItemManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+AInventoryWorldItemRegion* UInventoryWorldItemManager::FindOrCreateRegion(const FIntPoint& Cell, const FVector& Location)
+{
+	if (AInventoryWorldItemRegion* Region = GetRegion(Cell)) return Region;
+
+	// The region is placed in the center of it's cell (at the height of the first item) so players are in range of it from anywhere in the cell
+	const FVector RegionLocation((Cell.X + 0.5) * RegionSize, (Cell.Y + 0.5) * RegionSize, Location.Z);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AInventoryWorldItemRegion* Region = GetWorld()->SpawnActor<AInventoryWorldItemRegion>(RegionLocation, FRotator::ZeroRotator, SpawnParameters);
+	if (Region) Regions.Add(Cell, Region);
+	return Region;
+}
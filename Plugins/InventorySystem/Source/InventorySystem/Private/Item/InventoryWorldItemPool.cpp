@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryWorldItemPool.h"
+
+#include "InventorySystemSettings.h"
+#include "Engine/World.h"
+#include "Inventory/InventoryComponent.h"
+#include "Item/ItemBase.h"
+#include "Logging/StructuredLog.h"
+
+
+void UInventoryWorldItemPool::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	MaxFreeItems = Settings ? FMath::Max(Settings->WorldItemPoolSize, 0) : 64;
+}
+
+
+void UInventoryWorldItemPool::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	if (InWorld.GetNetMode() == NM_Client) return;
+
+	// Warm up the pools of the items that are dropped the most
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (!Settings) return;
+	for (const TPair<TSoftClassPtr<AItemBase>, int32>& Prewarm : Settings->WorldItemPoolPrewarm)
+	{
+		PrewarmPool(Prewarm.Key.LoadSynchronous(), Prewarm.Value);
+	}
+}
+
+
+AItemBase* UInventoryWorldItemPool::AcquireWorldItem(UClass* WorldClass, const FTransform& Transform, const F_Item& Item, UDataTable* Database, AActor* Owner)
+{
+	if (!WorldClass || !WorldClass->IsChildOf(AItemBase::StaticClass())) return nullptr;
+
+	FInventoryWorldItemClassPool& Pool = Pools.FindOrAdd(WorldClass);
+	AItemBase* WorldItem = nullptr;
+	while (!WorldItem && !Pool.FreeItems.IsEmpty())
+	{
+		WorldItem = Pool.FreeItems.Pop(false);
+		if (!IsValid(WorldItem)) WorldItem = nullptr;
+	}
+
+	if (WorldItem)
+	{
+		WorldItem->SetOwner(Owner);
+		WorldItem->OnAcquiredFromPool(Transform);
+		Pool.Stats.NumReused++;
+	}
+	else
+	{
+		WorldItem = SpawnWorldItem(WorldClass, Transform, Owner);
+		if (!WorldItem) return nullptr;
+		WorldItem->bSpawnedByPool = true;
+		Pool.Stats.NumSpawned++;
+	}
+
+	WorldItem->Execute_SetItemInformationDatabase(WorldItem, Database);
+	WorldItem->Execute_SetItem(WorldItem, Item);
+	Pool.Stats.NumInUse++;
+	Pool.Stats.PeakInUse = FMath::Max(Pool.Stats.PeakInUse, Pool.Stats.NumInUse);
+	return WorldItem;
+}
+
+
+void UInventoryWorldItemPool::ReleaseWorldItem(AItemBase* WorldItem)
+{
+	if (!IsValid(WorldItem) || WorldItem->IsInPool() || !WorldItem->HasAuthority()) return;
+
+	// Items the pool didn't spawn (placed in the level) aren't pooled, they'd keep the level's actors around forever
+	if (!WorldItem->IsPooled()) WorldItem->Destroy();
+	else ReleaseToPool(Pools.FindOrAdd(WorldItem->GetClass()), WorldItem);
+}
+
+
+void UInventoryWorldItemPool::ReleaseWorldItems(const TConstArrayView<AItemBase*> WorldItems)
+{
+	// Looted items are usually the same few classes, so the class's pool is only looked up when the class changes
+	const UClass* PoolClass = nullptr;
+	FInventoryWorldItemClassPool* Pool = nullptr;
+	for (AItemBase* WorldItem : WorldItems)
+	{
+		if (!IsValid(WorldItem) || WorldItem->IsInPool() || !WorldItem->HasAuthority()) continue;
+		if (!WorldItem->IsPooled())
+		{
+			WorldItem->Destroy();
+			continue;
+		}
+
+		if (WorldItem->GetClass() != PoolClass)
+		{
+			PoolClass = WorldItem->GetClass();
+			Pool = &Pools.FindOrAdd(WorldItem->GetClass());
+			Pool->FreeItems.Reserve(FMath::Min(Pool->FreeItems.Num() + WorldItems.Num(), MaxFreeItems));
+		}
+
+		ReleaseToPool(*Pool, WorldItem);
+	}
+}
+
+
+void UInventoryWorldItemPool::ReleaseOrDestroy(AActor* WorldItem)
+{
+	if (!WorldItem || !WorldItem->HasAuthority()) return;
+
+	AItemBase* PooledItem = Cast<AItemBase>(WorldItem);
+	UInventoryWorldItemPool* Pool = WorldItem->GetWorld() ? WorldItem->GetWorld()->GetSubsystem<UInventoryWorldItemPool>() : nullptr;
+	if (PooledItem && Pool) Pool->ReleaseWorldItem(PooledItem);
+	else WorldItem->Destroy();
+}
+
+
+void UInventoryWorldItemPool::ReleaseOrDestroy(const TConstArrayView<AActor*> WorldItems)
+{
+	if (WorldItems.IsEmpty()) return;
+
+	UWorld* World = WorldItems[0] ? WorldItems[0]->GetWorld() : nullptr;
+	UInventoryWorldItemPool* Pool = World ? World->GetSubsystem<UInventoryWorldItemPool>() : nullptr;
+	TArray<AItemBase*> PooledItems;
+	PooledItems.Reserve(WorldItems.Num());
+	for (AActor* WorldItem : WorldItems)
+	{
+		if (!WorldItem || !WorldItem->HasAuthority()) continue;
+
+		AItemBase* PooledItem = Cast<AItemBase>(WorldItem);
+		if (PooledItem && Pool) PooledItems.Add(PooledItem);
+		else WorldItem->Destroy();
+	}
+
+	if (Pool) Pool->ReleaseWorldItems(PooledItems);
+}
+
+
+void UInventoryWorldItemPool::PrewarmPool(const TSubclassOf<AItemBase> WorldClass, const int32 NumItems)
+{
+	if (!WorldClass || !GetWorld()) return;
+
+	FInventoryWorldItemClassPool& Pool = Pools.FindOrAdd(WorldClass);
+	const int32 Target = FMath::Min(NumItems, MaxFreeItems);
+	Pool.FreeItems.Reserve(Target);
+	while (Pool.FreeItems.Num() < Target)
+	{
+		AItemBase* WorldItem = SpawnWorldItem(WorldClass, FTransform::Identity, nullptr);
+		if (!WorldItem) break;
+
+		WorldItem->bSpawnedByPool = true;
+		WorldItem->OnReleasedToPool();
+		Pool.FreeItems.Add(WorldItem);
+		Pool.Stats.NumSpawned++;
+	}
+}
+
+
+FInventoryWorldItemPoolStats UInventoryWorldItemPool::GetPoolStats(const TSubclassOf<AItemBase> WorldClass) const
+{
+	const FInventoryWorldItemClassPool* Pool = Pools.Find(WorldClass.Get());
+	return Pool ? Pool->Stats : FInventoryWorldItemPoolStats();
+}
+
+
+void UInventoryWorldItemPool::ListPoolStats() const
+{
+	UE_LOGFMT(InventoryLog, Log, "//----------------------------------------------------------------------------------------------------------------------------//");
+	UE_LOGFMT(InventoryLog, Log, "// World item pools ({0}) ", Pools.Num());
+	for (const TPair<TObjectPtr<UClass>, FInventoryWorldItemClassPool>& Pool : Pools)
+	{
+		const FInventoryWorldItemPoolStats& Stats = Pool.Value.Stats;
+		UE_LOGFMT(InventoryLog, Log, "| {0}: free: {1}, in use: {2} (peak {3}), spawned: {4}, reused: {5}, released: {6}, destroyed: {7}",
+			*GetNameSafe(Pool.Key), Pool.Value.FreeItems.Num(), Stats.NumInUse, Stats.PeakInUse, Stats.NumSpawned, Stats.NumReused, Stats.NumReleased, Stats.NumDestroyed
+		);
+	}
+	UE_LOGFMT(InventoryLog, Log, "//----------------------------------------------------------------------------------------------------------------------------//");
+}
+
+
+bool UInventoryWorldItemPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UInventoryWorldItemPool::ReleaseToPool(FInventoryWorldItemClassPool& Pool, AItemBase* WorldItem)
+{
+	Pool.Stats.NumInUse = FMath::Max(Pool.Stats.NumInUse - 1, 0);
+	if (Pool.FreeItems.Num() >= MaxFreeItems)
+	{
+		Pool.Stats.NumDestroyed++;
+		WorldItem->Destroy();
+		return;
+	}
+
+	WorldItem->OnReleasedToPool();
+	Pool.FreeItems.Add(WorldItem);
+	Pool.Stats.NumReleased++;
+}
+
+
+AItemBase* UInventoryWorldItemPool::SpawnWorldItem(UClass* WorldClass, const FTransform& Transform, AActor* Owner) const
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.Owner = Owner;
+	return GetWorld()->SpawnActor<AItemBase>(WorldClass, Transform, SpawnParameters);
+}
@@ -0,0 +1,371 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item/InventoryWorldItemRegion.h"
+
+#include "InventorySystemSettings.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Item/InventoryItemAssets.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Item/InventoryItemHandleAllocator.h"
+#include "Item/InventoryWorldItemIndex.h"
+#include "Item/InventoryWorldItemManager.h"
+#include "Net/UnrealNetwork.h"
+
+
+//----------------------------------------------------------------------------------//
+// Records																			//
+//----------------------------------------------------------------------------------//
+F_Item FInventoryWorldItemRecord::ResolveItem() const
+{
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const F_Item* Definition = Catalog ? Catalog->GetDefinition(DefinitionId) : nullptr;
+	if (!Definition) return F_Item();
+
+	F_Item Item = *Definition;
+	Item.Id = Id;
+	Item.Quantity = Quantity;
+	return Item;
+}
+
+
+bool FInventoryWorldItemRecord::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FInventoryItemHandle::NetSerializeId(Ar, Id);
+
+	// ItemDefIds aren't the same on every machine, the definition is only sent as it's ItemDefId if the client's catalog has it too
+	UInventoryItemCatalog::NetSerializeItemDefId(Ar, Map, DefinitionId);
+
+	uint32 PackedQuantity = Ar.IsSaving() ? static_cast<uint32>(FMath::Max(Quantity, 0)) : 0;
+	Ar.SerializeIntPacked(PackedQuantity);
+	if (Ar.IsLoading()) Quantity = static_cast<int32>(PackedQuantity);
+
+	bOutSuccess = SerializePackedVector<10, 24>(Location, Ar);
+	Rotation.SerializeCompressedShort(Ar);
+	return true;
+}
+
+
+void FInventoryWorldItemList::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+	if (Region) Region->OnItemsRemoved(RemovedIndices);
+}
+
+
+void FInventoryWorldItemList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+	if (Region) Region->OnItemsAdded(AddedIndices);
+}
+
+
+void FInventoryWorldItemList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+	if (Region) Region->OnItemsChanged(ChangedIndices);
+}
+
+
+void FInventoryWorldItemList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Region) Region->RebuildLookup();
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Region																			//
+//----------------------------------------------------------------------------------//
+AInventoryWorldItemRegion::AInventoryWorldItemRegion(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = false;
+	SetReplicatingMovement(false);
+	SetCanBeDamaged(false);
+
+	// Items on the ground rarely change, and the changes are only a few records
+	NetUpdateFrequency = 2.0f;
+	MinNetUpdateFrequency = 0.5f;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+
+void AInventoryWorldItemRegion::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AInventoryWorldItemRegion, Items);
+}
+
+
+void AInventoryWorldItemRegion::PostInitProperties()
+{
+	Super::PostInitProperties();
+	Items.Region = this;
+
+	const UInventorySystemSettings* Settings = GetDefault<UInventorySystemSettings>();
+	if (Settings) NetCullDistanceSquared = FMath::Square(Settings->WorldItemRegionCullDistance);
+}
+
+
+void AInventoryWorldItemRegion::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients find the regions they've received through the world item manager
+	if (UInventoryWorldItemManager* Manager = GetWorld()->GetSubsystem<UInventoryWorldItemManager>())
+	{
+		Manager->RegisterRegion(this);
+	}
+}
+
+
+void AInventoryWorldItemRegion::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		for (const FInventoryWorldItemRecord& Item : Items.Items)
+		{
+			WorldItemIndex->RemoveLightweightItem(Item.Id);
+		}
+	}
+
+	if (UInventoryWorldItemManager* Manager = GetWorld() ? GetWorld()->GetSubsystem<UInventoryWorldItemManager>() : nullptr)
+	{
+		Manager->UnregisterRegion(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void AInventoryWorldItemRegion::AddItem(const FInventoryWorldItemRecord& Item)
+{
+	if (!HasAuthority() || !Item.Id.IsValid()) return;
+
+	// An older generation of the item's handle can't replace it, and a newer generation is added as a new record
+	const int32* Index = ItemLookup.Find(Item.Id);
+	if (Index && Items.Items[*Index].Id != Item.Id)
+	{
+		const FGuid ExistingId = Items.Items[*Index].Id;
+		if (UInventoryItemHandleAllocator::IsStaleItemId(Item.Id, ExistingId)) return;
+
+		RemoveItem(ExistingId);
+		Index = nullptr;
+	}
+
+	if (Index)
+	{
+		RemoveInstance(Items.Items[*Index]);
+		Items.Items[*Index] = Item;
+		Items.MarkItemDirty(Items.Items[*Index]);
+	}
+	else
+	{
+		const int32 NewIndex = Items.Items.Add(Item);
+		ItemLookup.Add(Item.Id, NewIndex);
+		Items.MarkItemDirty(Items.Items[NewIndex]);
+	}
+
+	AddInstance(Item);
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this)) WorldItemIndex->AddLightweightItem(Item.Id, Item.Location);
+}
+
+
+bool AInventoryWorldItemRegion::RemoveItem(const FGuid& Id)
+{
+	if (!HasAuthority()) return false;
+
+	// Stale handles don't remove the current generation of the item
+	const int32* FoundIndex = ItemLookup.Find(Id);
+	if (!FoundIndex || Items.Items[*FoundIndex].Id != Id) return false;
+	const int32 Index = *FoundIndex;
+	ItemLookup.Remove(Id);
+
+	RemoveInstance(Items.Items[Index]);
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this)) WorldItemIndex->RemoveLightweightItem(Id);
+	Items.Items.RemoveAtSwap(Index, 1, false);
+	if (Items.Items.IsValidIndex(Index)) ItemLookup.Add(Items.Items[Index].Id, Index);
+	Items.MarkArrayDirty();
+	return true;
+}
+
+
+const FInventoryWorldItemRecord* AInventoryWorldItemRegion::FindItem(const FGuid& Id) const
+{
+	const int32* Index = ItemLookup.Find(Id);
+	return Index && Items.Items.IsValidIndex(*Index) && Items.Items[*Index].Id == Id ? &Items.Items[*Index] : nullptr;
+}
+
+
+FGuid AInventoryWorldItemRegion::FindItemFromInstance(const UPrimitiveComponent* Component, const int32 InstanceIndex) const
+{
+	for (const TPair<int32, FInventoryWorldItemMeshInstances>& Mesh : Meshes)
+	{
+		if (Mesh.Value.Mesh == Component)
+		{
+			return Mesh.Value.InstanceIds.IsValidIndex(InstanceIndex) ? Mesh.Value.InstanceIds[InstanceIndex] : FGuid();
+		}
+	}
+
+	return FGuid();
+}
+
+
+
+
+//----------------------------------------------------------------------------------//
+// Rendering																		//
+//----------------------------------------------------------------------------------//
+void AInventoryWorldItemRegion::OnItemsAdded(const TConstArrayView<int32> Indices)
+{
+	UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this);
+	for (const int32 Index : Indices)
+	{
+		if (!Items.Items.IsValidIndex(Index)) continue;
+
+		AddInstance(Items.Items[Index]);
+		if (WorldItemIndex) WorldItemIndex->AddLightweightItem(Items.Items[Index].Id, Items.Items[Index].Location);
+	}
+}
+
+
+void AInventoryWorldItemRegion::OnItemsRemoved(const TConstArrayView<int32> Indices)
+{
+	UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this);
+	for (const int32 Index : Indices)
+	{
+		if (Items.Items.IsValidIndex(Index))
+		{
+			RemoveInstance(Items.Items[Index]);
+			ItemLookup.Remove(Items.Items[Index].Id);
+			if (WorldItemIndex) WorldItemIndex->RemoveLightweightItem(Items.Items[Index].Id);
+		}
+	}
+}
+
+
+void AInventoryWorldItemRegion::OnItemsChanged(const TConstArrayView<int32> Indices)
+{
+	UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this);
+	for (const int32 Index : Indices)
+	{
+		if (!Items.Items.IsValidIndex(Index)) continue;
+
+		// The server only replaces a record with one that has the same id, but it's definition (and so it's mesh) could have changed, so the instance is recreated instead of moved
+		const FInventoryWorldItemRecord& Item = Items.Items[Index];
+		for (TPair<int32, FInventoryWorldItemMeshInstances>& Mesh : Meshes)
+		{
+			const int32 InstanceIndex = Mesh.Value.InstanceIds.Find(Item.Id);
+			if (InstanceIndex != INDEX_NONE)
+			{
+				if (Mesh.Value.Mesh) Mesh.Value.Mesh->RemoveInstance(InstanceIndex);
+				Mesh.Value.InstanceIds.RemoveAt(InstanceIndex, 1, false);
+				break;
+			}
+		}
+
+		AddInstance(Item);
+		if (WorldItemIndex) WorldItemIndex->AddLightweightItem(Item.Id, Item.Location);
+	}
+}
+
+
+void AInventoryWorldItemRegion::RebuildLookup()
+{
+	// Replicated removals happen before the array shrinks, so the lookup is rebuilt once the array's been updated
+	ItemLookup.Reset();
+	ItemLookup.Reserve(Items.Items.Num());
+	for (int32 Index = 0; Index < Items.Items.Num(); Index++)
+	{
+		ItemLookup.Add(Items.Items[Index].Id, Index);
+	}
+}
+
+
+void AInventoryWorldItemRegion::AddInstance(const FInventoryWorldItemRecord& Item)
+{
+	if (!ShouldRenderItems()) return;
+
+	FInventoryWorldItemMeshInstances& Mesh = Meshes.FindOrAdd(Item.DefinitionId);
+	if (Mesh.Mesh)
+	{
+		Mesh.Mesh->AddInstance(Item.GetTransform(), true);
+		Mesh.InstanceIds.Add(Item.Id);
+		return;
+	}
+
+	// The mesh is created once it's loaded, with an instance for every item of this kind that's been added by then
+	const bool bFirstItem = Mesh.InstanceIds.IsEmpty();
+	Mesh.InstanceIds.Add(Item.Id);
+	if (!bFirstItem) return;
+
+	UInventoryItemAssets* ItemAssets = UInventoryItemAssets::Get();
+	if (!ItemAssets) return;
+
+	const int32 DefinitionId = Item.DefinitionId;
+	ItemAssets->RequestItemAssets({DefinitionId}, EInventoryItemAssets::WorldMesh, FStreamableDelegate::CreateWeakLambda(this, [this, DefinitionId]()
+	{
+		RefreshInstances(DefinitionId);
+	}));
+}
+
+
+void AInventoryWorldItemRegion::RemoveInstance(const FInventoryWorldItemRecord& Item)
+{
+	FInventoryWorldItemMeshInstances* Mesh = Meshes.Find(Item.DefinitionId);
+	if (!Mesh) return;
+
+	const int32 InstanceIndex = Mesh->InstanceIds.Find(Item.Id);
+	if (InstanceIndex == INDEX_NONE) return;
+
+	// Removing an instance shifts the ones after it down, the same as the ids
+	if (Mesh->Mesh) Mesh->Mesh->RemoveInstance(InstanceIndex);
+	Mesh->InstanceIds.RemoveAt(InstanceIndex, 1, false);
+}
+
+
+void AInventoryWorldItemRegion::RefreshInstances(const int32 DefinitionId)
+{
+	FInventoryWorldItemMeshInstances* Mesh = Meshes.Find(DefinitionId);
+	const UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	const F_Item* Definition = Catalog ? Catalog->GetDefinition(DefinitionId) : nullptr;
+	UInventoryItemAssets* ItemAssets = UInventoryItemAssets::Get();
+	if (!Mesh || Mesh->Mesh || !Definition || !ItemAssets || Definition->WorldMesh.IsNull()) return;
+
+	UStaticMesh* StaticMesh = Cast<UStaticMesh>(ItemAssets->LoadAssetSynchronous(Definition->WorldMesh.ToSoftObjectPath(), true));
+	if (!StaticMesh) return;
+
+	UInstancedStaticMeshComponent* InstancedMesh = NewObject<UInstancedStaticMeshComponent>(this);
+	InstancedMesh->SetStaticMesh(StaticMesh);
+	InstancedMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	InstancedMesh->SetupAttachment(RootComponent);
+	InstancedMesh->RegisterComponent();
+	Mesh->Mesh = InstancedMesh;
+
+	// Add the instances of the items that are still here (the ids are rebuilt in the same order as the instances)
+	TArray<FGuid> InstanceIds = MoveTemp(Mesh->InstanceIds);
+	Mesh->InstanceIds.Reset();
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(InstanceIds.Num());
+	for (const FGuid& Id : InstanceIds)
+	{
+		if (const FInventoryWorldItemRecord* Item = FindItem(Id))
+		{
+			Transforms.Add(Item->GetTransform());
+			Mesh->InstanceIds.Add(Id);
+		}
+	}
+
+	InstancedMesh->AddInstances(Transforms, false, true);
+}
+
+
+bool AInventoryWorldItemRegion::ShouldRenderItems() const
+{
+	return GetNetMode() != NM_DedicatedServer;
+}
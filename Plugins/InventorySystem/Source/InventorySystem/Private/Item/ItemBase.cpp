@@ -4,6 +4,9 @@
 #include "Item/ItemBase.h"
 
 #include "Inventory/InventoryComponent.h"
+#include "Item/InventoryItemCatalog.h"
+#include "Item/InventoryItemHandleAllocator.h"
+#include "Item/InventoryWorldItemIndex.h"
 #include "Logging/StructuredLog.h"
 #include "Net/UnrealNetwork.h"
 
@@ -25,10 +28,10 @@ AItemBase::AItemBase(const FObjectInitializer& ObjectInitializer) : Super(Object
 	Item.Description = "This world item's values haven't been set yet!";
 	Item.InteractText = "Press E to pickup";
 	Item.ItemType = EItemType::Inv_None;
-	Item.Image = nullptr;
+	Item.Image.Reset();
 
-	Item.ActualClass = nullptr;
-	Item.WorldClass = nullptr;
+	Item.ActualClass.Reset();
+	Item.WorldClass.Reset();
 	Item.GlobalInformation = nullptr;
 }
 
@@ -56,6 +59,13 @@ void AItemBase::BeginPlay()
 	Super::BeginPlay();
 	InitializeItemGlobals();
 
+	// Interaction queries find the item through the world item index instead of overlaps
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		if (!bInPool) WorldItemIndex->AddWorldItem(this, GetActorLocation());
+		if (RootComponent) RootComponent->TransformUpdated.AddUObject(this, &AItemBase::OnItemMoved);
+	}
+
 	// Handle this during spawn
 	// if (ItemInformationTable && !Item.IsValid())
 	// {
@@ -66,11 +76,31 @@ void AItemBase::BeginPlay()
 }
 
 
+void AItemBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		WorldItemIndex->RemoveWorldItem(this);
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void AItemBase::OnItemMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		WorldItemIndex->UpdateWorldItem(this);
+	}
+}
+
+
 void AItemBase::CreateIdIfNull()
 {
 	if (Item.Id == FGuid())
 	{
-		Item.Id = FGuid().NewGuid();
+		Item.Id = UInventoryItemHandleAllocator::AllocateItemId();
 	}
 }
 
@@ -88,27 +118,65 @@ const FGuid AItemBase::GetId_Implementation() const				{ return Item.Id; }
 const FName AItemBase::GetItemName_Implementation() const		{ return Item.ItemName; }
 void AItemBase::SetItem_Implementation(const F_Item Data)		{ Item = Data; }
 void AItemBase::SetId_Implementation(const FGuid& Id)			{ Item.Id = Id; }
-bool AItemBase::IsSafeToAdjustItem_Implementation() const { return PendingPlayer == nullptr; }
-void AItemBase::SetPlayerPending_Implementation(ACharacter* Player) { PendingPlayer = Player; }
-ACharacter* AItemBase::GetPlayerPending_Implementation() { return PendingPlayer; }
+void AItemBase::SetPlayerPending_Implementation(ACharacter* Player)
+{
+	if (Player) CreateIdIfNull();
+	IInventoryItemInterface::SetPlayerPending_Implementation(Player);
+}
 void AItemBase::SetItemInformationDatabase_Implementation(UDataTable* Database) { ItemInformationTable = Database; }
 
 
 bool AItemBase::RetrieveItemFromDataTable(const FName Id, F_Item& ItemData)
 {
-	if (ItemInformationTable)
+	UInventoryItemCatalog* Catalog = UInventoryItemCatalog::Get();
+	if (!Catalog) return false;
+	
+	// The item catalog already has the default database, this just adds this item's database if it's different
+	Catalog->RegisterDatabase(ItemInformationTable);
+	if (const F_Item* Definition = Catalog->FindDefinition(Id))
 	{
-		const FString RowContext(TEXT("Item Information Context"));
-		if (const FInventory_ItemDatabase* Data = ItemInformationTable->FindRow<FInventory_ItemDatabase>(Id, RowContext))
-		{
-			ItemData = Data->ItemInformation;
-			return true;
-		}
-		
-		UE_LOGFMT(InventoryLog, Error, "{0}() {1} Did not find the item {2} to create!", *FString(__FUNCTION__), *GetName(), Id);
+		ItemData = *Definition;
+		return true;
 	}
-
+	
+	UE_LOGFMT(InventoryLog, Error, "{0}() {1} Did not find the item {2} to create!", *FString(__FUNCTION__), *GetName(), Id);
 	return false;
 }
 
+
+void AItemBase::OnAcquiredFromPool(const FTransform& Transform)
+{
+	bInPool = false;
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		WorldItemIndex->AddWorldItem(this, GetActorLocation());
+	}
+
+	// Wake the item up so clients receive it's new location and information
+	SetNetDormancy(DORM_Awake);
+	ForceNetUpdate();
+}
+
+
+void AItemBase::OnReleasedToPool()
+{
+	bInPool = true;
+	Execute_SetPlayerPending(this, nullptr);
+	Item = F_Item();
+	SetOwner(nullptr);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	if (UInventoryWorldItemIndex* WorldItemIndex = UInventoryWorldItemIndex::Get(this))
+	{
+		WorldItemIndex->RemoveWorldItem(this);
+	}
+
+	// Clients receive the hidden state before the item stops replicating
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
 #pragma endregion 
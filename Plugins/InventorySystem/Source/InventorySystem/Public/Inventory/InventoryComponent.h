@@ -5,9 +5,13 @@
 #include "CoreMinimal.h"
 #include "InventoryInformation.h"
 #include "InventoryInterface.h"
+#include "InventoryItemPool.h"
+#include "InventoryItemStore.h"
+#include "InventoryNativeEvents.h"
 #include "Components/ActorComponent.h"
 #include "InventoryComponent.generated.h"
 
+class UInventoryContainerComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(InventoryLog, Log, All);
 
@@ -19,6 +23,7 @@ DECLARE_LOG_CATEGORY_EXTERN(InventoryLog, Log, All);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FInventoryAdditionFailureDelegate, const FGuid&, Id, const FName, DatabaseId, TScriptInterface<IInventoryItemInterface>, SpawnedItem);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryAdditionSuccessDelegate, const F_Item&, ItemData, TScriptInterface<IInventoryItemInterface>, SpawnedItem);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInventoryItemUpdateDelegate, const F_Item&, ItemData);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FInventoryItemTransferFailureDelegate, const FGuid&, Id, const TScriptInterface<IInventoryInterface>, OtherInventory, const bool, bFromThisInventory);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FInventoryItemTransferSuccessDelegate, const FGuid&, Id, const TScriptInterface<IInventoryInterface>, OtherInventory, const bool, bFromThisInventory);
@@ -26,7 +31,11 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FInventoryItemTransferSuccessDele
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryItemRemovalFailureDelegate, const FGuid&, Id, UObject*, SpawnedItem);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryItemRemovalSuccessDelegate, const F_Item&, ItemData, UObject*, SpawnedItem);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInventoryBatchResultDelegate, const F_InventoryBatchResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInventoryTransactionResultDelegate, const F_InventoryTransactionResult&, Result);
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLoadSaveDataInventoryDelegate, bool, bSuccessfullySavedInventory);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLoadSaveDataProgressDelegate, float, Progress);
 
 // TODO: Technically this doesn't account for dedicated servers yet, however there shouldn't be any problems
 
@@ -34,21 +43,34 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLoadSaveDataInventoryDelegate, bo
  * An inventory system for player's for storing and retrieving different inventory items in multiplayer with error handling in a safe and efficient way that even allows for customization, and works out of the box.
  * All you need to do is add the component to the character, and store and retrieve values from it. There's also logic for saving information, just search through the function list in the blueprint.
  *
- * @remarks We use remote procedure calls so replication doesn't have to try and handle everything, and only pass everything with references when we're storing information
+ * The inventory is replicated to the owning client, and only the items that have changed are sent. The server handles every operation, and the client only receives an rpc when an operation fails.
+ * The success delegates are broadcast on both the server and client once the inventory has been updated.
+ *
+ * @remarks Items are replicated with their database id. Items added to the item catalog at runtime (ones that aren't in a registered database) need to be added on the client too (UInventoryItemCatalog::AddDefinition), otherwise the client only has their database id
  */
 UCLASS( Blueprintable, ClassGroup=(Inventory), meta=(BlueprintSpawnableComponent) )
-class INVENTORYSYSTEM_API UInventoryComponent : public UActorComponent, public IInventoryInterface
+class INVENTORYSYSTEM_API UInventoryComponent : public UActorComponent, public IInventoryInterface, public IInventoryItemStoreListener
 {
 	GENERATED_BODY()
+	
+	/** Transactions make their changes with the same internal functions as the inventory's operations */
+	friend class FInventoryTransaction;
+	
+	/** Containers send their contents to the inventories of the players viewing them */
+	friend class UInventoryContainerComponent;
 
 protected:
-	/**** Inventory ****/ // I've divided the inventory into maps for quick retrieval, however you're able to build with arrays and other things if you want to adjust the logic */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> QuestItems;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> CommonItems;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> Weapons;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> Armors;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> Materials;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") TMap<FGuid, F_Item> Notes;
+	/**** Inventory ****/ // Every item is stored in one packed list with a single id lookup, and each section (weapons, armors, etc.) is a list of slots into it. Items only store their id and sort order, and share their database information. Use GetInventoryItems to retrieve a section */
+	UPROPERTY(VisibleAnywhere, Replicated, Category = "Inventory") FInventoryItemStore Inventory;
+	
+	/** The item objects that are used during inventory operations, so they aren't allocated every time. See CreateInventoryObject() */
+	mutable FInventoryItemPool ItemPool;
+	
+	/** The inventory events this component's class overrides in blueprint, the others call the native implementation directly. These are found the first time an event is called */
+	mutable EInventoryNativeEvent OverriddenEvents = EInventoryNativeEvent::None;
+	mutable bool bFoundOverriddenEvents = false;
+	
+	/** The item database. Items are retrieved from the item catalog, this is only needed if it's different from the database in the inventory system settings */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory") UDataTable* ItemDatabase;
 	
 	/**** References and stored information ****/
@@ -69,9 +91,9 @@ protected:
 	
 protected:
 	UInventoryComponent();
+	virtual void PostInitProperties() override;
 	virtual void BeginPlay() override;
-	// Loading / Saving the inventory information should be handled in the player state!
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	
 //----------------------------------------------------------------------------------//
@@ -87,9 +109,9 @@ public:
 	 * Order of operations is TryAddItem:
 	 *		- AddItemPendingClientLogic
 	 *		- Server_TryAddItem -> HandleAddItem
-	 *			- Client_AddItemResponse
-	 *				- HandleItemAdditionFail
-	 *				- HandleItemAdditionSuccess
+	 *			- HandleItemAdditionSuccess
+	 *			- Client_AddItemFailed -> HandleItemAdditionFail
+	 *		- OnInventoryItemAdded (once the item has been replicated)
 	 * 
 	 * @param DatabaseId								The id for this item in the inventory
 	 * @param InventoryItemInterface					The reference to the actor spawned in the world, if there is one (and you want it to be deleted upon completion).
@@ -100,6 +122,14 @@ public:
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
 	virtual bool TryAddItem_Implementation(const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type) override;
+	
+	/**
+	 * Picks up a lightweight world item (UInventoryWorldItemManager). The server turns the item into a world item actor, and then it's added the same way as @ref TryAddItem
+	 * 
+	 * @param Id										The id of the lightweight item (UInventoryWorldItemManager::FindWorldItemFromHit)
+	 * @returns		True if the request was sent to the server
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory") virtual bool TryPickupWorldItem(const FGuid& Id);
 
 	
 protected:
@@ -111,10 +141,19 @@ protected:
 	 * */
 	virtual void AddItemPendingClientLogic_Implementation(const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type) override;
 	
-	/** Handles adding the item on the server, and sends the response to the client */
-	UFUNCTION(Server, Reliable) virtual void Server_TryAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryInterface, const EItemType Type);
-	/** Handles the different scenarios of an AddItem operation */
-	UFUNCTION(Client, Reliable) virtual void Client_AddItemResponse(const bool bSuccess, const FGuid& Id, const FName DatabaseId, UObject* InventoryInterface, const EItemType Type);
+	/** Handles adding the item on the server. The server creates the item's id (unless it's an item in the world), and the item is replicated to the client. The client is only told if the item couldn't be added */
+	UFUNCTION(Server, Reliable) virtual void Server_TryAddItem(const FName DatabaseId, UObject* InventoryInterface, const EItemType Type);
+	/** Lets the client know the item wasn't added to the inventory */
+	UFUNCTION(Client, Reliable) virtual void Client_AddItemFailed(const FGuid& Id, const FName DatabaseId, UObject* InventoryInterface, const EItemType Type);
+	
+	/** Turns a lightweight world item into a world item actor on the server, and adds it to the inventory */
+	UFUNCTION(Server, Reliable) virtual void Server_TryPickupWorldItem(const FGuid& Id);
+
+	/** Sends the client's item catalog hash to the server, so the ItemDefIds both catalogs have in common are replicated without their database id */
+	UFUNCTION(Server, Reliable) virtual void Server_SetItemCatalog(const int32 NumDefinitions, const uint32 CatalogHash);
+
+	/** Adds an item on the server, and makes sure items in the world aren't being adjusted by another player. Used for both single and batch additions */
+	virtual EInventoryOperationResult ServerAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity);
 	
 	/**
 	 * The actual logic that handles adding the item to an inventory component
@@ -123,7 +162,7 @@ protected:
 	 * 
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
-	virtual F_Item HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type) override;
+	virtual F_Item HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity) override;
 	
 	/**
 	 * If the item was not added to the inventory
@@ -136,7 +175,7 @@ protected:
 	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryAdditionFailureDelegate OnInventoryItemAdditionFailure;
 	
 	/**
-	 * If the item was successfully added to the inventory
+	 * If the item was successfully added to the inventory. This is called on the server, and the client is updated once the item has been replicated
 	 * 
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
@@ -144,6 +183,9 @@ protected:
 
 	/** Delegate function for when an item is successfully added to the inventory. Helpful for ui elements to keep track of inventory updates */
 	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryAdditionSuccessDelegate OnInventoryItemAdditionSuccess;
+
+	/** Delegate function for when an item in the inventory is updated. Helpful for ui elements to keep track of inventory updates */
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryItemUpdateDelegate OnInventoryItemUpdated;
 	
 	
 //----------------------------------------------------------------------------------//
@@ -160,6 +202,7 @@ public:
 	 *			- Client_TransferItemResponse
 	 *				- HandleTransferItemFail
 	 *				- HandleTransferItemSuccess
+	 *		- OnInventoryItemAdded/OnInventoryItemRemoved on both inventories (once the items have been replicated)
 	 *
 	 * @note For handling the ui, I'd add delegates on the response functions for update notifications on the player's inventory
 	 * 
@@ -186,29 +229,17 @@ protected:
 	
 	/** Handles transferring the item on the server, and sends the response to the client */
 	UFUNCTION(Server, Reliable) virtual void Server_TryTransferItem(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type);
-	/** Handles the different scenarios of an TransferItem operation */
+	/** Handles the different scenarios of an TransferItem operation. The inventories are updated through replication, this is just for the transfer's delegates */
 	UFUNCTION(Client, Reliable) virtual void Client_TransferItemResponse(const bool bSuccess, const FGuid& Id, const FName DatabaseId, UObject* OtherInventoryInterface, const EItemType Type, const bool bFromThisInventory);
 	
 	/**
-	 * The actual logic that handles transferring the item to the other inventory component
+	 * The actual logic that handles transferring the item to the other inventory component. The item is moved with a transaction (FInventoryTransaction), so it's claimed while it's transferred
 	 * 
 	 * @return True if it was able to transfer the item
 	 * 
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
-	virtual bool HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, bool& bFromThisInventory) override;
-	
-	/**
-	 * Utility function for handling updating the inventory information on other clients during an item transfer
-	 * 
-	 * @param Id										The unique id of the inventory item.
-	 * @param DatabaseId								The id for this item in the inventory
-	 * @param Type										The item type (used for item allocation)
-	 * @param bAddItem									Whether the item is being added or removed from the inventory
-	 * 
-	 * @remarks Client logic doesn't have any problems when invoking the handle logic on the client response functions, it's just problematic when there's multiple Clients (During a transfer)
-	 */
-	UFUNCTION(Client, Reliable) virtual void Client_HandleTransferItemForOtherInventory(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem);
+	virtual bool HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory) override;
 	
 	/**
 	 * If the item was not transferred to the other inventory
@@ -230,21 +261,6 @@ protected:
 	/** Delegate function for when an item is successfully added to the inventory. Helpful for ui elements to keep track of inventory updates */
 	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryItemTransferSuccessDelegate OnInventoryItemTransferSuccess;
 
-
-public:
-	/**
-	 * Utility function for handling updating the inventory information on other clients during an item transfer.
-	 * This should handle the appropriate remote procedure logic so that the other inventory's client information is updated
-	 * 
-	 * @param Id										The unique id of the inventory item.
-	 * @param DatabaseId								The id for this item in the inventory
-	 * @param Type										The item type (used for item allocation)
-	 * @param bAddItem									Whether the item is being added or removed from the inventory
-	 * 
-	 * @remarks Client logic doesn't have any problems when invoking the handle logic on the client response functions, it's just problematic when there's multiple Clients (During a transfer)
-	 */
-	virtual void HandleTransferItemForOtherInventoryClientLogic(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem) override;
-	
 	
 //----------------------------------------------------------------------------------//
 // Remove Item																		//
@@ -257,9 +273,9 @@ public:
 	 * Order of operations is TryRemoveItem ->
 	 *		- RemoveItemPendingClientLogic
 	 *		- Server_TryRemoveItem -> HandleRemoveItem
-	 *			- Client_RemoveItemResponse
-	 *				- HandleRemoveItemFail
-	 *				- HandleRemoveItemSuccess
+	 *			- HandleRemoveItemSuccess
+	 *			- Client_RemoveItemFailed -> HandleRemoveItemFail
+	 *		- OnInventoryItemRemoved (once the removal has been replicated)
 	 * 
 	 * @param Id					The unique id of the inventory item.
 	 * @param Type					The item type (used for item allocation)
@@ -281,10 +297,10 @@ protected:
 	 * */
 	virtual void RemoveItemPendingClientLogic_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem) override;
 	
-	/** Handles removing the item on the server, and sends the response to the client */
+	/** Handles removing the item on the server. The removal is replicated to the client, and the client is only told if the item couldn't be removed */
 	UFUNCTION(Server, Reliable) void Server_TryRemoveItem(const FGuid& Id, const EItemType Type, bool bDropItem);
-	/** Handles the different scenarios of an RemoveItem operation */
-	UFUNCTION(Client, Reliable) void Client_RemoveItemResponse(const bool bSuccess, const FGuid& Id, const FName DatabaseId, const EItemType Type, bool bDropItem, UObject* SpawnedItem);
+	/** Lets the client know the item wasn't removed from the inventory */
+	UFUNCTION(Client, Reliable) void Client_RemoveItemFailed(const FGuid& Id, const EItemType Type, bool bDropItem);
 	
 	/**
 	 * The actual logic that handles removing the item from the inventory component
@@ -292,7 +308,7 @@ protected:
 	 * @note If the item isn't successfully removed then @ref HandleRemoveItemAdditionFail should be called, otherwise @ref HandleRemoveItemAdditionSuccess is called
 	 * @remark Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 * */
-	virtual bool HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem, UObject*& SpawnedItem) override;
+	virtual bool HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const int32 Quantity, bool bDropItem, UObject*& SpawnedItem) override;
 	
 	/**
 	 * If the item was not removed from the inventory
@@ -305,7 +321,7 @@ protected:
 	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryItemRemovalFailureDelegate OnInventoryItemRemovalFailure;
 	
 	/**
-	 * If the item was successfully removed from the inventory
+	 * If the item was successfully removed from the inventory. This is called on the server, and the client is updated once the removal has been replicated
 	 * 
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
@@ -314,6 +330,213 @@ protected:
 	/** Delegate function for when an item is successfully added to the inventory. Helpful for ui elements to keep track of inventory updates */
 	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryItemRemovalSuccessDelegate OnInventoryItemRemovalSuccess;
 	
+	
+//----------------------------------------------------------------------------------//
+// Batch Operations																	//
+//----------------------------------------------------------------------------------//
+public:
+	/**
+	 * Adds multiple items to the inventory with a single request to the server. Each item is handled the same way as @ref TryAddItem, and the server responds once with the result of every item
+	 *
+	 * Order of operations is TryAddItems ->
+	 *		- AddItemsPendingClientLogic
+	 *		- Server_TryAddItems -> HandleAddItems -> HandleAddItem (for each item)
+	 *			- HandleItemsAdditionSuccess
+	 *			- Client_AddItemsResponse -> HandleItemsAdditionFail
+	 *		- OnInventoryItemAdded (for each item once they've been replicated)
+	 * 
+	 * @param Items					The items to add. Each item needs a database id, and optionally the item spawned in the world
+	 * @returns		True if the request was sent to the server
+	 */
+	virtual bool TryAddItems_Implementation(const TArray<F_InventoryOperationItem>& Items) override;
+	
+	/**
+	 * Transfers multiple items between this inventory and another inventory with a single request to the server. Each item is handled the same way as @ref TryTransferItem
+	 *
+	 * Order of operations is TryTransferItems ->
+	 *		- TransferItemsPendingClientLogic
+	 *		- Server_TryTransferItems -> HandleTransferItems (one transaction for every item)
+	 *			- Client_TransferItemsResponse
+	 *				- HandleTransferItemsFail
+	 *				- HandleTransferItemsSuccess
+	 * 
+	 * @param Items					The items to transfer. Only the id and type are needed
+	 * @param OtherInventoryInterface	The reference to the other inventory component
+	 * @returns		True if the request was sent to the server
+	 * @remarks The items are transferred with a single transaction (FInventoryTransaction), so either every item is transferred or none of them are
+	 */
+	virtual bool TryTransferItems_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface) override;
+	
+	/**
+	 * Removes multiple items from the inventory with a single request to the server. Each item is handled the same way as @ref TryRemoveItem
+	 *
+	 * Order of operations is TryRemoveItems ->
+	 *		- RemoveItemsPendingClientLogic
+	 *		- Server_TryRemoveItems -> HandleRemoveItems -> HandleRemoveItem (for each item)
+	 *			- HandleRemoveItemsSuccess
+	 *			- Client_RemoveItemsResponse -> HandleRemoveItemsFail
+	 *		- OnInventoryItemRemoved (for each item once they've been replicated)
+	 * 
+	 * @param Items					The items to remove. Only the id and type are needed
+	 * @param bDropItems			Whether the items should be spawned in the world when removed
+	 * @returns		True if the request was sent to the server
+	 */
+	virtual bool TryRemoveItems_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems) override;
+	
+	/**
+	 * Picks up multiple world items with a single request to the server (looting a boss drop). Every item is claimed before any of them are added, and the server responds once
+	 * 
+	 * @param WorldItems			The items in the world (objects with the inventory item interface)
+	 * @returns		True if the request was sent to the server
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory") virtual bool TryLootItems(const TArray<UObject*>& WorldItems);
+	
+	/**
+	 * Picks up every world item around the character with a single request to the server, including lightweight world items. The server finds the items with the world item index (UInventoryWorldItemIndex)
+	 * 
+	 * Order of operations is TryLootArea ->
+	 *		- Server_TryLootArea -> HandleLootArea -> HandleAddItems
+	 *			- HandleItemsAdditionSuccess
+	 *			- Client_LootAreaResponse -> HandleItemsAdditionFail
+	 *		- OnInventoryItemsAdditionResult
+	 * 
+	 * @param Radius				How far from the character items are picked up. The server limits this to MaxLootRadius
+	 * @returns		True if the request was sent to the server
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory") virtual bool TryLootArea(float Radius);
+	
+	/**
+	 * Trades items between this inventory and another inventory (another player or a container) as a single transaction on the server (FInventoryTransaction).
+	 * Either every item is traded or none of them are, and each inventory component is notified once with @ref OnInventoryTransactionResult
+	 * 
+	 * @param Items					The items this inventory gives. Only the id, type, and quantity are needed
+	 * @param OtherInventoryInterface	The reference to the other inventory
+	 * @param OtherItems			The items the other inventory gives
+	 * @returns		Result_Succeeded if every item was traded, Result_Locked if someone else is using one of the items, and Result_Failed if one of the items isn't in it's inventory
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Inventory")
+	virtual EInventoryOperationResult TradeItems(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface, const TArray<F_InventoryOperationItem>& OtherItems);
+	
+	/**
+	 * Opens a container (UInventoryContainerComponent). The server generates the container's contents if it hasn't been opened yet, and sends them to this player only.
+	 * Any changes to the container are sent to this player until it's closed, and items are moved in and out with @ref TryTransferItem and @ref TryTransferItems
+	 * 
+	 * Order of operations is TryOpenContainer ->
+	 *		- Server_OpenContainer -> AddViewer
+	 *			- Client_ContainerContents -> ReceiveContents
+	 *			- Client_ContainerChanges -> ReceiveChanges (whenever the container changes)
+	 *		- OnContainerUpdated (on the container)
+	 * 
+	 * @param Container				The container
+	 * @returns		True if the request was sent to the server
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Container") virtual bool TryOpenContainer(UInventoryContainerComponent* Container);
+	
+	/** Stops viewing a container. Once every player has closed it the container goes dormant */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Container") virtual bool TryCloseContainer(UInventoryContainerComponent* Container);
+
+
+protected:
+	/** The most items that can be in a single batch operation. Any items past this are ignored by the server */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Operations") int32 MaxBatchSize = 256;
+
+	/** How far from the character the server allows items to be looted with TryLootArea */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Operations", meta = (ClampMin = "0")) float MaxLootRadius = 500.0f;
+
+	/** The id of the last batch that was sent to the server */
+	int32 LastBatchId = 0;
+
+	/** The batches that are waiting for a response from the server */
+	TMap<int32, TArray<F_InventoryOperationItem>> PendingBatches;
+
+	/** Handles adding the items on the server, and sends the result of every item to the client */
+	UFUNCTION(Server, Reliable) virtual void Server_TryAddItems(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items);
+	/** Handles the result of an AddItems operation */
+	UFUNCTION(Client, Reliable) virtual void Client_AddItemsResponse(const int32 BatchId, const TArray<EInventoryOperationResult>& Results);
+	
+	/** Finds the items around the character on the server and adds them, and sends the items and their results to the client */
+	UFUNCTION(Server, Reliable) virtual void Server_TryLootArea(const float Radius);
+	/** Handles the result of a LootArea operation. The client doesn't know which items were looted until the server responds */
+	UFUNCTION(Client, Reliable) virtual void Client_LootAreaResponse(const TArray<F_InventoryOperationItem>& Items, const TArray<EInventoryOperationResult>& Results);
+	
+	/** Handles transferring the items on the server, and sends the result of every item to the client */
+	UFUNCTION(Server, Reliable) virtual void Server_TryTransferItems(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	/** Handles the result of a TransferItems operation */
+	UFUNCTION(Client, Reliable) virtual void Client_TransferItemsResponse(const int32 BatchId, const TArray<EInventoryOperationResult>& Results, const TArray<bool>& FromThisInventory, UObject* OtherInventoryInterface);
+	
+	/** Handles removing the items on the server, and sends the result of every item to the client */
+	UFUNCTION(Server, Reliable) virtual void Server_TryRemoveItems(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	/** Handles the result of a RemoveItems operation */
+	UFUNCTION(Client, Reliable) virtual void Client_RemoveItemsResponse(const int32 BatchId, const TArray<EInventoryOperationResult>& Results, bool bDropItems);
+	
+	/** Sent once to each inventory that was part of a transaction, with everything that was added to it and removed from it */
+	UFUNCTION(Client, Reliable) virtual void Client_TransactionResponse(const F_InventoryTransactionResult& Result);
+	
+	/** Opens and closes a container on the server */
+	UFUNCTION(Server, Reliable) virtual void Server_OpenContainer(UInventoryContainerComponent* Container);
+	UFUNCTION(Server, Reliable) virtual void Server_CloseContainer(UInventoryContainerComponent* Container);
+	
+	/** The contents of a container the player has opened, the changes to it while it's open, and when the player stops viewing it. Only the viewers of a container receive these */
+	UFUNCTION(Client, Reliable) virtual void Client_ContainerContents(UInventoryContainerComponent* Container, const TArray<FInventoryItemInstance>& Contents);
+	UFUNCTION(Client, Reliable) virtual void Client_ContainerChanges(UInventoryContainerComponent* Container, const TArray<FInventoryItemInstance>& Changes, const TArray<FGuid>& Removals);
+	UFUNCTION(Client, Reliable) virtual void Client_ContainerClosed(UInventoryContainerComponent* Container);
+
+	/** Adds every item to the inventory on the server and retrieves the result of each item. Items without an id are given one. Calls @ref HandleItemsAdditionSuccess with the items that were added */
+	virtual void HandleAddItems(TArray<F_InventoryOperationItem>& Items, TArray<EInventoryOperationResult>& OutResults);
+	
+	/** Finds the world items around the character on the server, turning lightweight world items into actors, and adds them to the inventory */
+	virtual void HandleLootArea(float Radius, TArray<F_InventoryOperationItem>& OutItems, TArray<EInventoryOperationResult>& OutResults);
+	
+	/** Transfers every item on the server as a single transaction and retrieves the result of each item. Each item is updated with the inventory it was transferred from */
+	virtual void HandleTransferItems(TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface, TArray<EInventoryOperationResult>& OutResults);
+	
+	/** Removes every item from the inventory on the server and retrieves the result of each item. Calls @ref HandleRemoveItemsSuccess with the items that were removed */
+	virtual void HandleRemoveItems(const TArray<F_InventoryOperationItem>& Items, bool bDropItems, TArray<EInventoryOperationResult>& OutResults);
+
+	/** Handles the result of a batch operation once the server has responded */
+	virtual void HandleAddItemsResult(const F_InventoryBatchResult& Result);
+	virtual void HandleTransferItemsResult(const F_InventoryBatchResult& Result, UObject* OtherInventoryInterface);
+	virtual void HandleRemoveItemsResult(const F_InventoryBatchResult& Result, bool bDropItems);
+	virtual void HandleTransactionResult(const F_InventoryTransactionResult& Result);
+
+	/** Returns who claims the items during a transaction, the character or the actor that has the inventory */
+	UObject* GetTransactionClaimant();
+
+	/** Saves the items of a batch until the server responds. @returns The id of the batch */
+	int32 AddPendingBatch(const TArray<F_InventoryOperationItem>& Items);
+
+	/** The batch hooks call the hooks for each item by default, so anything that's overridden for individual items still applies */
+	virtual void AddItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items) override;
+	virtual void HandleItemsAdditionFail_Implementation(const TArray<F_InventoryOperationItem>& Items) override;
+	virtual void HandleItemsAdditionSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items) override;
+	virtual void TransferItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface) override;
+	virtual void HandleTransferItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface) override;
+	virtual void HandleTransferItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface) override;
+	virtual void RemoveItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems) override;
+	virtual void HandleRemoveItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems) override;
+	virtual void HandleRemoveItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems, const TArray<UObject*>& SpawnedItems) override;
+
+	/** Delegate functions for when the server has responded to a batch operation. Helpful for ui elements to keep track of inventory updates */
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryBatchResultDelegate OnInventoryItemsAdditionResult;
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryBatchResultDelegate OnInventoryItemsTransferResult;
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryBatchResultDelegate OnInventoryItemsRemovalResult;
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Operations") FInventoryTransactionResultDelegate OnInventoryTransactionResult;
+	
+	
+//----------------------------------------------------------------------------------//
+// Replication																		//
+//----------------------------------------------------------------------------------//
+protected:
+	/** Called on the server when an item is added to the inventory, and on the client once it's been replicated. Broadcasts the addition success delegate */
+	virtual void OnInventoryItemAdded(const FInventoryItemInstance& Item) override;
+
+	/** Called on the server when an item is updated, and on the client once it's been replicated. Broadcasts the item update delegate */
+	virtual void OnInventoryItemChanged(const FInventoryItemInstance& Item) override;
+
+	/** Called on the server when an item is removed from the inventory, and on the client once it's been replicated. Broadcasts the removal success delegate */
+	virtual void OnInventoryItemRemoved(const FInventoryItemInstance& Item) override;
+	
+	
 //----------------------------------------------------------------------------------//
 // Saving																			//
 //----------------------------------------------------------------------------------//
@@ -324,8 +547,35 @@ protected:
 	/** The current inventory save data. This isn't updated until the server has sent all it's inventory information */
 	UPROPERTY(BlueprintReadWrite, Transient, Category = "Inventory|Saving") F_InventorySaveInformation CurrentInventorySaveData;
 
-	/** This is a value to store the information that's sent to the client. Once everything has been sent to the client, the current inventory save data is updated with this information */
-	UPROPERTY(BlueprintReadWrite, Transient, Category = "Inventory|Saving") F_InventorySaveInformation ClientInventorySaveData;
+	/**** Client loading ****/ // Saved items reach the client through the inventory's replication, the client is only sent how many items to expect and when the server has finished adding them
+	/** How many items the client is waiting for (client) */
+	int32 NumSavedItems = 0;
+
+	/** Whether the server added every saved item, this is broadcast once the client has received them (client) */
+	bool bClientSaveSucceeded = true;
+
+	/** The next saved item that's going to be added to the inventory, or INDEX_NONE if the save information isn't being added. The save scheduler adds the items over multiple frames */
+	int32 SaveApplicationIndex = INDEX_NONE;
+
+	/** Whether every saved item that's been added so far was added successfully */
+	bool bSaveApplicationSucceeded = true;
+
+	/**** Save journal ****/ // The changes made to the inventory since it was last saved, so saves only need to write what's changed
+	/** The most changes that are tracked between saves. Once there's more than this, the next save is a full snapshot of the inventory instead */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Saving", meta = (ClampMin = "0")) int32 MaxSaveJournalEntries = 512;
+
+	/** The latest change of every item that's changed since the last save, and the index of each item's change */
+	TArray<FS_InventorySaveJournalEntry> SaveJournal;
+	TMap<FGuid, int32> SaveJournalLookup;
+
+	/** The sections that have changed since the last save (one bit for each section) */
+	uint32 DirtySaveSections = 0;
+
+	/** Whether the next save needs to be a full snapshot. This is needed until the inventory has been saved or loaded, and when the journal overflows */
+	bool bNeedsFullSave = true;
+
+	/** The version of the last save. Incremented every time the inventory is saved */
+	int32 SaveVersion = 0;
 	
 	
 public:
@@ -342,21 +592,78 @@ public:
 	/** Delegate function for when they've loaded to the client's save information */
 	UPROPERTY(BlueprintAssignable) FOnLoadSaveDataInventoryDelegate OnLoadSaveData;
 
+	/** Delegate function for when some of the saved items have been received by the client. Helpful for loading screens */
+	UPROPERTY(BlueprintAssignable) FOnLoadSaveDataProgressDelegate OnLoadSaveDataProgress;
+
+	/** Returns how many of the saved items the client has received (0 - 1) */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual float GetSaveDataLoadProgress() const;
+
+	/**
+	 * Adds some of the current save information to the inventory. This is called by the save scheduler once the save information is ready, and broadcasts OnLoadSaveData once every item has been added
+	 * The items are only added on the server, clients receive them through replication
+	 * 
+	 * @param MaxItems					The most saved items that should be added
+	 * 
+	 * @returns How many saved items were added
+	 */
+	virtual int32 ApplySaveInformation(int32 MaxItems);
+
+	/** Returns true if the current save information is still being added to the inventory */
+	bool IsApplyingSaveInformation() const { return SaveApplicationIndex != INDEX_NONE; }
+
+	/**
+	 * Returns the changes made to the inventory since it was last saved, and marks the inventory as saved. 
+	 * If there's been too many changes (or the inventory hasn't been saved yet) this is a full snapshot of the inventory instead. Only valid on the server
+	 * 
+	 * @param bForceFullSnapshot		Save every item in the inventory, even if only a few items have changed
+	 * 
+	 * @returns The save delta. If nothing's changed this is empty, and doesn't need to be saved
+	 * @note If the save fails to be written, call MarkInventorySaveDirty() so the next save is a full snapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual F_InventorySaveDelta GetInventorySaveDelta(bool bForceFullSnapshot = false);
+
+	/** Forgets the changes since the last save, and makes the next save a full snapshot of the inventory */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual void MarkInventorySaveDirty();
+
+	/** Returns true if the inventory has changed since it was last saved. Use this to skip saving inventories that haven't changed */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual bool HasUnsavedChanges() const;
+
+	/** Returns true if a section of the inventory has changed since it was last saved */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual bool IsSaveSectionDirty(EItemType Type) const;
+
+	/**
+	 * Adds a save delta to a previous save
+	 * 
+	 * @param SaveInformation			The previous save information. This is updated with the changes
+	 * @param SaveDelta					The changes to the inventory since the previous save
+	 * 
+	 * @returns false if the delta wasn't created from this save's version. The previous save is left untouched, and a full snapshot needs to be saved instead
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") static bool ApplyInventorySaveDelta(UPARAM(ref) F_InventorySaveInformation& SaveInformation, const F_InventorySaveDelta& SaveDelta);
+
 	
 protected:
-	/** Start sending saved inventory information to the client */
-	UFUNCTION(Client, Reliable) virtual void Client_BeginLoadingInventoryData();
-	
-	/** Sends some of the current save's inventory information to the client
-	 * @note this is done in multiple calls to avoid network issues (RPC's default data limits are 64kb)
+	/**
+	 * Lets the client know the server is loading it's save information. The items themselves are replicated with the inventory
+	 * 
+	 * @param NumItems					How many items are in the save information
 	 */
-	UFUNCTION(Client, Reliable) virtual void Client_LoadSomeInventoryData(const TArray<FS_Item>& Items);
+	UFUNCTION(Client, Reliable) virtual void Client_BeginLoadingInventoryData(const int32 NumItems);
 
-	/** Sets the current save data to the captured client information. Called once all the client information has been sent */
-	UFUNCTION(Client, Reliable) virtual void Client_LoadSaveDataCompleted();
+	/**
+	 * Lets the client know every saved item has been added on the server. OnLoadSaveData is broadcast once the client has received them
+	 * 
+	 * @param bSucceeded				Whether every saved item was added
+	 * @param NumItems					How many items the inventory has now
+	 */
+	UFUNCTION(Client, Reliable) virtual void Client_LoadSaveDataCompleted(const bool bSucceeded, const int32 NumItems);
+
+	/** Broadcasts OnLoadSaveData on the client once every saved item has been replicated */
+	virtual void FinishLoadingSaveData();
 
 	/**
-	 * Updates the inventory information with the player state's current save data. This is called in UpdateInventoryAfterRetrievingSaveInformation() during play based on the SaveState of the inventory
+	 * Updates the inventory information with save data all at once. Saved information that's loaded with LoadInventoryInformation() is scheduled and added with ApplySaveInformation() instead
+	 * The items are only added on the server, clients receive them through replication
 	 * 
 	 * @param SaveInformation			The save information object containing the player's inventory information
 	 * 
@@ -364,12 +671,33 @@ protected:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual bool UpdateInventoryInformation(const F_InventorySaveInformation& SaveInformation);
 	
-	/** Function for handling the save state information once a player loads the inventory information. Updates the inventory if they retrieved new save information */
+	/**
+	 * Adds some of the saved items to the inventory. Items that are in the item catalog are all found at once, and the others are added from the item database
+	 * 
+	 * @param Items						The saved items
+	 * @param StartIndex				The first saved item that's added
+	 * @param NumItems					How many saved items are added
+	 * @param SavedItemDefIds			The ItemDefId of every saved item, if they were loaded with the save. Empty if the items need to be found in the catalog
+	 * 
+	 * @returns true if every item was successfully added
+	 */
+	virtual bool AddSavedItems(const TArray<FS_Item>& Items, int32 StartIndex, int32 NumItems, TConstArrayView<int32> SavedItemDefIds = TConstArrayView<int32>());
+	
+	/** Function for handling the save state information once a player loads the inventory information. Schedules adding the save information if they retrieved new save information */
 	UFUNCTION(Category = "Inventory|Saving and Loading") virtual void UpdateInventoryAfterRetrievingSaveInformation();
 	
 	/** Create a save item from an inventory item */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual FS_Item CreateSavedItem(const F_Item& Item) const;
 
+	/** Creates the save item of an item in the inventory. Every save (and the save journal) uses this, override it to customize the saved information */
+	virtual FS_Item CreateSavedItemFromInstance(const FInventoryItemInstance& Item) const;
+
+	/** Adds a change to the save journal, replacing any previous change to the same item. Called on the server whenever an item is edited */
+	virtual void RecordSaveJournalEntry(EInventorySaveOperation Operation, const FInventoryItemInstance& Item);
+
+	/** Clears the changes since the last save */
+	virtual void ResetSaveJournal();
+
 	
 	
 //----------------------------------------------------------------------------------//
@@ -397,10 +725,24 @@ public:
 	 * 
 	 * @remark these are only used for specific cases where there isn't a traditional way of editing the inventory (Server side logic between two inventory component interfaces)
 	 */
-	virtual void InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None) override;
+	virtual void InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None, int32 Quantity = 0) override;
 	
 	
 public:
+	/** Returns the number of items with this database id in the inventory */
+	UFUNCTION(BlueprintPure, Category = "Inventory") int32 GetItemCount(FName DatabaseId) const;
+
+	/** Returns the ids of every item with this database id in the inventory */
+	UFUNCTION(BlueprintCallable, Category = "Inventory") TArray<FGuid> GetItemIdsWithDatabaseId(FName DatabaseId) const;
+
+	/**
+	 * Checks the inventory for multiple items at once, like the ingredients of a recipe or the items a quest requires
+	 * 
+	 * @param Requirements				The database id of each item, and how many of them are needed
+	 * @returns True if the inventory has enough of every item
+	 */
+	UFUNCTION(BlueprintPure, Category = "Inventory") bool HasItems(const TMap<FName, int32>& Requirements) const;
+	
 	/** Returns the Item Id from a specific item in the inventory  */
 	UFUNCTION() virtual FName GetItemId(const FGuid& Id, EItemType Type, UObject* OtherInventory = nullptr);
 	
@@ -410,13 +752,37 @@ public:
 	/** Finds the NetId and Platform Id of the player, and sets those values */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Utilities") virtual void SetPlayerId();
 	
+	/** Returns true if this component's class overrides one of the inventory events in blueprint */
+	bool IsEventOverridden(EInventoryNativeEvent Event) const;
+	
 	
 protected:
 	/**
-	 * Returns the inventory list specific to the item's type
-	 * @returns One of the inventory lists from this component
+	 * Calls an inventory event on an inventory. If it's an inventory component that doesn't override the event in blueprint, the native implementation is called directly instead of going through the blueprint event.
+	 * Use these instead of Execute_ for the events in EInventoryNativeEvent, they're called multiple times for every item during inventory operations
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Inventory") virtual TMap<FGuid, F_Item>& GetInventoryList(EItemType InventorySectionToSearch);
+	static bool Call_GetItem(UObject* InventoryObject, F_Item& ReturnedItem, const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None);
+	static F_Item Call_InternalGetInventoryItem(UObject* InventoryObject, const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None);
+	static FGuid Call_InternalAddInventoryItem(UObject* InventoryObject, const F_Item& Item);
+	static void Call_InternalRemoveInventoryItem(UObject* InventoryObject, const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None, int32 Quantity = 0);
+	static bool Call_GetDataBaseItem(UObject* InventoryObject, FName Id, F_Item& Item);
+	static F_Item Call_HandleAddItem(UObject* InventoryObject, const FGuid& Id, FName DatabaseId, UObject* InventoryItemInterface, EItemType Type, int32 Quantity);
+	static bool Call_HandleTransferItem(UObject* InventoryObject, const FGuid& Id, UObject* OtherInventoryInterface, EItemType Type, int32 Quantity, bool& bFromThisInventory);
+	static bool Call_HandleRemoveItem(UObject* InventoryObject, const FGuid& Id, EItemType Type, int32 Quantity, bool bDropItem, UObject*& SpawnedItem);
+	
+	/** Returns true if the item is in the inventory. Inventory components only check their lookup, without creating the item's information */
+	static bool Call_ContainsItem(UObject* InventoryObject, const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None);
+
+	/** Returns the inventory component if it calls the native implementation of an event, otherwise the event should be called with Execute_ */
+	static UInventoryComponent* GetNativeInventory(UObject* InventoryObject, EInventoryNativeEvent Event);
+	
+	
+protected:
+	/**
+	 * Returns a copy of every item in one of the inventory's sections
+	 * @returns The items specific to the item's type
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory") virtual TArray<F_Item> GetInventoryItems(EItemType InventorySectionToSearch) const;
 
 	/**
 	 * Returns an item from one of the lists in this component.
@@ -430,14 +796,47 @@ protected:
 	 *  @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
 	virtual bool GetDataBaseItem_Implementation(FName Id, F_Item& Item) override;
+
+	/**
+	 * Adds an item to the inventory from it's database id. The item only references it's definition in the item catalog, the database information isn't copied
+	 * 
+	 * @returns True if the item was found in the database and added to the inventory
+	 */
+	virtual bool AddItemFromDatabase(const FGuid& Id, FName DatabaseId, int32 SortOrder = -1, int32 Quantity = 1);
+
+	/** Returns the ItemDefId of an item in the catalog, and adds it to the catalog if it isn't there already (using GetDataBaseItem) */
+	virtual int32 ResolveItemDefId(FName DatabaseId);
+
+	/**
+	 * Adds items to the inventory, filling the stacks of the same item that have room before adding new stacks. Items are split into multiple stacks if there's more than the max stack size
+	 * 
+	 * @param Id						The id of the first new stack. Other stacks are given a new id
+	 * @param DefinitionId				The ItemDefId of the item in the catalog
+	 * @param Quantity					How many of the item to add
+	 * @param SortOrder					The sort order of the new stacks
+	 * @returns The id of the last stack the items were added to, or an invalid id if nothing was added
+	 */
+	virtual FGuid AddStackedItem(const FGuid& Id, int32 DefinitionId, int32 Quantity, int32 SortOrder = -1);
 	
 	/**
-	 * Creates the inventory item object for adding things to the inventory.
-	 * If you want to subclass the inventory object, use this function
+	 * Adds an item to the inventory, adding it's definition to the catalog if it isn't there already. This is the native logic of InternalAddInventoryItem()
+	 * @returns The id of the last stack the item was added to, or an invalid id if nothing was added
+	 */
+	FGuid AddInventoryItem(const F_Item& Item);
+	
+	/**
+	 * Allocates an inventory item object. This is only called when every item in the inventory's item pool is in use.
+	 * If you want to subclass the inventory object, use this function (and ResetInventoryObject)
 	 * 
-	 * @remarks If you want to subclass the Item object, use this function. And if you create any Items, do it with this function
+	 * @remarks If you want to subclass the Item object, use this function. And if you need an Item, retrieve it with AcquireInventoryObject()
 	 */
 	virtual F_Item* CreateInventoryObject() const override;
+
+	/** Retrieves an inventory item object from the item pool. It's returned to the pool once it goes out of scope */
+	FInventoryItemPool::FPooledItem AcquireInventoryObject() const { return ItemPool.Acquire(); }
+
+	/** The number of inventory item objects this inventory has allocated. This shouldn't change once the inventory has been used for a bit */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Debugging") int32 GetInventoryObjectAllocations() const { return ItemPool.GetNumAllocations(); }
 	
 	/** Access the save state on the client to know when to update the character information */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual ESaveState GetSaveState();
@@ -463,7 +862,7 @@ protected:
 	/** Listing inventory information -> @ref ListInventory, ListSavedCharacterInformation  */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Utilities|Listing") virtual void ListInventory();
 	UFUNCTION(Server, Reliable, Category = "Inventory|Utilities|Listing") virtual void Server_ListInventory(const TArray<FS_Item>& ClientItemList, bool bCalledFromServer);
-	UFUNCTION(Category = "Inventory|Utilities|Listing") virtual void ListInventoryMap(const TMap<FGuid, F_Item>& Map, FString ListName);
+	UFUNCTION(Category = "Inventory|Utilities|Listing") virtual void ListInventorySection(EItemType Section, FString ListName);
 	UFUNCTION(Category = "Inventory|Utilities|Listing") virtual void ListInventoryItem(const F_Item& Item);
 
 	UFUNCTION(Category = "Inventory|Utilities|Listing") virtual void ListSavedItem(const FS_Item& SavedItem);
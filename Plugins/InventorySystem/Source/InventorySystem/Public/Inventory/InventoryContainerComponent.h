@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "InventoryInterface.h"
+#include "InventoryItemStore.h"
+#include "Components/ActorComponent.h"
+#include "InventoryContainerComponent.generated.h"
+
+class UInventoryComponent;
+
+
+/**
+ * An item that can be generated in a container
+ */
+USTRUCT(BlueprintType)
+struct F_InventoryContainerLoot
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The database id of the item */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) FName DatabaseId;
+
+	/** The chance the item is added when the container's contents are generated (0 to 1) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", ClampMax = "1")) float Chance = 1.0f;
+
+	/** How many of the item are added */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1")) int32 MinQuantity = 1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1")) int32 MaxQuantity = 1;
+};
+
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInventoryContainerUpdateDelegate, UInventoryContainerComponent*, Container);
+
+
+
+
+/**
+ * An inventory for chests, corpses, and anything else players can store items in or take items from. Unlike the inventory component this can be added to any actor, and it's meant to be cheap for maps with thousands of them.
+ *
+ * The contents are generated from the loot table the first time the container is opened (on the server), so containers that are never opened never have any items.
+ * The contents aren't replicated with the container. Players open it with their inventory's TryOpenContainer(), and the server sends the contents to that player's inventory, along with any changes while they're viewing it.
+ * Nobody else receives anything, and the container's actor goes dormant once every player has closed it (bDormantWhenClosed).
+ *
+ * Items are moved in and out with the inventory's transfer functions (TryTransferItem, TryTransferItems) using this as the other inventory, and only players that are viewing the container can transfer items.
+ *
+ * @remarks Clients only have the contents while they're viewing the container. Use GetContainerItems() and OnContainerUpdated for the container's widgets
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class INVENTORYSYSTEM_API UInventoryContainerComponent : public UActorComponent, public IInventoryInterface
+{
+	GENERATED_BODY()
+	friend class UInventoryComponent;
+
+protected:
+	/** The items that are generated the first time the container is opened */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Container") TArray<F_InventoryContainerLoot> Loot;
+
+	/** The seed for generating the contents, so every container is the same each time the map is played. Zero generates different contents every time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Container") int32 LootSeed = 0;
+
+	/** How far from the container a player can be while they're viewing it. Players that move further away are removed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Container", meta = (ClampMin = "0")) float MaxViewDistance = 500.0f;
+
+	/** Whether the container's actor goes dormant while nobody is viewing the container. Disable this if the actor has it's own replication that changes while it's closed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory|Container") bool bDormantWhenClosed = true;
+
+	/** Whether anyone is viewing the container, for opening and closing animations */
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Open, Category = "Inventory|Container") bool bOpen = false;
+
+	/** The container's items. These are only on the server once they've been generated, and on clients while they're viewing the container */
+	TArray<FInventoryItemInstance> Items;
+
+	/** Whether the contents have been generated */
+	bool bGenerated = false;
+
+	/** The inventories of the players that are viewing the container (server) */
+	TArray<TWeakObjectPtr<UInventoryComponent>> Viewers;
+
+	/** The items that have changed since the viewers were last updated, and the items that were removed (server) */
+	TArray<FGuid> ChangedItems;
+	TArray<FGuid> RemovedItems;
+
+	FTimerHandle ViewerTimer;
+
+
+public:
+	UInventoryContainerComponent();
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Called on clients when the container's contents are received or updated */
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Container") FInventoryContainerUpdateDelegate OnContainerUpdated;
+
+	/** Called when the container is opened or closed by the first or last player */
+	UPROPERTY(BlueprintAssignable, Category = "Inventory|Container") FInventoryContainerUpdateDelegate OnContainerOpenChanged;
+
+	/** Returns the items in the container. On clients this is only valid while the container is being viewed */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Container") TArray<F_Item> GetContainerItems() const;
+
+	/** Returns true if anyone is viewing the container */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Container") bool IsOpen() const { return bOpen; }
+
+	/** Returns true if the player's inventory is viewing the container (server) */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Container") bool IsViewer(const UInventoryComponent* Inventory) const;
+
+	/**
+	 * Adds a player as a viewer, generating the contents if this is the first time the container's been opened, and sends them the contents (server).
+	 * Use the inventory's TryOpenContainer() instead of calling this directly
+	 * @returns True if the player can view the container
+	 */
+	virtual bool AddViewer(UInventoryComponent* Inventory);
+
+	/** Removes a player from the viewers. The container goes dormant once nobody is viewing it (server) */
+	virtual void RemoveViewer(UInventoryComponent* Inventory);
+
+	/** Replaces the contents with what the server sent (client) */
+	virtual void ReceiveContents(const TArray<FInventoryItemInstance>& Contents);
+
+	/** Adds the changes the server sent to the contents (client) */
+	virtual void ReceiveChanges(const TArray<FInventoryItemInstance>& Changes, const TArray<FGuid>& Removals);
+
+	/** Clears the contents once the player has stopped viewing the container (client) */
+	virtual void ClearContents();
+
+
+protected:
+	/**
+	 * Generates the contents from the loot table. Override this for your own loot logic, the items are added with InternalAddInventoryItem()
+	 * @remarks This is only called once, the first time the container is opened
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Inventory|Container") void GenerateContents();
+	virtual void GenerateContents_Implementation();
+
+	/** Sends the changes to the viewers. The changes are sent once at the end of the frame, so transferring multiple items only sends one update */
+	virtual void SendChanges();
+
+	/** Removes the viewers that have left, or moved too far away from the container */
+	virtual void UpdateViewers();
+
+	/** Sets whether the container is open, and wakes the actor up or lets it go dormant */
+	void SetOpen(bool bIsOpen);
+
+	/** Marks an item as changed, and schedules an update for the viewers */
+	void MarkItemChanged(const FGuid& Id, bool bRemoved);
+
+	/**
+	 * Adds an item to the container, filling the stacks that have room before adding new stacks. This is the native logic of InternalAddInventoryItem()
+	 * @returns The id of the last stack the item was added to, or an invalid id if nothing was added
+	 */
+	FGuid AddContainerItem(const F_Item& Item);
+
+	/** Returns the index of an item, or INDEX_NONE if it isn't in the container */
+	int32 FindItemIndex(const FGuid& Id) const;
+
+	UFUNCTION() virtual void OnRep_Open();
+
+
+//----------------------------------------------------------------------------------//
+// Inventory Interface																//
+//----------------------------------------------------------------------------------//
+protected:
+	virtual F_Item InternalGetInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None) override;
+	virtual void InternalAddInventoryItem_Implementation(const F_Item& Item) override;
+	virtual void InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None, int32 Quantity = 0) override;
+	virtual bool GetItem_Implementation(F_Item& ReturnedItem, FGuid Id, EItemType InventorySectionToSearch = EItemType::Inv_None) override;
+	virtual bool GetDataBaseItem_Implementation(FName Id, F_Item& Item) override;
+
+	/** Containers don't have a player, this is the name of the container's actor */
+	virtual FString GetPlayerId_Implementation() const override;
+
+
+};
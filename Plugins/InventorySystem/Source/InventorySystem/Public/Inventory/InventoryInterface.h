@@ -42,9 +42,9 @@ public:
 	 * Order of operations is TryAddItem:
 	 *		- AddItemPendingClientLogic
 	 *		- Server_TryAddItem -> HandleAddItem
-	 *			- Client_AddItemResponse
-	 *				- HandleItemAdditionFail
-	 *				- HandleItemAdditionSuccess
+	 *			- HandleItemAdditionSuccess
+	 *			- Client_AddItemFailed -> HandleItemAdditionFail
+	 *		- OnInventoryItemAdded (once the item has been replicated)
 	 * 
 	 * @param DatabaseId								The id for this item in the inventory
 	 * @param InventoryItemInterface					The reference to the actor spawned in the world, if there is one (and you want it to be deleted upon completion).
@@ -71,8 +71,8 @@ protected:
 	virtual void AddItemPendingClientLogic_Implementation(const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
 	
 	/** Server/Client procedure calls are not valid on interfaces, these need to be handled in the actual implementation */
-	// UFUNCTION(Server, Reliable) void Server_TryAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
-	// UFUNCTION(Client, Reliable) void Client_AddItemResponse(const bool bSuccess, const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
+	// UFUNCTION(Server, Reliable) void Server_TryAddItem(const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
+	// UFUNCTION(Client, Reliable) void Client_AddItemFailed(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
 	
 	/**
 	 * The actual logic that handles adding the item to an inventory component
@@ -82,8 +82,8 @@ protected:
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Add Item"))
-	F_Item HandleAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
-	virtual F_Item HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type);
+	F_Item HandleAddItem(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity);
+	virtual F_Item HandleAddItem_Implementation(const FGuid& Id, const FName DatabaseId, UObject* InventoryItemInterface, const EItemType Type, const int32 Quantity);
 	
 	/**
 	 * If the item was not added to the inventory
@@ -157,8 +157,8 @@ protected:
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Transfer Item"))
-	bool HandleTransferItem(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, bool& bFromThisInventory);
-	virtual bool HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, bool& bFromThisInventory);
+	bool HandleTransferItem(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory);
+	virtual bool HandleTransferItem_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, const EItemType Type, const int32 Quantity, bool& bFromThisInventory);
 	
 	/**
 	 * If the item was not transferred to the other inventory
@@ -178,21 +178,6 @@ protected:
 	void HandleTransferItemSuccess(const FGuid& Id, UObject* OtherInventoryInterface, bool bFromThisInventory);
 	virtual void HandleTransferItemSuccess_Implementation(const FGuid& Id, UObject* OtherInventoryInterface, bool bFromThisInventory);
 
-
-public:
-	/**
-	 * Utility function for handling updating the inventory information on other clients during an item transfer.
-	 * This should handle the appropriate remote procedure logic so that the other inventory's client information is updated
-	 * 
-	 * @param Id										The unique id of the inventory item.
-	 * @param DatabaseId								The id for this item in the inventory
-	 * @param Type										The item type (used for item allocation)
-	 * @param bAddItem									Whether the item is being added or removed from the inventory
-	 * 
-	 * @remarks Client logic doesn't have any problems when invoking the handle logic on the client response functions, it's just problematic when there's multiple Clients (During a transfer)
-	 */
-	UFUNCTION() virtual void HandleTransferItemForOtherInventoryClientLogic(const FGuid& Id, const FName DatabaseId, const EItemType Type, const bool bAddItem);
-
 	
 	
 //----------------------------------------------------------------------------------//
@@ -206,9 +191,9 @@ public:
 	 * Order of operations is TryRemoveItem ->
 	 *		- RemoveItemPendingClientLogic
 	 *		- Server_TryRemoveItem -> HandleRemoveItem
-	 *			- Client_RemoveItemResponse
-	 *				- HandleRemoveItemFail
-	 *				- HandleRemoveItemSuccess
+	 *			- HandleRemoveItemSuccess
+	 *			- Client_RemoveItemFailed -> HandleRemoveItemFail
+	 *		- OnInventoryItemRemoved (once the removal has been replicated)
 	 * 
 	 * @param Id					The unique id of the inventory item.
 	 * @param Type					The item type (used for item allocation)
@@ -236,7 +221,7 @@ protected:
 	
 	/** Server/Client procedure calls are not valid on interfaces, these need to be handled in the actual implementation */
 	// UFUNCTION(Server, Reliable) void Server_TryRemoveItem(const FGuid& Id, const EItemType Type, bool bDropItem);
-	// UFUNCTION(Client, Reliable) void Client_RemoveItemResponse(const bool bSuccess, const FGuid& Id, const EItemType Type, bool bDropItem, UObject* SpawnedItem);
+	// UFUNCTION(Client, Reliable) void Client_RemoveItemFailed(const FGuid& Id, const EItemType Type, bool bDropItem);
 	
 	/**
 	 * The actual logic that handles removing the item from the inventory component
@@ -245,8 +230,8 @@ protected:
 	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Remove Item"))
-	bool HandleRemoveItem(const FGuid& Id, const EItemType Type, bool bDropItem, UObject*& SpawnedItem);
-	virtual bool HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem, UObject*& SpawnedItem);
+	bool HandleRemoveItem(const FGuid& Id, const EItemType Type, const int32 Quantity, bool bDropItem, UObject*& SpawnedItem);
+	virtual bool HandleRemoveItem_Implementation(const FGuid& Id, const EItemType Type, const int32 Quantity, bool bDropItem, UObject*& SpawnedItem);
 	
 	/**
 	 * If the item was not removed from the inventory
@@ -267,6 +252,119 @@ protected:
 	virtual void HandleRemoveItemSuccess_Implementation(const FGuid& Id, const EItemType Type, bool bDropItem, UObject* SpawnedItem);
 	
 	
+//----------------------------------------------------------------------------------//
+// Batch Operations																	//
+//----------------------------------------------------------------------------------//
+public:
+	/**
+	 * Adds multiple items to the inventory with a single request to the server. Each item is handled the same way as @ref TryAddItem, and the server responds once with the result of every item
+	 *
+	 * Order of operations is TryAddItems ->
+	 *		- AddItemsPendingClientLogic
+	 *		- Server_TryAddItems -> HandleAddItem (for each item)
+	 *			- HandleItemsAdditionSuccess
+	 *			- Client_AddItemsResponse -> HandleItemsAdditionFail
+	 * 
+	 * @param Items					The items to add. Each item needs a database id, and optionally the item spawned in the world
+	 * @returns		True if the request was sent to the server
+	 * 
+	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory", meta = (DisplayName = "Try Add Items"))
+	bool TryAddItems(const TArray<F_InventoryOperationItem>& Items);
+	virtual bool TryAddItems_Implementation(const TArray<F_InventoryOperationItem>& Items);
+	
+	/**
+	 * Transfers multiple items between this inventory and another inventory with a single request to the server. Each item is handled the same way as @ref TryTransferItem
+	 *
+	 * Order of operations is TryTransferItems ->
+	 *		- TransferItemsPendingClientLogic
+	 *		- Server_TryTransferItems -> HandleTransferItem (for each item)
+	 *			- Client_TransferItemsResponse
+	 *				- HandleTransferItemsFail
+	 *				- HandleTransferItemsSuccess
+	 * 
+	 * @param Items					The items to transfer. Only the id and type are needed
+	 * @param OtherInventoryInterface	The reference to the other inventory component
+	 * @returns		True if the request was sent to the server
+	 * 
+	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory", meta = (DisplayName = "Try Transfer Items"))
+	bool TryTransferItems(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	virtual bool TryTransferItems_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	
+	/**
+	 * Removes multiple items from the inventory with a single request to the server. Each item is handled the same way as @ref TryRemoveItem
+	 *
+	 * Order of operations is TryRemoveItems ->
+	 *		- RemoveItemsPendingClientLogic
+	 *		- Server_TryRemoveItems -> HandleRemoveItem (for each item)
+	 *			- HandleRemoveItemsSuccess
+	 *			- Client_RemoveItemsResponse -> HandleRemoveItemsFail
+	 * 
+	 * @param Items					The items to remove. Only the id and type are needed
+	 * @param bDropItems			Whether the items should be spawned in the world when removed
+	 * @returns		True if the request was sent to the server
+	 * 
+	 * @remarks Blueprints do not need to handle this logic unless they want to override the logic already in place
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory", meta = (DisplayName = "Try Remove Items"))
+	bool TryRemoveItems(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	virtual bool TryRemoveItems_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+
+
+protected:
+	/** Server/Client procedure calls are not valid on interfaces, these need to be handled in the actual implementation */
+	// UFUNCTION(Server, Reliable) void Server_TryAddItems(const int32 BatchId, const TArray<F_InventoryOperationItem>& Items);
+	// UFUNCTION(Client, Reliable) void Client_AddItemsResponse(const int32 BatchId, const TArray<EInventoryOperationResult>& Results);
+	
+	/** What should happen assuming the items are added */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Pending Add Items (Client Logic)"))
+	void AddItemsPendingClientLogic(const TArray<F_InventoryOperationItem>& Items);
+	virtual void AddItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items);
+	
+	/** The items that weren't added to the inventory */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Add Items (Failed)"))
+	void HandleItemsAdditionFail(const TArray<F_InventoryOperationItem>& Items);
+	virtual void HandleItemsAdditionFail_Implementation(const TArray<F_InventoryOperationItem>& Items);
+	
+	/** The items that were successfully added to the inventory. This is called on the server */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Add Items (Succeeded)"))
+	void HandleItemsAdditionSuccess(const TArray<F_InventoryOperationItem>& Items);
+	virtual void HandleItemsAdditionSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items);
+	
+	/** What should happen assuming the items are transferred */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Pending Transfer Items (Client Logic)"))
+	void TransferItemsPendingClientLogic(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	virtual void TransferItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	
+	/** The items that weren't transferred to the other inventory */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Transfer Items (Failed)"))
+	void HandleTransferItemsFail(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	virtual void HandleTransferItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	
+	/** The items that were successfully transferred to the other inventory */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Transfer Items (Succeeded)"))
+	void HandleTransferItemsSuccess(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	virtual void HandleTransferItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, UObject* OtherInventoryInterface);
+	
+	/** What should happen assuming the items are removed */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Pending Remove Items (Client Logic)"))
+	void RemoveItemsPendingClientLogic(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	virtual void RemoveItemsPendingClientLogic_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	
+	/** The items that weren't removed from the inventory */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Remove Items (Failed)"))
+	void HandleRemoveItemsFail(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	virtual void HandleRemoveItemsFail_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems);
+	
+	/** The items that were successfully removed from the inventory, and the items that were spawned in the world (at the same index as their item, or null if it wasn't dropped). This is called on the server */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Inventory|Operations", meta = (DisplayName = "Handle Remove Items (Succeeded)"))
+	void HandleRemoveItemsSuccess(const TArray<F_InventoryOperationItem>& Items, bool bDropItems, const TArray<UObject*>& SpawnedItems);
+	virtual void HandleRemoveItemsSuccess_Implementation(const TArray<F_InventoryOperationItem>& Items, bool bDropItems, const TArray<UObject*>& SpawnedItems);
+	
+	
 //----------------------------------------------------------------------------------//
 // Utility																			//
 //----------------------------------------------------------------------------------//
@@ -297,8 +395,8 @@ public:
 	 * @remark these are only used for specific cases where there isn't a traditional way of editing the inventory (Server side logic between two inventory component interfaces)
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
-	void InternalRemoveInventoryItem(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None);
-	virtual void InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None);
+	void InternalRemoveInventoryItem(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None, int32 Quantity = 0);
+	virtual void InternalRemoveInventoryItem_Implementation(const FGuid& Id, EItemType InventorySectionToSearch = EItemType::Inv_None, int32 Quantity = 0);
 	
 	
 public:
@@ -328,12 +426,15 @@ protected:
 	virtual bool GetDataBaseItem_Implementation(FName Id, F_Item& Item);
 	
 	/**
-	 * Creates the inventory item object for adding things to the inventory.
-	 * If you want to subclass the inventory object, use this function
+	 * Allocates an inventory item object. Inventories reuse their item objects, so this is only called when every item object is already in use.
+	 * If you want to subclass the inventory object, use this function (and ResetInventoryObject)
 	 * 
-	 * @remarks If you want to subclass the Item object, use this function. And if you create any Items, do it with this function
+	 * @remarks Don't call this directly, retrieve items with the inventory's AcquireInventoryObject() instead
 	 */
 	virtual F_Item* CreateInventoryObject() const;
+
+	/** Resets an inventory item object to it's default values once it's done being used, keeping the memory of it's strings (F_Item::Reset()). Override this if you subclass the inventory object */
+	virtual void ResetInventoryObject(F_Item& Item) const;
 	
 	/**
 	 * Spawns an inventory item in the world
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+
+
+/**
+ * Reuses the item objects that are created during inventory operations, so adding, transferring, removing, and retrieving items doesn't allocate a new item every time.
+ * Items are only allocated when every pooled item is in use, and they're reset and returned to the pool once the pooled item goes out of scope.
+ *
+ * Derived item types are supported through the allocate and reset functions (the inventory's CreateInventoryObject() and ResetInventoryObject()).
+ * The number of items each pool has allocated is tracked, once the pool has warmed up this shouldn't change.
+ *
+ * @remarks This should only be used on the game thread
+ */
+class INVENTORYSYSTEM_API FInventoryItemPool
+{
+public:
+	/** An item from the pool. The item is returned to the pool once this goes out of scope */
+	class FPooledItem
+	{
+	public:
+		FPooledItem(FPooledItem&& Other) : Pool(Other.Pool), Item(Other.Item) { Other.Item = nullptr; }
+		FPooledItem(const FPooledItem&) = delete;
+		FPooledItem& operator=(const FPooledItem&) = delete;
+		FPooledItem& operator=(FPooledItem&&) = delete;
+		~FPooledItem() { if (Item) Pool->Release(Item); }
+
+		F_Item& operator*() const { return *Item; }
+		F_Item* operator->() const { return Item; }
+		F_Item* Get() const { return Item; }
+
+	private:
+		friend class FInventoryItemPool;
+		FPooledItem(FInventoryItemPool* Pool, F_Item* Item) : Pool(Pool), Item(Item) {}
+
+		FInventoryItemPool* Pool;
+		F_Item* Item;
+	};
+
+
+public:
+	FInventoryItemPool() = default;
+	FInventoryItemPool(const FInventoryItemPool&) = delete;
+	FInventoryItemPool& operator=(const FInventoryItemPool&) = delete;
+	~FInventoryItemPool();
+
+	/** Sets the functions that allocate new items, and reset items once they're returned to the pool */
+	void SetAllocator(TFunction<F_Item*()>&& InAllocate, TFunction<void(F_Item&)>&& InReset);
+
+	/** Retrieves an item from the pool, and allocates an item if every pooled item is in use. The item always has it's default values */
+	FPooledItem Acquire();
+
+	/** Deletes every item that isn't in use */
+	void Empty();
+
+	/** The number of items this pool has allocated */
+	int32 GetNumAllocations() const { return NumAllocations; }
+
+	/** The number of items every pool has allocated */
+	static int64 GetTotalAllocations() { return TotalAllocations; }
+
+
+protected:
+	/** Resets an item and returns it to the pool */
+	void Release(F_Item* Item);
+
+	/** The most unused items that are kept. There's rarely more than a few items in use at once */
+	static constexpr int32 MaxFreeItems = 8;
+
+	/** The items that aren't in use */
+	TArray<TUniquePtr<F_Item>> FreeItems;
+
+	TFunction<F_Item*()> Allocate;
+	TFunction<void(F_Item&)> Reset;
+
+	int32 NumAllocations = 0;
+	int32 NumInUse = 0;
+	static int64 TotalAllocations;
+
+
+};
@@ -0,0 +1,306 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "Item/InventoryItemHandle.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "InventoryItemStore.generated.h"
+
+
+/**
+ * The information that's unique to an item in the inventory. Everything else (display name, description, classes, etc.) is shared between every item of the same kind, and is stored once in the item catalog.
+ * Use the inventory's GetItem functions to retrieve the full F_Item information for an item.
+ * 
+ * @remarks Don't add object references to this. Items don't reference any objects so the garbage collector doesn't need to go through every item of every inventory, the objects are referenced once by the item's definition
+ */
+USTRUCT(BlueprintType)
+struct FInventoryItemInstance : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+		FInventoryItemInstance(
+			const FGuid& Id = FGuid(),
+			const int32 SortOrder = -1,
+			const int32 DefinitionId = INDEX_NONE,
+			const int32 Quantity = 1
+		) :
+		Id(Id),
+		SortOrder(SortOrder),
+		DefinitionId(DefinitionId),
+		Quantity(Quantity)
+	{}
+
+public:
+	/** The unique id for this item. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FGuid Id;
+
+	/** The sort order for the inventory item. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 SortOrder;
+
+	/** The ItemDefId of this item's shared definition in the item catalog */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 DefinitionId;
+
+	/** How many of this item are in this stack */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 Quantity;
+
+	/** Ids that came from an item handle are sent as 64 bits, the definition is sent as it's database id, and the sort order and quantity are packed */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventoryItemInstance> : public TStructOpsTypeTraitsBase2<FInventoryItemInstance>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+
+
+/**
+ * Receives the changes made to an inventory's items. This is called on the server when items are edited, and on the owning client when the changes are replicated
+ */
+class INVENTORYSYSTEM_API IInventoryItemStoreListener
+{
+public:
+	virtual ~IInventoryItemStoreListener() = default;
+	virtual void OnInventoryItemAdded(const FInventoryItemInstance& Item) = 0;
+	virtual void OnInventoryItemChanged(const FInventoryItemInstance& Item) = 0;
+	virtual void OnInventoryItemRemoved(const FInventoryItemInstance& Item) = 0;
+};
+
+
+
+
+/** The section an item is stored in, it's position in that section's slot list, and it's position in the slot list of it's definition */
+struct FInventorySlotSection
+{
+	int32 Section;
+	int32 Position;
+	int32 DefinitionPosition;
+};
+
+
+/** The slots of the items with a specific definition, and the total quantity of those items */
+struct FInventoryDefinitionSlots
+{
+	TArray<int32> Slots;
+	int32 Quantity = 0;
+};
+
+
+/**
+ * The storage for every item in an inventory. Items are kept in one contiguous array, with a single id lookup and a packed list of slots for each inventory section.
+ *
+ * Adding an item appends it to the end of the array, and removing an item swaps the last item into its slot, so the items are always tightly packed.
+ * Finding an item is a single lookup regardless of the section, and iterating over a section only walks that section's slot list.
+ * There's also a slot list for each definition, so counting or finding the items with a specific database id doesn't search the inventory.
+ * Each item is a stack with a quantity, the stacks of each definition are found with it's slot list.
+ *
+ * Each item only stores it's instance information, and references the definition in the item catalog that's shared with every other item of the same database id.
+ *
+ * The items are delta replicated (only the items that changed are sent). Clients rebuild their lookups once items have been added or removed, and quantity changes are updated in place.
+ * Items should only be added and removed on the server, clients just receive the changes.
+ *
+ * @remarks Slot indices are not stable between edits, don't hold onto them after adding or removing items. Use the item's id instead
+ */
+USTRUCT(BlueprintType)
+struct INVENTORYSYSTEM_API FInventoryItemStore : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+protected:
+	/** Every item in the inventory, tightly packed */
+	UPROPERTY(VisibleAnywhere, Category = "Inventory") TArray<FInventoryItemInstance> Items;
+
+	/** The slot of each item by it's id (keyed by the item's handle) */
+	FInventoryItemIdLookup SlotLookup;
+
+	/** The section of each slot, and the slot's position in that section's list (parallel to Items). Used to remove an item from it's section without searching */
+	TArray<FInventorySlotSection> SlotSections;
+
+	/** The slots of the items for each section of the inventory */
+	TArray<int32> Sections[static_cast<int32>(EItemType::Inv_MAX)];
+
+	/** The slots of the items with each definition (ItemDefId) */
+	TMap<int32, FInventoryDefinitionSlots> DefinitionSlots;
+
+	/** Receives the changes to the items (the inventory that owns this) */
+	IInventoryItemStoreListener* Listener = nullptr;
+
+	/** The replicated changes that are waiting to be sent to the listener once everything has been received */
+	TArray<FInventoryItemInstance> ReplicatedAdditions;
+	TArray<FInventoryItemInstance> ReplicatedChanges;
+	TArray<FInventoryItemInstance> ReplicatedRemovals;
+
+
+public:
+	/**
+	 * Adds an item to the inventory, or replaces the item if there's already an item with the same id
+	 * @returns The slot of the item, or INDEX_NONE if the item or it's definition is invalid
+	 */
+	int32 Add(const FInventoryItemInstance& Item);
+
+	/**
+	 * Adds an item to the inventory using the full item information. The item's definition is added to the catalog if it isn't in the item database
+	 * @returns The slot of the item, or INDEX_NONE if the item is invalid
+	 */
+	int32 Add(const F_Item& Item);
+
+	/**
+	 * Removes an item from the inventory
+	 * @returns True if the item was found and removed
+	 */
+	bool Remove(const FGuid& Id);
+
+	/**
+	 * Sets the quantity of an item's stack. The item is removed if the quantity is zero
+	 * @returns True if the item was found
+	 */
+	bool SetQuantity(const FGuid& Id, int32 Quantity);
+
+	/** Returns the slot of a stack with this definition that has room for more items, or INDEX_NONE if every stack is full */
+	int32 FindStackWithRoom(int32 DefinitionId, int32 MaxStackSize) const;
+
+	/** Returns the item with this id, or nullptr if it isn't in the inventory */
+	const FInventoryItemInstance* Find(const FGuid& Id) const;
+
+	/**
+	 * Retrieves the full information of an item in the inventory
+	 * @returns True if the item was found
+	 */
+	bool GetItem(const FGuid& Id, F_Item& OutItem) const;
+
+	/** Creates the full information of an item from it's instance and definition. This doesn't need the store, so containers use it for their items too */
+	static F_Item ResolveItem(const FInventoryItemInstance& Item);
+
+	/** Returns true if the item is in the inventory */
+	bool Contains(const FGuid& Id) const { return Find(Id) != nullptr; }
+
+	/** Returns the slots of every item in a section of the inventory. These are indices into @ref GetItems */
+	const TArray<int32>& GetSection(EItemType Type) const { return Sections[GetSectionIndex(Type)]; }
+
+	/** Every item in the inventory */
+	const TArray<FInventoryItemInstance>& GetItems() const { return Items; }
+
+	/** Returns the slots of every stack with this definition (ItemDefId). These are indices into @ref GetItems */
+	TConstArrayView<int32> GetDefinitionSlots(const int32 DefinitionId) const
+	{
+		const FInventoryDefinitionSlots* Definition = DefinitionSlots.Find(DefinitionId);
+		return Definition ? TConstArrayView<int32>(Definition->Slots) : TConstArrayView<int32>();
+	}
+
+	/** Returns the total quantity of the items with this definition (ItemDefId), across every stack */
+	int32 GetCount(const int32 DefinitionId) const
+	{
+		const FInventoryDefinitionSlots* Definition = DefinitionSlots.Find(DefinitionId);
+		return Definition ? Definition->Quantity : 0;
+	}
+
+	int32 Num() const { return Items.Num(); }
+	bool IsEmpty() const { return Items.IsEmpty(); }
+
+	/** Allocates enough space for a number of items. Use this before adding a lot of items at once (loading save information) */
+	void Reserve(int32 Number);
+
+	/** Removes every item from the inventory */
+	void Empty();
+
+	/** Sets the object that receives the changes to the items */
+	void SetListener(IInventoryItemStoreListener* InListener) { Listener = InListener; }
+
+	/** Moves every item into the section of it's definition. Clients use this when they receive the information of a definition after it's items (UInventoryItemCatalog::OnPendingDefinitionAdded) */
+	void RefreshSections() { RebuildLookup(); }
+
+	/** Calls the function on every item in a section of the inventory */
+	template<typename FunctionType>
+	void ForEachItemInSection(const EItemType Type, FunctionType&& Function) const
+	{
+		for (const int32 Slot : GetSection(Type))
+		{
+			Function(Items[Slot]);
+		}
+	}
+
+	/** Returns the shared information of an item from the item catalog, or nullptr if the definition doesn't exist */
+	static const F_Item* GetDefinition(int32 DefinitionId);
+
+	/**
+	 * Adds items to an inventory's stacks, filling the stacks of the same item that have room before adding new stacks. The first new stack keeps the item's id, the other stacks are given a new id.
+	 * Every inventory that stacks items (inventory components and containers) uses this, and only provides how it's stacks are found and changed
+	 *
+	 * @param Id						The id of the first new stack
+	 * @param DefinitionId				The ItemDefId of the item in the catalog
+	 * @param Quantity					How many of the item to add
+	 * @param SortOrder					The sort order of the new stacks
+	 * @param FindStackWithRoom			Returns a stack of the item with less than the max stack size, or nullptr if every stack is full
+	 * @param SetQuantity				Sets the quantity of a stack
+	 * @param AddStack					Adds a new stack, and returns false if it couldn't be added
+	 * @param Contains					Returns true if a stack with the id is already in the inventory
+	 * @returns The id of the last stack the items were added to, or an invalid id if nothing was added
+	 */
+	static FGuid AddStacked(const FGuid& Id, int32 DefinitionId, int32 Quantity, int32 SortOrder,
+		TFunctionRef<const FInventoryItemInstance*(int32 MaxStackSize)> FindStackWithRoom,
+		TFunctionRef<void(const FGuid& StackId, int32 StackQuantity)> SetQuantity,
+		TFunctionRef<bool(const FInventoryItemInstance& Stack)> AddStack,
+		TFunctionRef<bool(const FGuid& StackId)> Contains);
+
+	/** Returns true if the items reference any objects, which means the garbage collector has to go through every item of every inventory */
+	static bool ItemsHaveObjectReferences();
+
+	/**
+	 * Returns the section an item type is stored in.
+	 * @note Custom and untyped items are stored with the common items
+	 */
+	static int32 GetSectionIndex(EItemType Type);
+
+
+//----------------------------------------------------------------------------------//
+// Replication																		//
+//----------------------------------------------------------------------------------//
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInventoryItemInstance, FInventoryItemStore>(Items, DeltaParms, *this);
+	}
+
+	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+
+protected:
+	/** Rebuilds the lookup and section lists from the items. Clients use this once they've received the replicated changes */
+	void RebuildLookup();
+
+	/**
+	 * Updates the definition totals of the items that were changed by replication, without rebuilding the lookups
+	 * @returns False if an item's id or definition changed, and the lookups need to be rebuilt
+	 */
+	bool UpdateChangedItems();
+
+	/** Adds a slot to the lookup, it's section, and it's definition's slot list */
+	void AddToLookup(int32 Slot, int32 Section);
+
+	/** Adds a slot to it's definition's slot list */
+	void AddToDefinition(int32 Slot);
+
+	/** Removes a slot from it's definition's slot list, and updates the position of the slot that took it's place */
+	void RemoveFromDefinition(int32 Slot);
+
+
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventoryItemStore> : public TStructOpsTypeTraitsBase2<FInventoryItemStore>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+
+/** The inventory events that are called during inventory operations. Each one is a flag in the events a class overrides */
+enum class EInventoryNativeEvent : uint32
+{
+	None						= 0,
+	GetItem						= 1 << 0,
+	InternalGetInventoryItem	= 1 << 1,
+	InternalAddInventoryItem	= 1 << 2,
+	InternalRemoveInventoryItem	= 1 << 3,
+	GetDataBaseItem				= 1 << 4,
+	HandleAddItem				= 1 << 5,
+	HandleTransferItem			= 1 << 6,
+	HandleRemoveItem			= 1 << 7,
+};
+ENUM_CLASS_FLAGS(EInventoryNativeEvent)
+
+
+/**
+ * Finds which inventory events a class overrides in blueprint, so the inventory can call the native implementation of the others directly instead of going through the blueprint event (Execute_).
+ * Every call through the blueprint event finds the function, copies the parameters into a struct, and calls the native implementation with them, which costs more than most of the inventory's logic.
+ *
+ * The events are only found once for each class. In the editor they're found again once a blueprint has been recompiled.
+ */
+struct INVENTORYSYSTEM_API FInventoryNativeEvents
+{
+	/** Returns the events a class overrides in blueprint */
+	static EInventoryNativeEvent GetOverriddenEvents(const UClass* Class);
+
+	/** Clears the events that have been found for each class */
+	static void ResetOverriddenEvents();
+
+
+private:
+	/** Returns true if the function is a blueprint function instead of the native implementation */
+	static bool IsOverridden(const UClass* Class, FName FunctionName);
+
+	static TMap<TObjectKey<UClass>, EInventoryNativeEvent> OverriddenEvents;
+	static FCriticalSection OverriddenEventsLock;
+
+};
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+
+
+/**
+ * The options for encoding inventory save information
+ */
+struct FInventorySaveFormatOptions
+{
+	/** Compress the save information */
+	bool bCompress = true;
+
+	/** The version of the item catalog the ItemDefIds are from */
+	uint32 CatalogHash = 0;
+
+	/** The ItemDefId of each saved item (in the same order as the items). Optional, this lets loading skip finding the items in the catalog if it hasn't changed */
+	TConstArrayView<int32> ItemDefIds;
+};
+
+
+/**
+ * A compact binary encoding of an inventory's save information, used instead of tagged property serialization.
+ *
+ * Every kind of item that's saved is added to a name table once with it's database id and ItemDefId, and the items are saved as one block of records (FInventoryItemRecord) with their 64 bit handle, name table index, sort order, and quantity.
+ * The records are written and read as memory instead of one item at a time. Items with ids that didn't come from a handle (legacy guids) are rare, their ids are saved after the records.
+ * The database ids are always saved, so saves are still valid if the item catalog changes. The ItemDefIds are only used if the catalog hash is the same when the save is loaded.
+ *
+ * The encoded information is split into compressed blocks, and there's a checksum of everything after the header so corrupted saves aren't loaded.
+ *
+ *	Header:		Magic | Version | Flags | CatalogHash | PayloadSize | NumBlocks | Checksum
+ *	Blocks:		(packed) UncompressedSize | (packed) StoredSize | Data		(a block isn't compressed if compressing it doesn't make it smaller)
+ *	Payload:	NetId | PlatformId | SaveVersion | Name table | Item records | Legacy ids
+ *
+ * @remarks This doesn't use the item catalog, and it's safe to use on any thread
+ */
+struct INVENTORYSYSTEM_API FInventorySaveFormat
+{
+	/** Identifies inventory save information that's in this format ("INVS") */
+	static constexpr uint32 Magic = 0x53564E49;
+
+	/** The versions of the save format. Add a new version whenever the format changes, and keep loading the older versions */
+	enum EVersion : uint16
+	{
+		Version_Initial = 1,
+		Version_ItemHandles,		// Ids that came from an item handle are saved as 64 bits
+		Version_ItemRecords,		// Items are saved as one block of FInventoryItemRecords
+		Version_ItemStacks,			// Item records have a quantity
+		Version_PackedRecordIds,	// Item records save the item's 64 bit handle instead of it's guid, and legacy guids are saved after the records
+
+		Version_Latest_Plus_One,
+		Version_Latest = Version_Latest_Plus_One - 1
+	};
+
+	/** The size of each block of save information before it's compressed */
+	static constexpr int32 BlockSize = 64 * 1024;
+
+	/**
+	 * Encodes the save information
+	 * @returns false if the save information couldn't be encoded
+	 */
+	static bool Write(const F_InventorySaveInformation& SaveInformation, TArray<uint8>& OutData, const FInventorySaveFormatOptions& Options = FInventorySaveFormatOptions());
+
+	/**
+	 * Decodes save information that was encoded with Write()
+	 *
+	 * @param Data						The encoded save information
+	 * @param OutSaveInformation		The decoded save information
+	 * @param CatalogHash				The current item catalog's hash. If it's the same as when the information was saved, the ItemDefIds are also retrieved
+	 * @param OutItemDefIds				The ItemDefId of each saved item, or empty if the catalog has changed (optional)
+	 *
+	 * @returns false if the data isn't in this format, is from a newer version, or is corrupted
+	 */
+	static bool Read(TConstArrayView<uint8> Data, F_InventorySaveInformation& OutSaveInformation, uint32 CatalogHash = 0, TArray<int32>* OutItemDefIds = nullptr);
+
+	/** Returns true if the data is in this format. Anything else is a legacy save game */
+	static bool IsSaveFormat(TConstArrayView<uint8> Data);
+
+
+protected:
+	/** The size of the header */
+	static constexpr int32 HeaderSize = sizeof(uint32) + sizeof(uint16) + sizeof(uint16) + sizeof(uint32) + sizeof(int32) + sizeof(int32) + sizeof(uint32);
+
+	/** The largest save information that's loaded, so corrupted sizes don't allocate everything */
+	static constexpr int32 MaxPayloadSize = 256 * 1024 * 1024;
+
+	enum EFlags : uint16
+	{
+		Flag_Compressed = 1 << 0,
+	};
+
+
+};
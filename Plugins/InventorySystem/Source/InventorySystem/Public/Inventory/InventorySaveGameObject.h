@@ -8,7 +8,7 @@
 #include "InventorySaveGameObject.generated.h"
 
 /**
- * 
+ * The legacy inventory save game. The save pipeline writes inventories in the FInventorySaveFormat, and these are only loaded for saves that were written before it
  */
 UCLASS()
 class INVENTORYSYSTEM_API UInventorySaveGameObject : public USaveGame
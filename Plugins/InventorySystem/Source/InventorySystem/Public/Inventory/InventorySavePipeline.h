@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tasks/Task.h"
+#include "InventorySavePipeline.generated.h"
+
+class UInventoryComponent;
+
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnInventorySaveCompletedDelegate, const FString&, SlotName, bool, bSuccess);
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FOnInventoryLoadCompletedDelegate, const FString&, SlotName, const F_InventorySaveInformation&, SaveInformation, bool, bSuccess);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInventorySavedDelegate, const FString&, SlotName, int32, UserIndex, bool, bSuccess);
+
+
+/**
+ * A save game that's waiting to be written, or is being written on a worker thread
+ */
+struct FInventorySaveRequest
+{
+	FString SlotName;
+	int32 UserIndex = 0;
+
+	/** The captured inventory information. This isn't edited once it's been captured, so it's safe to encode on another thread */
+	TSharedPtr<const F_InventorySaveInformation, ESPMode::ThreadSafe> SaveInformation;
+
+	/** The ItemDefId of each saved item, and the version of the catalog they're from. Saved so loading doesn't need to search the catalog */
+	TArray<int32> ItemDefIds;
+	uint32 CatalogHash = 0;
+
+	/** The inventory that was captured. If the save fails, it's next save is a full snapshot */
+	TWeakObjectPtr<UInventoryComponent> Inventory;
+
+	/** Everything that's waiting on this save, including saves to the same slot that were replaced by this one */
+	TArray<FOnInventorySaveCompletedDelegate> Callbacks;
+
+	/** Roughly how much memory writing this save uses */
+	int64 EstimatedSize = 0;
+
+	/** The id of this save once it's being written, and the task that's writing it (returns whether the save was written) */
+	int32 RequestId = INDEX_NONE;
+	UE::Tasks::TTask<bool> Task;
+};
+
+
+
+
+/**
+ * Writes inventory save games without stalling the game thread. The inventory's information is captured on the game thread (which is cheap), and encoding, compressing,
+ * and writing the save game happens on a worker thread. Completion delegates are called on the game thread once the save has been written.
+ *
+ * Saves are written in the FInventorySaveFormat, and legacy UInventorySaveGameObject save games are still loaded.
+ *
+ * Each save slot has at most one save that's being written and one save that's waiting. If a slot's saved again before it's waiting save has started, the newer
+ * information replaces it and both callers are notified when it's written. The number of saves being written, and roughly how much memory they use, is limited in the inventory system settings.
+ *
+ * @remarks Inventories are only saved on the server (or in standalone games)
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventorySavePipeline : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The saves that are being written, by their slot */
+	TMap<FString, FInventorySaveRequest> InFlightSaves;
+
+	/** The saves that are waiting to be written, by their slot, and the order they were requested in */
+	TMap<FString, FInventorySaveRequest> PendingSaves;
+	TArray<FString> PendingOrder;
+
+	/** Roughly how much memory the saves that are being written are using */
+	int64 InFlightMemory = 0;
+
+	/** The id of the last save that was started */
+	int32 LastRequestId = 0;
+
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Saves an inventory to a save slot. The inventory's information is captured now, and written on a worker thread.
+	 *
+	 * @param Inventory					The inventory that's being saved
+	 * @param SlotName					The save slot
+	 * @param UserIndex					The platform user index
+	 * @param OnCompleted				Called once the save has been written (or failed)
+	 * @param bForce					Save the inventory even if nothing's changed since it was last saved
+	 *
+	 * @returns false if the inventory couldn't be saved. If nothing's changed, this returns true and the callback is called immediately
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading", meta = (AutoCreateRefTerm = "OnCompleted"))
+	virtual bool SaveInventory(UInventoryComponent* Inventory, const FString& SlotName, int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted, bool bForce = false);
+
+	/**
+	 * Saves inventory information to a save slot on a worker thread
+	 * @returns false if the slot name is invalid
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading", meta = (AutoCreateRefTerm = "OnCompleted"))
+	virtual bool SaveInventoryInformation(const F_InventorySaveInformation& SaveInformation, const FString& SlotName, int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted);
+
+	/**
+	 * Loads inventory information from a save slot. The save game is read and decoded on a worker thread (legacy save games are decoded on the game thread).
+	 * If the slot is currently being saved, the information that's being saved is returned instead
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading")
+	virtual void LoadInventoryInformation(const FString& SlotName, int32 UserIndex, const FOnInventoryLoadCompletedDelegate& OnCompleted);
+
+	/** Waits until every save has been written. Used when the game is shutting down */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") virtual void FlushSaves();
+
+	/** Returns true if there's saves being written, or waiting to be written */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Saving and Loading") bool IsSaving() const { return !InFlightSaves.IsEmpty() || !PendingSaves.IsEmpty(); }
+
+	/** Delegate function for when any inventory save has been written (or failed) */
+	UPROPERTY(BlueprintAssignable) FOnInventorySavedDelegate OnInventorySaved;
+
+
+protected:
+	/** Captures the save information for writing it on a worker thread */
+	virtual FInventorySaveRequest CreateSaveRequest(F_InventorySaveInformation&& SaveInformation, const FString& SlotName, int32 UserIndex, const FOnInventorySaveCompletedDelegate& OnCompleted);
+
+	/** Adds a save to the pending saves, replacing the slot's previous pending save if it hasn't started yet */
+	virtual void QueueSave(FInventorySaveRequest&& Request);
+
+	/** Starts writing as many of the pending saves as the settings allow. A slot's pending save waits until it's previous save has been written */
+	virtual void StartPendingSaves(bool bIgnoreLimits = false);
+
+	/** Starts writing a save on a worker thread */
+	virtual void StartSave(const FString& SlotKey, FInventorySaveRequest&& Request);
+
+	/** Handles a save once it's been written. Called on the game thread */
+	virtual void OnSaveCompleted(const FString& SlotKey, int32 RequestId, bool bSuccess);
+
+	/** Returns the key for a save slot */
+	static FString GetSlotKey(const FString& SlotName, int32 UserIndex);
+
+
+};
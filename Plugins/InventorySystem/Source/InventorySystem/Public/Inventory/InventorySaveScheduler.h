@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InventorySaveScheduler.generated.h"
+
+class UInventorySaveScheduler;
+class UInventoryComponent;
+
+
+/**
+ * The tick function for the save scheduler. This only ticks while there's saved information waiting to be added to an inventory
+ */
+USTRUCT()
+struct FInventorySaveSchedulerTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The scheduler that's ticked */
+	UInventorySaveScheduler* Scheduler = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return TEXT("FInventorySaveSchedulerTickFunction"); }
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventorySaveSchedulerTickFunction> : public TStructOpsTypeTraitsBase2<FInventorySaveSchedulerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+
+
+
+/**
+ * Adds saved information to inventories once it's been loaded, instead of every inventory checking it's save state each frame.
+ * Inventories schedule their save information when it's ready, and it's either added immediately or during the tick group in the inventory system settings.
+ *
+ * There's a budget for how many saved items are added each frame across every inventory, so a lot of players joining at once are spread across multiple frames.
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventorySaveScheduler : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The inventories that are waiting to add their save information, in the order they were scheduled */
+	TArray<TWeakObjectPtr<UInventoryComponent>> PendingInventories;
+
+	/** Adds the save information during a specific part of the frame */
+	FInventorySaveSchedulerTickFunction TickFunction;
+
+	/** How many more saved items can be added this frame, and the frame the budget belongs to */
+	int32 RemainingBudget = 0;
+	uint64 BudgetFrame = 0;
+
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Schedules adding an inventory's save information. It's added immediately if there's room in this frame's budget, otherwise it's added over the next frames */
+	virtual void ScheduleSaveApplication(UInventoryComponent* Inventory);
+
+	/** Adds as much of the pending save information as this frame's budget allows */
+	virtual void ProcessPendingInventories();
+
+	/** Returns true if there isn't any save information waiting to be added */
+	bool IsIdle() const { return PendingInventories.IsEmpty(); }
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Refreshes the budget at the start of a new frame, and returns how many saved items can still be added */
+	int32 GetRemainingBudget();
+
+
+};
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+
+
+/**
+ * Stages adds, removes, and moves across any number of inventories (objects with the inventory interface) and applies them as a single step on the server.
+ * Everything is checked before anything is changed, so either every change is made or none of them are (trades between players, swapping items with a container).
+ *
+ * Commit() claims every item that's removed or moved (UInventoryItemClaims), validates every change against what's actually in each inventory, and then applies them.
+ * Each inventory component that's part of the transaction is notified once with everything that was added to it and removed from it (OnInventoryTransactionResult), instead of once per item.
+ *
+ *		FInventoryTransaction Trade;
+ *		Trade.MoveItem(PlayerInventory, OtherPlayerInventory, SwordId);
+ *		Trade.MoveItem(OtherPlayerInventory, PlayerInventory, GoldId, 50);
+ *		Trade.Commit(Player);
+ *
+ * @remarks This should only be used on the server, and only on the game thread. A transaction can only be committed once
+ */
+class INVENTORYSYSTEM_API FInventoryTransaction
+{
+protected:
+	/** A staged change. Adds don't have an inventory they're from, and removes don't have an inventory they're going to */
+	struct FOperation
+	{
+		TWeakObjectPtr<UObject> From;
+		TWeakObjectPtr<UObject> To;
+		FGuid Id;
+		FName DatabaseId;
+		EItemType Type = EItemType::Inv_None;
+		int32 Quantity = 0;
+
+		/** The item that's added to the other inventory, this is set once the transaction has been validated */
+		F_Item Item;
+	};
+
+	TArray<FOperation> Operations;
+
+	/** The result of each change, at the same index as it's operation */
+	TArray<EInventoryOperationResult> Results;
+
+	bool bCommitted = false;
+
+
+public:
+	/** Adds an item from the database to an inventory */
+	void AddItem(UObject* Inventory, FName DatabaseId, int32 Quantity = 1);
+
+	/** Removes an item from an inventory. A quantity of zero removes the whole stack */
+	void RemoveItem(UObject* Inventory, const FGuid& Id, EItemType Type = EItemType::Inv_None, int32 Quantity = 0);
+
+	/** Moves an item from one inventory to another. A quantity of zero moves the whole stack, and moving part of a stack splits it */
+	void MoveItem(UObject* From, UObject* To, const FGuid& Id, EItemType Type = EItemType::Inv_None, int32 Quantity = 0);
+
+	/**
+	 * Checks every change against the inventories without changing anything. Removing more of an item than an inventory has (including items that are removed or moved more than once) fails
+	 * @returns True if every change can be made
+	 */
+	bool Validate();
+
+	/**
+	 * Claims the items, validates every change, and applies them if they're all valid. Every inventory component in the transaction is notified once, whether it was committed or not
+	 *
+	 * @param Claimant					Who is making the changes (usually the player's character). Items claimed by anyone else aren't changed
+	 * @param bNotifyParticipants		Whether the inventory components are notified. Operations with their own responses (transfers) don't need it
+	 * @returns Result_Succeeded if every change was made, Result_Locked if an item is claimed by someone else, Result_Failed if a change wasn't valid, and Result_Invalid if there's nothing to commit
+	 */
+	EInventoryOperationResult Commit(UObject* Claimant = nullptr, bool bNotifyParticipants = true);
+
+	/** Returns every inventory that's part of the transaction */
+	TArray<UObject*> GetParticipants() const;
+
+	/** Returns the result of each change (in the order they were staged) once the transaction has been validated */
+	const TArray<EInventoryOperationResult>& GetResults() const { return Results; }
+
+	int32 Num() const { return Operations.Num(); }
+	bool IsEmpty() const { return Operations.IsEmpty(); }
+	bool IsCommitted() const { return bCommitted; }
+
+
+protected:
+	/**
+	 * Applies every change. Everything's removed before anything's added, so items that are added can't be merged into stacks that are about to be removed.
+	 * Items that couldn't be added to the other inventory are put back in the inventory they were moved from
+	 */
+	void Apply();
+
+	/** Sends each inventory component the items that were added to it and removed from it */
+	void Notify(EInventoryOperationResult Result) const;
+
+	/** Returns the ids of the items that are removed or moved */
+	TArray<FGuid> GetClaimedIds() const;
+
+
+};
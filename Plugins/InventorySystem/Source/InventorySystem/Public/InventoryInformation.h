@@ -10,6 +10,7 @@ class AItemBase;
 class IInventoryItemInterface;
 class UItemGlobals;
 class AItemBase;
+class UStaticMesh;
 
 
 /**
@@ -84,6 +85,47 @@ enum class ESaveState : uint8
 
 
 
+/**
+ *	The result of an item in a batch inventory operation
+ */
+UENUM(BlueprintType)
+enum class EInventoryOperationResult : uint8
+{
+	/** The operation was successful */
+	Result_Succeeded					UMETA(DisplayName = "Succeeded"),
+	
+	/** The item wasn't found, or the operation failed */
+	Result_Failed						UMETA(DisplayName = "Failed"),
+	
+	/** The item is already being adjusted by another player */
+	Result_Locked						UMETA(DisplayName = "Locked"),
+	
+	/** The item wasn't valid, or there were too many items in the batch */
+	Result_Invalid						UMETA(DisplayName = "Invalid"),
+};
+
+
+
+
+/**
+ *	The change that was made to an item since the inventory was last saved
+ */
+UENUM(BlueprintType)
+enum class EInventorySaveOperation : uint8
+{
+	/** The item was added to the inventory */
+	Save_Add							UMETA(DisplayName = "Add"),
+	
+	/** The item was reordered, or it's information was replaced */
+	Save_Update							UMETA(DisplayName = "Update"),
+	
+	/** The item was removed from the inventory */
+	Save_Remove							UMETA(DisplayName = "Remove"),
+};
+
+
+
+
 /**
  *	 Information specific to an item for displaying in the inventory and spawning them in the world
  *	 Also contains the information to access and construct the specific item that the character has created
@@ -100,11 +142,11 @@ struct F_Item
             
 			const FString& Description = "",
 			const FString& InteractText = "",
-			UTexture2D* Image = nullptr,
+			const TSoftObjectPtr<UTexture2D>& Image = nullptr,
 			const EItemType ItemType = EItemType::Inv_None,
 
-			const TSubclassOf<UObject> ActualClass = nullptr,
-			const TSubclassOf<AItemBase> WorldClass = nullptr,
+			const TSoftClassPtr<UObject>& ActualClass = TSoftClassPtr<UObject>(),
+			const TSoftClassPtr<AItemBase>& WorldClass = TSoftClassPtr<AItemBase>(),
 			UDataAsset* GlobalInformation = nullptr
 		) :
 	
@@ -124,6 +166,7 @@ struct F_Item
 	{}
 
 public:
+	/** Inventories can create a subclass of this for their item objects (CreateInventoryObject()), and the item pool deletes them through this type */
 	virtual ~F_Item() {}
 	
 	/** The unique id for this item. */
@@ -141,49 +184,79 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) FString Description;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) FString InteractText;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) EItemType ItemType;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite) UTexture2D* Image;
+	
+	/** The item's image. This isn't loaded until it's needed, use UInventoryItemAssets to load the images of the items you're displaying */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSoftObjectPtr<UTexture2D> Image;
 
 	/**
 	 * The actual class of this item. This could be from a weapon to an activatable item, and it's information is mapped through the item type.
 	 * 
 	 * @remarks This should reference the inventory interface or use the ItemBase class
 	 */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSubclassOf<UObject> ActualClass;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSoftClassPtr<UObject> ActualClass;
 	
 	/**
 	 * The class of this item that's spawned in the world that the character interacts with.
 	 * 
 	 * @remarks This should reference the inventory interface or use the ItemBase class
 	 */	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSubclassOf<AItemBase> WorldClass;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSoftClassPtr<AItemBase> WorldClass;
+	
+	/** The mesh that's drawn for this item when it's dropped as a lightweight world item (UInventoryWorldItemManager). This is cosmetic, and isn't loaded on dedicated servers */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) TSoftObjectPtr<UStaticMesh> WorldMesh;
 	
 	/** Global data for items that's added to the object from the blueprint */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) UDataAsset* GlobalInformation;
 
+	/** How many of this item are in this stack */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1")) int32 Quantity = 1;
+
+	/** The most of this item that can be in one stack. Items with a stack size of one aren't stacked */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1")) int32 MaxStackSize = 1;
+
 	
 	/** Convenience function to access the item type without creating another value */
-	virtual EItemType GetItemType() const
+	EItemType GetItemType() const
 	{
 		return this->ItemType;
 	}
 
 	/** Convenience function to access the id without creating another value */
-	virtual FGuid GetId() const
+	FGuid GetId() const
 	{
 		return this->Id;
 	}
 
 	/** Convenience function to access the database item id without creating another value */
-	virtual FName GetDatabaseId() const 
+	FName GetDatabaseId() const 
 	{
 		return this->ItemName;
 	}
 
 	/** Is this a valid item? */
-	virtual bool IsValid() const
+	bool IsValid() const
 	{
 		return this->Id.IsValid() && this->GetDatabaseId().IsValid();
 	}
+
+	/** Resets the item to it's default values. The strings keep their memory, so pooled items (FInventoryItemPool) don't reallocate them every time they're used */
+	void Reset()
+	{
+		Id = FGuid();
+		SortOrder = -1;
+		ItemName = NAME_None;
+		DisplayName.Reset();
+		Description.Reset();
+		InteractText.Reset();
+		ItemType = EItemType::Inv_None;
+		Image.Reset();
+		ActualClass.Reset();
+		WorldClass.Reset();
+		WorldMesh.Reset();
+		GlobalInformation = nullptr;
+		Quantity = 1;
+		MaxStackSize = 1;
+	}
 };
 
 
@@ -227,6 +300,8 @@ protected:
 
 /**
  * The raw information passed to the server for capturing and saving inventory information
+ * 
+ * @remarks This shouldn't have virtual functions, it's copied a lot while saving. Customize the saved information with the inventory's CreateSavedItemFromInstance() instead
  */
 USTRUCT(BlueprintType)
 struct FS_Item
@@ -235,27 +310,103 @@ struct FS_Item
 		FS_Item(
 			const FGuid& Id = FGuid(),
 			const FName& ItemName = FName(),
-			const int32 SortOrder = -1
+			const int32 SortOrder = -1,
+			const int32 Quantity = 1
 			// Just divide the unique information pertaining to individual things like weapons to their own objects that contain levels and other values, and save that information alongside the inventory information
 		) :
 		Id(Id),
 		ItemName(ItemName),
-		SortOrder(SortOrder)
+		SortOrder(SortOrder),
+		Quantity(Quantity)
 	{}
 
-	virtual bool IsValid() const
+	bool IsValid() const
 	{
 		return !this->ItemName.IsNone();
 	}
 	
 
 public:
-	virtual ~FS_Item() {}
 	UPROPERTY(BlueprintReadWrite) FGuid Id;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) FName ItemName;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) int32 SortOrder;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) int32 Quantity;
+};
+
+
+
+
+/**
+ * The compact record of a saved item, used for writing arrays of items as one block of memory instead of serializing each item.
+ * The id is the item's 64 bit handle (FInventoryItemHandle), ids that didn't come from a handle (legacy guids) have an empty handle and are saved separately.
+ * The definition is an index into a table of database ids that's saved alongside the records (names can't be written as memory), so what it refers to depends on where the records are saved.
+ * 
+ * @remarks Don't add anything to this that isn't trivially copyable
+ */
+struct FInventoryItemRecord
+{
+	FInventoryItemRecord() = default;
+	FInventoryItemRecord(const uint64 Handle, const int32 DefinitionIndex, const int32 SortOrder, const int32 Quantity = 1) :
+		HandleHigh(static_cast<uint32>(Handle >> 32)),
+		HandleLow(static_cast<uint32>(Handle)),
+		DefinitionIndex(DefinitionIndex),
+		SortOrder(SortOrder),
+		Quantity(Quantity)
+	{}
+
+	/** The item's handle, split so the record doesn't need any padding. Zero if the item's id didn't come from a handle */
+	uint32 HandleHigh = 0;
+	uint32 HandleLow = 0;
+	int32 DefinitionIndex = INDEX_NONE;
+	int32 SortOrder = -1;
+	int32 Quantity = 1;
+
+	uint64 GetHandle() const { return (static_cast<uint64>(HandleHigh) << 32) | HandleLow; }
+	bool HasHandle() const { return (HandleHigh | HandleLow) != 0; }
+
+	/** Only used if the records can't be written as memory (byte swapping) */
+	friend FArchive& operator<<(FArchive& Ar, FInventoryItemRecord& Record)
+	{
+		return Ar << Record.HandleHigh << Record.HandleLow << Record.DefinitionIndex << Record.SortOrder << Record.Quantity;
+	}
+
+	/**
+	 * Writes or reads an array of records as one block of memory
+	 * @returns false if there aren't enough bytes left for the number of records that are being read
+	 */
+	static bool SerializeArray(FArchive& Ar, TArray<FInventoryItemRecord>& Records)
+	{
+		uint32 NumRecords = Records.Num();
+		Ar.SerializeIntPacked(NumRecords);
+		if (Ar.IsError()) return false;
+
+		if (Ar.IsLoading())
+		{
+			const int64 RemainingSize = Ar.TotalSize() - Ar.Tell();
+			if (static_cast<int64>(NumRecords) * sizeof(FInventoryItemRecord) > RemainingSize)
+			{
+				Ar.SetError();
+				return false;
+			}
+			Records.SetNumUninitialized(NumRecords);
+		}
+
+		if (Ar.IsByteSwapping())
+		{
+			for (FInventoryItemRecord& Record : Records) Ar << Record;
+		}
+		else
+		{
+			Ar.Serialize(Records.GetData(), static_cast<int64>(NumRecords) * sizeof(FInventoryItemRecord));
+		}
+		return !Ar.IsError();
+	}
 };
 
+static_assert(std::is_trivially_copyable_v<FInventoryItemRecord>, "FInventoryItemRecord is written as memory, it needs to be trivially copyable");
+static_assert(sizeof(FInventoryItemRecord) == 2 * sizeof(uint32) + 3 * sizeof(int32), "FInventoryItemRecord shouldn't have any padding");
+template<> struct TCanBulkSerialize<FInventoryItemRecord> { enum { Value = true }; };
+
 
 
 
@@ -280,13 +431,204 @@ struct F_InventorySaveInformation
 	{}
 
 public:
-	virtual ~F_InventorySaveInformation() {}
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) int32 NetId;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) FString PlatformId;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite) TArray<FS_Item> InventoryItems;
+	
+	/** The save version of the inventory when this was saved. Used to make sure save deltas are only added to the save they were created from */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) int32 SaveVersion = 0;
+
+	/** The ItemDefId of each item, if this was loaded with the same item catalog it was saved with. This isn't saved, and it's only used if it matches the items */
+	TArray<int32> ItemDefIds;
+};
+
+
+
+
+/**
+ * A change that was made to an item since the inventory was last saved. Removed items only need their id
+ */
+USTRUCT(BlueprintType)
+struct FS_InventorySaveJournalEntry
+{
+	GENERATED_USTRUCT_BODY()
+		FS_InventorySaveJournalEntry(
+			const EInventorySaveOperation Operation = EInventorySaveOperation::Save_Add,
+			const FS_Item& Item = FS_Item()
+		) :
+		Operation(Operation),
+		Item(Item)
+	{}
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) EInventorySaveOperation Operation;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) FS_Item Item;
+};
+
+
+
+
+/**
+ * The changes to a character's inventory since it was last saved, or every item if a full snapshot was needed.
+ * Add this to the previous save with UInventoryComponent::ApplyInventorySaveDelta()
+ */
+USTRUCT(BlueprintType)
+struct F_InventorySaveDelta
+{
+	GENERATED_USTRUCT_BODY()
+		F_InventorySaveDelta(
+			const int32 NetId = 0,
+			const FString& PlatformId = FString()
+		) :
+		NetId(NetId),
+		PlatformId(PlatformId),
+		bFullSnapshot(false),
+		BaseVersion(0),
+		Version(0)
+	{}
+
+	/** Returns true if there's nothing that needs to be saved */
+	bool IsEmpty() const
+	{
+		return !bFullSnapshot && Entries.IsEmpty();
+	}
+	
+
+public:
+	UPROPERTY(BlueprintReadOnly) int32 NetId;
+	UPROPERTY(BlueprintReadOnly) FString PlatformId;
+	
+	/** Whether this contains every item in the inventory instead of the changes. This replaces the previous save */
+	UPROPERTY(BlueprintReadOnly) bool bFullSnapshot;
+
+	/** The save version these changes are added to, and the save version once they've been added */
+	UPROPERTY(BlueprintReadOnly) int32 BaseVersion;
+	UPROPERTY(BlueprintReadOnly) int32 Version;
+
+	/** The sections of the inventory that have changed since the last save */
+	UPROPERTY(BlueprintReadOnly) TArray<EItemType> DirtySections;
+
+	/** The changes since the last save, with only the latest change for each item (delta saves) */
+	UPROPERTY(BlueprintReadOnly) TArray<FS_InventorySaveJournalEntry> Entries;
+
+	/** Every item in the inventory (full snapshots) */
+	UPROPERTY(BlueprintReadOnly) TArray<FS_Item> InventoryItems;
+};
+
+
+
+
+/**
+ * An item in a batch inventory operation (adding, transferring, or removing multiple items at once)
+ */
+USTRUCT(BlueprintType)
+struct F_InventoryOperationItem
+{
+	GENERATED_USTRUCT_BODY()
+		F_InventoryOperationItem(
+			const FGuid& Id = FGuid(),
+			const FName DatabaseId = FName(),
+			const EItemType Type = EItemType::Inv_None,
+			UObject* InventoryItemInterface = nullptr,
+			const int32 Quantity = 0
+		) :
+		Id(Id),
+		DatabaseId(DatabaseId),
+		Type(Type),
+		InventoryItemInterface(InventoryItemInterface),
+		Quantity(Quantity),
+		bFromThisInventory(false)
+	{}
+
+public:
+	/** The unique id of the item. Items that are being added are given an id if they don't have one */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) FGuid Id;
+	
+	/** The database id of the item. Only needed when adding items */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) FName DatabaseId;
+	
+	/** The item type (used for item allocation) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) EItemType Type;
+	
+	/** The reference to the item spawned in the world, if there is one (only used when adding items) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite) TObjectPtr<UObject> InventoryItemInterface;
+
+	/**
+	 * How many of the item to add, transfer, or remove. Zero is the whole stack when transferring or removing, and one (or the world item's quantity) when adding.
+	 * Removing or transferring part of a stack splits it, and added items are merged into the stacks that have room
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0")) int32 Quantity;
+	
+	/** For transfers, whether the item was in this inventory. This is set once the server has transferred the item */
+	UPROPERTY(BlueprintReadOnly) bool bFromThisInventory;
+};
+
+
+
+
+/**
+ * The result of a batch inventory operation. Each item has a result at the same index
+ */
+USTRUCT(BlueprintType)
+struct F_InventoryBatchResult
+{
+	GENERATED_USTRUCT_BODY()
+		F_InventoryBatchResult(
+			const TArray<F_InventoryOperationItem>& Items = {},
+			const TArray<EInventoryOperationResult>& Results = {}
+		) :
+		Items(Items),
+		Results(Results)
+	{}
+
+	/** Returns true if the item at this index was successful */
+	bool Succeeded(const int32 Index) const
+	{
+		return Results.IsValidIndex(Index) && EInventoryOperationResult::Result_Succeeded == Results[Index];
+	}
+
+	/** Returns the items that were successful, or the items that failed */
+	TArray<F_InventoryOperationItem> GetItems(const bool bSucceeded) const
+	{
+		TArray<F_InventoryOperationItem> FilteredItems;
+		for (int32 i = 0; i < Items.Num(); i++)
+		{
+			if (Succeeded(i) == bSucceeded) FilteredItems.Add(Items[i]);
+		}
+		return FilteredItems;
+	}
+	
+
+public:
+	UPROPERTY(BlueprintReadOnly) TArray<F_InventoryOperationItem> Items;
+	UPROPERTY(BlueprintReadOnly) TArray<EInventoryOperationResult> Results;
 };
 
 
 
 
+/**
+ * What an inventory transaction (FInventoryTransaction) did to one of the inventories that was part of it. If it wasn't committed these are the changes that would've been made
+ */
+USTRUCT(BlueprintType)
+struct F_InventoryTransactionResult
+{
+	GENERATED_USTRUCT_BODY()
+		F_InventoryTransactionResult(
+			const EInventoryOperationResult Result = EInventoryOperationResult::Result_Failed
+		) :
+		Result(Result)
+	{}
 
+	/** Returns true if the transaction was committed */
+	bool Succeeded() const { return EInventoryOperationResult::Result_Succeeded == Result; }
+	
+
+public:
+	/** The result of the whole transaction */
+	UPROPERTY(BlueprintReadOnly) EInventoryOperationResult Result;
+
+	/** The items that were added to this inventory, and the items that were removed from it */
+	UPROPERTY(BlueprintReadOnly) TArray<F_InventoryOperationItem> AddedItems;
+	UPROPERTY(BlueprintReadOnly) TArray<F_InventoryOperationItem> RemovedItems;
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "Engine/EngineBaseTypes.h"
+#include "InventorySystemSettings.generated.h"
+
+class AItemBase;
+class UDataTable;
+
+
+/**
+ * Project settings for the inventory system (Project Settings -> Plugins -> Inventory System)
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Inventory System"))
+class INVENTORYSYSTEM_API UInventorySystemSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** The database the item catalog is built from when the engine starts. Inventory components with a different database add it to the catalog when they begin play */
+	UPROPERTY(Config, EditAnywhere, Category = "Catalog") TSoftObjectPtr<UDataTable> ItemDatabase;
+
+	/** Add saved inventory information as soon as it's ready if there's room in this frame's budget. Otherwise it's always added during the save application tick group */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving") bool bApplySaveInformationImmediately;
+
+	/** The part of the frame that saved inventory information is added to the inventories, when it can't be added immediately */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving") TEnumAsByte<ETickingGroup> SaveApplicationTickGroup;
+
+	/** The most saved items that are added each frame across every inventory, so a lot of players joining at once doesn't stall the server. Zero adds everything at once */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving", meta = (ClampMin = "0")) int32 SaveItemsPerFrame;
+
+	/** Compress save games before they're written. Uncompressed save games are still loaded */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving") bool bCompressSaveGames;
+
+	/** The most save games that are written at the same time. Other saves wait until one of these has finished */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving", meta = (ClampMin = "1")) int32 MaxConcurrentSaves;
+
+	/** Roughly how much memory the save games that are being written are allowed to use (in megabytes). There's always at least one save being written */
+	UPROPERTY(Config, EditAnywhere, Category = "Saving", meta = (ClampMin = "1")) int32 MaxSaveMemoryInFlight;
+
+	/** The id of this server, used for the item handles it creates. Every server that shares save games needs a different id. The "-InventoryServerId=" command line argument overrides this */
+	UPROPERTY(Config, EditAnywhere, Category = "Items", meta = (ClampMin = "0", ClampMax = "65535")) int32 ItemHandleServerId;
+
+	/** How many item handles are reserved at once. Each reservation is saved, so a larger block writes to disk less often but skips more handles when the server restarts */
+	UPROPERTY(Config, EditAnywhere, Category = "Items", meta = (ClampMin = "1")) int32 ItemHandleBlockSize;
+
+	/** How long a player's claim on an item lasts if it isn't released (in seconds). Claims keep other players from interacting with the same item */
+	UPROPERTY(Config, EditAnywhere, Category = "Items", meta = (ClampMin = "0.1")) float ItemClaimLeaseDuration;
+
+	/** How long a player that lost the race for an item has to claim it once it's released, before the next player in line gets a chance (in seconds) */
+	UPROPERTY(Config, EditAnywhere, Category = "Items", meta = (ClampMin = "0")) float ItemClaimQueueTimeout;
+
+	/** The most item assets (icons and classes) that are kept loaded. The least recently used assets are released once there's more than this */
+	UPROPERTY(Config, EditAnywhere, Category = "Assets", meta = (ClampMin = "1")) int32 MaxResidentItemAssets;
+
+	/** Load cosmetic item assets (icons) on dedicated servers. Servers don't display them, so they aren't loaded by default */
+	UPROPERTY(Config, EditAnywhere, Category = "Assets") bool bLoadCosmeticAssetsOnServer;
+
+	/** The most dropped world items that are kept for reuse for each world class. Items that are picked up once a pool is full are destroyed */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items", meta = (ClampMin = "0")) int32 WorldItemPoolSize;
+
+	/** The world items that are spawned ahead of time when the world begins play (on the server), and how many of each */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items") TMap<TSoftClassPtr<AItemBase>, int32> WorldItemPoolPrewarm;
+
+	/** Drop items as lightweight world items instead of spawning an actor for each one. Items need a world mesh, otherwise they're still spawned as actors */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items") bool bDropLightweightWorldItems;
+
+	/** The width of each region of lightweight world items. Each region is replicated as one actor */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items", meta = (ClampMin = "1000")) float WorldItemRegionSize;
+
+	/** How far from the center of a region players receive it's items. This should be more than the region size, so players near the edge of a region receive the items in the regions next to it */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items", meta = (ClampMin = "0")) float WorldItemRegionCullDistance;
+
+	/** The width of each cell of the world item index, which finds the items around players without physics queries. Use roughly the radius of your interaction queries */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items", meta = (ClampMin = "100")) float WorldItemIndexCellSize;
+
+	/** How long a lightweight world item stays an actor after a player interacts with it, before it's turned back into a lightweight item (in seconds) */
+	UPROPERTY(Config, EditAnywhere, Category = "World Items", meta = (ClampMin = "0")) float PromotedWorldItemLifetime;
+
+
+public:
+	UInventorySystemSettings();
+	virtual FName GetCategoryName() const override { return FName("Plugins"); }
+
+
+};
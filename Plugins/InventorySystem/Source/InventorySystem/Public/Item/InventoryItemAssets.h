@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "InventoryItemAssets.generated.h"
+
+class UTexture2D;
+
+
+/** The assets of an item that can be loaded */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EInventoryItemAssets : uint8
+{
+	None				= 0			UMETA(Hidden),
+
+	/** The item's image. This is cosmetic, and isn't loaded on dedicated servers */
+	Icon				= 1 << 0	UMETA(DisplayName = "Icon"),
+
+	/** The item's actual class */
+	ActualClass			= 1 << 1	UMETA(DisplayName = "Actual Class"),
+
+	/** The class that's spawned in the world */
+	WorldClass			= 1 << 2	UMETA(DisplayName = "World Class"),
+
+	/** The mesh of lightweight world items. This is cosmetic, and isn't loaded on dedicated servers */
+	WorldMesh			= 1 << 3	UMETA(DisplayName = "World Mesh"),
+};
+ENUM_CLASS_FLAGS(EInventoryItemAssets)
+
+
+DECLARE_DYNAMIC_DELEGATE(FOnInventoryItemAssetsLoadedDelegate);
+
+
+/**
+ * Loads the images and classes of items when they're needed. Item definitions only have soft references to their assets, so the item database doesn't load every item's assets when it's loaded.
+ * Request the assets of the items you're about to use (opening the inventory, looting a container, etc.) and they're loaded asynchronously, then retrieve them with GetItemIcon() and GetItemClass().
+ *
+ * Loaded assets are kept until there's more than the settings' MaxResidentItemAssets, and then the least recently used ones are released (they're unloaded once nothing else references them).
+ * Dedicated servers don't load cosmetic assets (icons) unless the settings allow it.
+ *
+ * @remarks This should only be used on the game thread
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryItemAssets : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** An asset that's loaded (or loading), and the slots of the assets used before and after it in the recently used list */
+	struct FResidentAsset
+	{
+		FSoftObjectPath Path;
+		TSharedPtr<FStreamableHandle> Handle;
+		int32 Previous = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	FStreamableManager StreamableManager;
+
+	/** The assets that are loaded or loading. Released slots are reused, so using an asset only relinks it's slot instead of allocating a list node */
+	TArray<FResidentAsset> ResidentAssets;
+	TArray<int32> FreeSlots;
+
+	/** The slot of each resident asset */
+	TMap<FSoftObjectPath, int32> ResidentSlots;
+
+	/** The most and least recently used slots */
+	int32 MostRecentlyUsed = INDEX_NONE;
+	int32 LeastRecentlyUsed = INDEX_NONE;
+
+	/** The most assets that are kept loaded */
+	int32 MaxResidentAssets = 256;
+
+	/** Whether cosmetic assets are loaded, these aren't needed on dedicated servers */
+	bool bLoadCosmeticAssets = true;
+
+	/** The asset loader that's currently in use */
+	static UInventoryItemAssets* ItemAssets;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the asset loader. This is valid once the engine has started */
+	static UInventoryItemAssets* Get() { return ItemAssets; }
+
+	/**
+	 * Loads the assets of items asynchronously
+	 *
+	 * @param ItemDefIds				The ItemDefIds of the items in the item catalog
+	 * @param Assets					Which assets are loaded
+	 * @param OnLoaded					Called once every asset is loaded. If they're already loaded this is called immediately
+	 */
+	void RequestItemAssets(TConstArrayView<int32> ItemDefIds, EInventoryItemAssets Assets, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	/** Loads the assets of items asynchronously from their database ids. Called once every asset is loaded */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Assets", meta = (AutoCreateRefTerm = "OnLoaded"))
+	void LoadItemAssets(const TArray<FName>& DatabaseIds, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/InventorySystem.EInventoryItemAssets")) int32 Assets, const FOnInventoryItemAssetsLoadedDelegate& OnLoaded);
+
+	/** Returns an item's image if it's been loaded. Request the item's assets first, otherwise this is nullptr */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Assets") UTexture2D* GetItemIcon(FName DatabaseId);
+
+	/** Returns an item's world class (or it's actual class) if it's been loaded */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Assets") UClass* GetItemClass(FName DatabaseId, bool bWorldClass = true);
+
+	/**
+	 * Returns an asset, and loads it immediately if it hasn't been loaded. This stalls the game thread, so request the asset beforehand if you can
+	 * @returns The asset, or nullptr if the path is empty or it's a cosmetic asset that isn't loaded on this machine
+	 */
+	UObject* LoadAssetSynchronous(const FSoftObjectPath& Path, bool bCosmetic = false);
+
+	/** Returns an asset from a soft reference, using the asset loader if it's available */
+	static UObject* LoadItemAsset(const FSoftObjectPath& Path, bool bCosmetic = false);
+
+	/** Releases every loaded asset. They're unloaded once nothing else references them */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Assets") void ReleaseAllAssets();
+
+	/** Returns how many assets are loaded or loading */
+	int32 GetNumResidentAssets() const { return ResidentSlots.Num(); }
+
+
+protected:
+	/** Adds the paths of an item's assets, skipping the ones that aren't loaded on this machine */
+	virtual void GetAssetPaths(int32 ItemDefId, EInventoryItemAssets Assets, TArray<FSoftObjectPath>& OutPaths) const;
+
+	/** Returns the asset if it's loaded, and marks it as recently used */
+	UObject* FindResidentAsset(const FSoftObjectPath& Path);
+
+	/** Keeps an asset loaded, and marks it as recently used */
+	void AddResidentAsset(const FSoftObjectPath& Path, TSharedPtr<FStreamableHandle> Handle);
+
+	/** Releases the least recently used assets that have finished loading until there's room for more */
+	void ReleaseUnusedAssets();
+
+	/** Moves a slot to the front of the recently used list, or removes it from the list */
+	void LinkMostRecentlyUsed(int32 Slot);
+	void Unlink(int32 Slot);
+
+
+};
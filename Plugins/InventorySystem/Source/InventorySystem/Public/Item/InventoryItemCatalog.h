@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "InventoryItemCatalog.generated.h"
+
+class UDataTable;
+class UNetConnection;
+class UPackageMap;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FInventoryItemDefinitionDelegate, int32 /* ItemDefId */);
+
+
+/**
+ * Every item definition in the game, built once from the item database when the engine starts.
+ * Each database row is given a compact ItemDefId, and item information is accessed with that index instead of searching the data table.
+ *
+ * ItemDefIds are assigned in the order the rows are added, and they're only valid on the machine that created them (the order databases are registered in and definitions added at runtime aren't the same everywhere).
+ * Anything that's sent over the network uses NetSerializeItemDefId(). Once a client has sent it's catalog's hash, ItemDefIds that are the same on both machines are sent as they are,
+ * and everything else is sent as the item's database id, which the receiver resolves to it's own ItemDefId.
+ * Definitions are never removed, if a database changes (editor only) it's rows are updated in place and new rows are added to the end.
+ *
+ * @remarks This should only be used on the game thread
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryItemCatalog : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The databases that have been added to the catalog */
+	UPROPERTY() TArray<TObjectPtr<UDataTable>> Databases;
+
+	/** The information for every item, indexed by ItemDefId. This is the only place inventories reference an item's objects (image, classes, etc.), inventory items only store their ItemDefId */
+	UPROPERTY() TArray<F_Item> Definitions;
+
+	/** The database id of every item, indexed by ItemDefId */
+	TArray<FName> DatabaseIds;
+
+	/** The ItemDefId of each item by it's database id */
+	TMap<FName, int32> ItemDefIds;
+
+	/** A hash of every database id in ItemDefId order. If this is the same, the ItemDefIds are too */
+	uint32 CatalogHash = 0;
+
+	/** The catalog hash after each definition was added, indexed by ItemDefId. Used to find how many definitions another machine's catalog has in common with this one */
+	TArray<uint32> DefinitionHashes;
+
+	/** How many definitions each client's catalog has in common with this one (server only). ItemDefIds below this are sent to the client as they are */
+	TMap<TObjectKey<UNetConnection>, int32> SharedDefinitions;
+
+	/** The definitions that were received over the network before this machine had their information. These are only the database id until the definition is added */
+	TSet<int32> PendingDefinitions;
+
+	/** The catalog that's currently in use */
+	static UInventoryItemCatalog* Catalog;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the item catalog. This is valid once the engine has started */
+	static UInventoryItemCatalog* Get() { return Catalog; }
+
+	/** Adds every row of a database to the catalog. Databases that have already been added are ignored */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Catalog") void RegisterDatabase(UDataTable* Database);
+
+	/**
+	 * Adds an item that isn't in any database to the catalog. If there's already an item with the same database id, that definition is kept
+	 * @returns The ItemDefId of the item, or INDEX_NONE if the item doesn't have a database id
+	 */
+	int32 AddDefinition(const F_Item& Item);
+
+	/**
+	 * Returns the ItemDefId of a database id, adding an empty definition for it if it isn't in the catalog yet. The definition is filled in once it's database is registered or it's added with AddDefinition()
+	 * @remarks This is for items that are received over the network, use FindItemDefId() for everything else
+	 */
+	int32 FindOrAddPendingItemDefId(FName DatabaseId);
+
+	/** Returns true if this is an empty definition that's waiting for it's information */
+	bool IsPendingDefinition(const int32 ItemDefId) const { return PendingDefinitions.Contains(ItemDefId); }
+
+	/** Called when a pending definition receives it's information. Inventories use this to move their items into the right section */
+	FInventoryItemDefinitionDelegate OnPendingDefinitionAdded;
+
+	/**
+	 * Sends an ItemDefId over the network. ItemDefIds that are the same on the client are sent as they are, and the others are sent as their database id and resolved to this machine's ItemDefId when they're received
+	 * @param Map						The package map of the connection it's being sent to. Used to find which ItemDefIds that client has in common with this machine
+	 */
+	static void NetSerializeItemDefId(FArchive& Ar, UPackageMap* Map, int32& ItemDefId);
+
+	/**
+	 * Compares a client's catalog with this one, so the ItemDefIds they have in common are sent to them without their database id. Called on the server
+	 * @param Connection				The client's connection
+	 * @param NumDefinitions			The number of definitions in the client's catalog
+	 * @param ClientCatalogHash			The client's catalog hash
+	 */
+	void SetClientCatalog(UNetConnection* Connection, int32 NumDefinitions, uint32 ClientCatalogHash);
+
+	/** Returns true if an ItemDefId is the same on the client that a package map belongs to */
+	bool IsSharedItemDefId(UPackageMap* Map, int32 ItemDefId) const;
+
+
+//----------------------------------------------------------------------------------//
+// Lookups																			//
+//----------------------------------------------------------------------------------//
+	/** Returns the ItemDefId of a database item, or INDEX_NONE if it isn't in the catalog */
+	int32 FindItemDefId(const FName DatabaseId) const
+	{
+		const int32* ItemDefId = ItemDefIds.Find(DatabaseId);
+		return ItemDefId ? *ItemDefId : INDEX_NONE;
+	}
+
+	/** Returns the information of an item, or nullptr if the ItemDefId isn't valid */
+	const F_Item* GetDefinition(const int32 ItemDefId) const { return Definitions.IsValidIndex(ItemDefId) ? &Definitions[ItemDefId] : nullptr; }
+
+	/** Returns the information of a database item, or nullptr if it isn't in the catalog */
+	const F_Item* FindDefinition(const FName DatabaseId) const { return GetDefinition(FindItemDefId(DatabaseId)); }
+
+	/**
+	 * Creates a new item from it's definition, with a new id. This is the database lookup of the inventories' GetDataBaseItem()
+	 * @returns True if the item's definition is in the catalog
+	 */
+	bool CreateItem(FName DatabaseId, F_Item& OutItem) const;
+
+	/** Returns the database id of an item, or NAME_None if the ItemDefId isn't valid */
+	FName GetDatabaseId(const int32 ItemDefId) const { return DatabaseIds.IsValidIndex(ItemDefId) ? DatabaseIds[ItemDefId] : NAME_None; }
+
+	/** Retrieves the ItemDefId of every database id. Items that aren't in the catalog are INDEX_NONE */
+	void ResolveItemDefIds(TConstArrayView<FName> InDatabaseIds, TArray<int32>& OutItemDefIds) const;
+
+	/** Retrieves the information of every item. Invalid ItemDefIds are nullptr */
+	void ResolveDefinitions(TConstArrayView<int32> InItemDefIds, TArray<const F_Item*>& OutDefinitions) const;
+
+	/** The number of items in the catalog */
+	int32 Num() const { return Definitions.Num(); }
+
+	/** The version of the catalog's ItemDefIds. Saved ItemDefIds are only valid if this hasn't changed */
+	uint32 GetCatalogHash() const { return CatalogHash; }
+
+	/** Retrieves the information of a database item */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Catalog") bool GetItemDefinition(FName DatabaseId, F_Item& Item) const;
+
+
+protected:
+	/** Adds or updates the definition of every row in a database */
+	virtual void AddDatabaseRows(UDataTable* Database);
+
+	/** Adds or updates a definition in the catalog */
+	int32 SetDefinition(FName DatabaseId, const F_Item& Item);
+
+
+};
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InventoryItemClaims.generated.h"
+
+
+/** The result of trying to claim an item */
+UENUM(BlueprintType)
+enum class EInventoryItemClaimResult : uint8
+{
+	/** The item was claimed (or the claim was renewed) */
+	Claim_Succeeded						UMETA(DisplayName = "Succeeded"),
+
+	/** Someone else has the item */
+	Claim_Contended						UMETA(DisplayName = "Contended"),
+
+	/** The item is free, but someone else was waiting for it first */
+	Claim_Queued						UMETA(DisplayName = "Queued"),
+
+	/** The item or the claimant wasn't valid */
+	Claim_Invalid						UMETA(DisplayName = "Invalid"),
+};
+
+
+/**
+ * How the claim table has been used
+ */
+USTRUCT(BlueprintType)
+struct FInventoryItemClaimStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** How many claims were made */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumClaimed = 0;
+
+	/** How many claims were refused because someone else had the item */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumContended = 0;
+
+	/** How many claims were refused because someone else was waiting for the item first */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumQueued = 0;
+
+	/** How many claims were released, and how many ran out before they were released */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumReleased = 0;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumExpired = 0;
+
+	/** How many items are claimed, and the most there's been at once */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumActive = 0;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 PeakActive = 0;
+};
+
+
+/** Called on the server when someone loses the race for an item */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInventoryItemClaimContended, const FGuid& /*Id*/, UObject* /*Claimant*/, UObject* /*Loser*/);
+
+/** Called on the server when an item is free and it's the first claimant in line's turn to claim it */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInventoryItemClaimAvailable, const FGuid& /*Id*/, UObject* /*Claimant*/);
+
+
+
+
+/**
+ * Keeps track of who is interacting with which items on the server, so players can't perform operations on the same item at the same time.
+ * Items are claimed by their id, so this works for anything with an item id (world items, lightweight world items, and the items in containers).
+ *
+ * Every claim is a lease that runs out after a while (ItemClaimLeaseDuration in the inventory system settings), so an interaction that's interrupted doesn't lock the item forever.
+ * Players that lose the race for an item can wait in line for it, and once it's released the first player in line is told with OnClaimAvailable and gets the first chance to claim it (for ItemClaimQueueTimeout).
+ * Only wait in line if you're going to try again when you're told, otherwise you're keeping everyone else from the item until your turn runs out.
+ * Multiple items can be claimed at once, either every item is claimed or none of them are.
+ *
+ * @remarks This is only used on the server, and only on the game thread
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryItemClaims : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** A claimant that lost the race for an item, and when they stop waiting */
+	struct FWaiter
+	{
+		TWeakObjectPtr<UObject> Claimant;
+		double ExpireTime;
+	};
+
+	/** Who has an item, and who is waiting for it */
+	struct FClaim
+	{
+		TWeakObjectPtr<UObject> Claimant;
+		double ExpireTime = 0.0;
+		TArray<FWaiter, TInlineAllocator<2>> Waiters;
+
+		bool IsActive(const double Time) const { return Claimant.IsValid() && ExpireTime > Time; }
+	};
+
+	/** The claim of each item. Items stay in the table while someone is waiting for them */
+	TMap<FGuid, FClaim> Claims;
+
+	FInventoryItemClaimStats Stats;
+
+	/** How long claims last, and how long a claimant waits in line */
+	double LeaseDuration = 5.0;
+	double QueueTimeout = 1.0;
+
+	FTimerHandle ExpiredClaimsTimer;
+
+
+public:
+	/** Called when someone loses the race for an item */
+	FOnInventoryItemClaimContended OnClaimContended;
+
+	/** Called when it's a waiting claimant's turn to claim an item */
+	FOnInventoryItemClaimAvailable OnClaimAvailable;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the claim table of an object's world, or nullptr if there isn't one */
+	static UInventoryItemClaims* Get(const UObject* WorldContextObject);
+
+	/** Returns the id an object is claimed with if it doesn't have an item id. It's made from the object's unique id, so it never matches an item's id */
+	static FGuid GetObjectClaimId(const UObject* Object);
+
+	/**
+	 * Claims an item. Claiming an item that's already yours renews the lease
+	 *
+	 * @param Id						The item's id
+	 * @param Claimant					Who is claiming the item (usually the player's character)
+	 * @param Lease						How long the claim lasts. Zero uses the default lease
+	 * @param bWaitInLine				If the item is taken, wait in line for it. You're told when it's your turn with OnClaimAvailable
+	 */
+	EInventoryItemClaimResult TryClaim(const FGuid& Id, UObject* Claimant, float Lease = 0.0f, bool bWaitInLine = true);
+
+	/**
+	 * Claims every item, or none of them if any of them are taken
+	 *
+	 * @param Ids						The ids of the items
+	 * @param Claimant					Who is claiming the items
+	 * @param Lease						How long the claims last. Zero uses the default lease
+	 * @param OutResults				The result for each item, if you need to know which items were taken
+	 * @param bWaitInLine				If any of the items are taken, wait in line for them
+	 * @returns True if every item was claimed
+	 */
+	bool TryClaimAll(TConstArrayView<FGuid> Ids, UObject* Claimant, float Lease = 0.0f, TArray<EInventoryItemClaimResult>* OutResults = nullptr, bool bWaitInLine = true);
+
+	/** Releases an item if the claimant has it. The first claimant in line is told, and gets the next chance to claim it */
+	void Release(const FGuid& Id, UObject* Claimant);
+
+	/** Releases every item the claimant has from a list */
+	void ReleaseAll(TConstArrayView<FGuid> Ids, UObject* Claimant);
+
+	/** Returns true if someone has the item */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Claims") bool IsClaimed(const FGuid& Id) const;
+
+	/** Returns who has the item, or nullptr if it isn't claimed */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Claims") UObject* GetClaimant(const FGuid& Id) const;
+
+	/** Returns how the claim table has been used */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Claims") FInventoryItemClaimStats GetClaimStats() const { return Stats; }
+
+	/** Logs how the claim table has been used */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Claims") void ListClaimStats() const;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the result of claiming an item without claiming it, and adds the claimant to the line if they lose */
+	EInventoryItemClaimResult CheckClaim(const FGuid& Id, UObject* Claimant, double Time, bool bWaitInLine);
+
+	/** Gives the claimant the item */
+	void SetClaim(const FGuid& Id, UObject* Claimant, double Time, float Lease);
+
+	/** Removes the claims that ran out, and the claimants that stopped waiting */
+	void RemoveExpiredClaims();
+
+	/** Gives the first claimant in line their turn to claim a free item, and tells them */
+	void NotifyNextWaiter(const FGuid& Id, FClaim& Claim, double Time);
+
+	double GetTime() const;
+
+
+};
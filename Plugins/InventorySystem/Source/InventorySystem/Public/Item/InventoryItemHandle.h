@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryItemHandle.generated.h"
+
+
+/**
+ * A compact 64 bit id for an item, allocated by the server. Handles are made of the id of the server that created the item, a sequence that's never reused on that server, and a generation.
+ *
+ *	Bits:	ServerId (16) | Sequence (40) | Generation (8)
+ *
+ * The generation is incremented when an item's handle is reissued (items that are dropped into the world), and older handles for the same item are stale.
+ * Handles are stored in item ids (FGuids) so blueprints and legacy saves still work, and ids that came from a handle are sent over the network and saved as 64 bits instead of 128.
+ */
+USTRUCT(BlueprintType)
+struct INVENTORYSYSTEM_API FInventoryItemHandle
+{
+	GENERATED_USTRUCT_BODY()
+	FInventoryItemHandle() : Value(0) {}
+	explicit FInventoryItemHandle(const uint64 InValue) : Value(InValue) {}
+	FInventoryItemHandle(const uint16 ServerId, const uint64 Sequence, const uint8 Generation) :
+		Value((static_cast<uint64>(ServerId) << (SequenceBits + GenerationBits)) | ((Sequence & SequenceMask) << GenerationBits) | Generation)
+	{}
+
+	static constexpr int32 GenerationBits = 8;
+	static constexpr int32 SequenceBits = 40;
+	static constexpr uint64 SequenceMask = (1ull << SequenceBits) - 1;
+
+	/** Identifies an item id that came from a handle */
+	static constexpr uint32 GuidTagA = 0x494E5648;
+	static constexpr uint32 GuidTagB = 0xB6B1A9B7;
+
+	uint16 GetServerId() const { return static_cast<uint16>(Value >> (SequenceBits + GenerationBits)); }
+	uint64 GetSequence() const { return (Value >> GenerationBits) & SequenceMask; }
+	uint8 GetGeneration() const { return static_cast<uint8>(Value); }
+	uint64 GetValue() const { return Value; }
+
+	/** Handles are only valid once they've been allocated */
+	bool IsValid() const { return GetSequence() != 0; }
+
+	/** The item's server id and sequence, which is the same for every generation of it's handle */
+	uint64 GetItemKey() const { return Value >> GenerationBits; }
+
+	/** Returns the handle for the same item with the next generation. The previous handle is stale once this is used */
+	FInventoryItemHandle NextGeneration() const { return FInventoryItemHandle(GetServerId(), GetSequence(), GetGeneration() + 1); }
+
+	/** Returns true if both handles are for the same item, regardless of their generations */
+	bool IsSameItem(const FInventoryItemHandle& Other) const { return GetItemKey() == Other.GetItemKey(); }
+
+	/** Returns true if this is an older generation of the current handle */
+	bool IsStale(const FInventoryItemHandle& Current) const { return IsSameItem(Current) && static_cast<int8>(Current.GetGeneration() - GetGeneration()) > 0; }
+
+	/** Stores the handle in an item id */
+	FGuid ToGuid() const { return FGuid(GuidTagA, GuidTagB, static_cast<uint32>(Value >> 32), static_cast<uint32>(Value)); }
+
+	/**
+	 * Retrieves the handle from an item id
+	 * @returns false if the id didn't come from a handle (ids from legacy saves)
+	 */
+	static bool FromGuid(const FGuid& Id, FInventoryItemHandle& OutHandle);
+
+	/** Serializes an item id for replication. Ids that came from a handle are sent as 64 bits, and other ids are sent as they are */
+	static void NetSerializeId(FArchive& Ar, FGuid& Id);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+	FString ToString() const { return FString::Printf(TEXT("%u:%llu:%u"), GetServerId(), GetSequence(), GetGeneration()); }
+
+	bool operator==(const FInventoryItemHandle& Other) const { return Value == Other.Value; }
+	bool operator!=(const FInventoryItemHandle& Other) const { return Value != Other.Value; }
+	friend uint32 GetTypeHash(const FInventoryItemHandle& Handle) { return GetTypeHash(Handle.Value); }
+
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "Inventory") uint64 Value;
+};
+
+
+/**
+ * The index of each item by it's id. Ids that came from a handle are keyed by their 64 bit handle, and only legacy guids use a 128 bit key.
+ * Handles are keyed without their generation, so every generation of an item's handle finds the same index. Compare the id that's stored there to find stale handles
+ */
+struct INVENTORYSYSTEM_API FInventoryItemIdLookup
+{
+	const int32* Find(const FGuid& Id) const
+	{
+		FInventoryItemHandle Handle;
+		return FInventoryItemHandle::FromGuid(Id, Handle) ? Handles.Find(Handle.GetItemKey()) : LegacyIds.Find(Id);
+	}
+
+	void Add(const FGuid& Id, const int32 Index)
+	{
+		FInventoryItemHandle Handle;
+		if (FInventoryItemHandle::FromGuid(Id, Handle)) Handles.Add(Handle.GetItemKey(), Index);
+		else LegacyIds.Add(Id, Index);
+	}
+
+	bool RemoveAndCopyValue(const FGuid& Id, int32& OutIndex)
+	{
+		FInventoryItemHandle Handle;
+		return FInventoryItemHandle::FromGuid(Id, Handle) ? Handles.RemoveAndCopyValue(Handle.GetItemKey(), OutIndex) : LegacyIds.RemoveAndCopyValue(Id, OutIndex);
+	}
+
+	bool Remove(const FGuid& Id) { int32 Index; return RemoveAndCopyValue(Id, Index); }
+	bool Contains(const FGuid& Id) const { return Find(Id) != nullptr; }
+	void Reserve(const int32 Number) { Handles.Reserve(Number); }
+	void Reset() { Handles.Reset(); LegacyIds.Reset(); }
+	void Empty() { Handles.Empty(); LegacyIds.Empty(); }
+
+
+protected:
+	TMap<uint64, int32> Handles;
+	TMap<FGuid, int32> LegacyIds;
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventoryItemHandle> : public TStructOpsTypeTraitsBase2<FInventoryItemHandle>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
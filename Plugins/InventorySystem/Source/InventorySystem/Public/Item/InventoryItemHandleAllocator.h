@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Item/InventoryItemHandle.h"
+#include "Subsystems/EngineSubsystem.h"
+#include <atomic>
+#include "InventoryItemHandleAllocator.generated.h"
+
+
+/**
+ * Allocates the handles for new items. Every server needs a different server id (the "-InventoryServerId=" command line argument, or the inventory system settings),
+ * and the sequences are reserved in blocks that are saved to disk, so handles are never reused on the same server even if it restarts or crashes.
+ *
+ * Allocating a handle is lock free, there's only a lock when the next block needs to be reserved.
+ *
+ * @remarks Only the server should allocate handles, clients receive them with the items
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryItemHandleAllocator : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The id of this server */
+	uint16 ServerId = 0;
+
+	/** The next sequence that's allocated, and the end of the reserved block */
+	std::atomic<uint64> NextSequence{1};
+	std::atomic<uint64> BlockEnd{1};
+
+	/** How many sequences are reserved at once */
+	uint64 BlockSize = 65536;
+
+	/** Whether this server has used every sequence, and new items are given guids instead */
+	std::atomic<bool> bExhausted{false};
+
+	/** Only one thread reserves the next block */
+	FCriticalSection BlockLock;
+
+	/** The allocator that's currently in use */
+	static UInventoryItemHandleAllocator* Allocator;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the handle allocator. This is valid once the engine has started */
+	static UInventoryItemHandleAllocator* Get() { return Allocator; }
+
+	/**
+	 * Allocates the handle for a new item. Safe to call from any thread
+	 * @returns The item's handle, or an invalid handle if this server has used every sequence
+	 */
+	FInventoryItemHandle Allocate();
+
+	/** Allocates the id for a new item, or creates a guid if the allocator isn't available or has run out of handles */
+	static FGuid AllocateItemId();
+
+	/** Returns an item's id with the next generation of it's handle, so anything that's still using the previous id is stale. Legacy guids are returned as they are */
+	static FGuid ReissueItemId(const FGuid& Id);
+
+	/** Returns true if an id is an older generation of an item's current id */
+	static bool IsStaleItemId(const FGuid& Id, const FGuid& CurrentId);
+
+	/** The id of this server */
+	uint16 GetServerId() const { return ServerId; }
+
+	/** Returns true if an item's id came from an item handle, instead of a legacy guid */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Items") static bool IsItemHandleId(const FGuid& Id);
+
+	/** Returns the id of the server that created an item, or -1 if the id didn't come from an item handle */
+	UFUNCTION(BlueprintPure, Category = "Inventory|Items") static int32 GetItemServerId(const FGuid& Id);
+
+
+protected:
+	/** Reserves the block that contains a sequence, and saves it so it isn't reused */
+	void ReserveBlock(uint64 Sequence);
+
+	/** The file that the reserved blocks are saved to */
+	FString GetBlockFilePath() const;
+
+
+};
@@ -64,7 +64,8 @@ public:
 // Networking functions																						//
 //----------------------------------------------------------------------------------------------------------//
 	/**
-	 * Server side function that acts like a threadlock to prevent multiple players from trying to perform operations on an item at the same time
+	 * Server side function that acts like a threadlock to prevent multiple players from trying to perform operations on an item at the same time.
+	 * By default the item is claimed by it's id in the world's claim table (UInventoryItemClaims), or by the object if GetId() isn't implemented, and the claim runs out if it isn't released
 	 * 
 	 * @remarks Do not override this unless you're refactoring
 	 */
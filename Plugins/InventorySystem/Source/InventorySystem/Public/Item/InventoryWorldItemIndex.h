@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "InventoryWorldItemIndex.generated.h"
+
+
+/**
+ * An item that was found by a world item query. Items that are actors have their object, lightweight world items (UInventoryWorldItemManager) only have their id
+ */
+USTRUCT(BlueprintType)
+struct FInventoryWorldItemQueryResult
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The world item (an object with the inventory item interface), or nullptr if it's a lightweight world item */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") TObjectPtr<UObject> Item = nullptr;
+
+	/** The id of a lightweight world item. Use the item's interface for the id of world items that are actors */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FGuid Id;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FVector Location = FVector::ZeroVector;
+
+	/** How far the item is from where the query was made */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") float Distance = 0.0f;
+};
+
+
+
+
+/**
+ * Keeps track of where every world item is, so finding the items around a character doesn't need physics overlaps or traces. Items are kept in a grid (WorldItemIndexCellSize in the inventory system settings),
+ * and the queries only check the items in the cells they touch. This includes world item actors (AItemBase adds itself when it begins play and when it's taken from the world item pool)
+ * and lightweight world items (their regions add them on the server and on clients).
+ *
+ * Interaction prompts and auto looting can use these queries every frame: the nearest items, the items within a radius, and the items within a view cone.
+ *
+ * @remarks Items that move after they're placed need to call UpdateWorldItem(), world item actors do this when their root component moves
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryWorldItemIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** An item in the grid */
+	struct FEntry
+	{
+		TWeakObjectPtr<UObject> Item;
+		FGuid Id;
+		FVector Location;
+		FIntPoint Cell;
+	};
+
+	/** Every item in the grid */
+	TSparseArray<FEntry> Entries;
+
+	/** The entries in each cell */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** The entry of each world item actor, and each lightweight world item */
+	TMap<TObjectKey<UObject>, int32> ItemEntries;
+	TMap<FGuid, int32> LightweightEntries;
+
+	/** The width of each cell */
+	double CellSize = 1000.0;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the world item index of an object's world, or nullptr if there isn't one */
+	static UInventoryWorldItemIndex* Get(const UObject* WorldContextObject);
+
+	/** Adds a world item (an object with the inventory item interface), or moves it if it's already been added */
+	void AddWorldItem(UObject* Item, const FVector& Location);
+
+	/** Moves a world item actor to where it is now */
+	void UpdateWorldItem(const AActor* Item);
+
+	/** Removes a world item once it's been picked up, or returned to the world item pool */
+	void RemoveWorldItem(const UObject* Item);
+
+	/** Adds a lightweight world item, or moves it if it's already been added */
+	void AddLightweightItem(const FGuid& Id, const FVector& Location);
+
+	/** Removes a lightweight world item */
+	void RemoveLightweightItem(const FGuid& Id);
+
+	/** Returns how many items are in the index */
+	UFUNCTION(BlueprintPure, Category = "Inventory|World Items") int32 GetNumItems() const { return Entries.Num(); }
+
+
+//----------------------------------------------------------------------------------//
+// Queries																			//
+//----------------------------------------------------------------------------------//
+	/**
+	 * Finds the items within a radius, closest first
+	 *
+	 * @param Origin					Where the query is made from
+	 * @param Radius					How far away the items can be
+	 * @param OutItems					The items that were found
+	 * @param MaxItems					The most items that are returned (the closest ones). Zero returns every item
+	 * @returns True if any items were found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items")
+	bool FindItemsInRadius(const FVector& Origin, float Radius, TArray<FInventoryWorldItemQueryResult>& OutItems, int32 MaxItems = 0) const;
+
+	/**
+	 * Finds the closest items, checking the cells around the origin until there aren't any closer items left
+	 *
+	 * @param Origin					Where the query is made from
+	 * @param NumItems					How many items are returned
+	 * @param MaxRadius					How far away the items can be
+	 * @param OutItems					The items that were found, closest first
+	 * @returns True if any items were found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items")
+	bool FindNearestItems(const FVector& Origin, int32 NumItems, float MaxRadius, TArray<FInventoryWorldItemQueryResult>& OutItems) const;
+
+	/**
+	 * Finds the items within a view cone, closest first
+	 *
+	 * @param Origin					Where the query is made from (the camera)
+	 * @param Direction					Where the cone is facing
+	 * @param Radius					How far away the items can be
+	 * @param HalfAngle					The angle between the direction and the edge of the cone, in degrees
+	 * @param OutItems					The items that were found
+	 * @param MaxItems					The most items that are returned (the closest ones). Zero returns every item
+	 * @returns True if any items were found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items")
+	bool FindItemsInCone(const FVector& Origin, const FVector& Direction, float Radius, float HalfAngle, TArray<FInventoryWorldItemQueryResult>& OutItems, int32 MaxItems = 0) const;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the grid cell of a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Adds an entry, or moves it to a new location */
+	int32 SetEntry(int32 EntryIndex, UObject* Item, const FGuid& Id, const FVector& Location);
+
+	/** Removes an entry from the grid */
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Adds the entries in a cell that are within range and pass the filter to the results. Items that are gone or hidden (in the world item pool) are skipped */
+	template<typename FilterType>
+	void GatherCell(const FIntPoint& Cell, const FVector& Origin, double MaxDistanceSquared, FilterType&& Filter, TArray<FInventoryWorldItemQueryResult>& OutItems) const;
+
+	/** Sorts the results by distance and trims them to the most items */
+	static void SortResults(TArray<FInventoryWorldItemQueryResult>& OutItems, int32 MaxItems);
+
+
+};
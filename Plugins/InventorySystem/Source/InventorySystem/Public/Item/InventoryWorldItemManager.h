@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "Item/InventoryWorldItemRegion.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InventoryWorldItemManager.generated.h"
+
+class AItemBase;
+
+
+/**
+ * A lightweight world item that's been turned into an actor while a player interacts with it
+ */
+USTRUCT()
+struct FInventoryPromotedWorldItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The actor that's standing in for the item */
+	UPROPERTY() TWeakObjectPtr<AItemBase> WorldItem;
+
+	/** The item's record, so it can be put back in it's region */
+	UPROPERTY() FInventoryWorldItemRecord Record;
+
+	/** When the item was turned into an actor */
+	double PromotedTime = 0.0;
+};
+
+
+
+
+/**
+ * Keeps track of items on the ground without an actor for each one. The world is split into a grid of regions (WorldItemRegionSize in the inventory system settings),
+ * and every item in a region is a small record in one replicated actor (AInventoryWorldItemRegion) that's drawn with instanced meshes. Thousands of dropped items only cost a few actors.
+ *
+ * Lightweight items are turned into real world items (AItemBase) from the world item pool while a player interacts with them (PromoteWorldItem), so picking them up
+ * still goes through TryAddItem and the inventory item interface. Items that aren't picked up are turned back into records after PromotedWorldItemLifetime.
+ *
+ * @remarks Items are only added, removed, and promoted on the server. Clients register the regions they receive, so they can find the items they're looking at
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryWorldItemManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The regions in the world, by their grid cell */
+	UPROPERTY() TMap<FIntPoint, TObjectPtr<AInventoryWorldItemRegion>> Regions;
+
+	/** The region of every lightweight item. Server only */
+	TMap<FGuid, FIntPoint> ItemRegions;
+
+	/** The items that are actors right now. Server only */
+	UPROPERTY() TMap<FGuid, FInventoryPromotedWorldItem> PromotedItems;
+
+	/** The width of each region */
+	double RegionSize = 20000.0;
+
+	/** How long promoted items stay actors */
+	double PromotedItemLifetime = 10.0;
+
+	FTimerHandle PromotedItemsTimer;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * Places an item in the world as a lightweight item. Server only
+	 *
+	 * @param Item						The item's information. The item needs to be in the item catalog
+	 * @param Transform					Where the item is placed
+	 * @returns True if the item was added
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Inventory|World Items") virtual bool AddWorldItem(const F_Item& Item, const FTransform& Transform);
+
+	/** Removes a lightweight item from the world without picking it up. Server only */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Inventory|World Items") virtual bool RemoveWorldItem(const FGuid& Id);
+
+	/** Retrieves a lightweight item's record. Clients can only find the items in the regions they've received */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items") bool FindWorldItem(const FGuid& Id, FInventoryWorldItemRecord& Record) const;
+
+	/** Returns the lightweight item that was hit by a trace, or an invalid id if it wasn't one */
+	UFUNCTION(BlueprintPure, Category = "Inventory|World Items") FGuid FindWorldItemFromHit(const FHitResult& Hit) const;
+
+
+//----------------------------------------------------------------------------------//
+// Promotion																		//
+//----------------------------------------------------------------------------------//
+	/**
+	 * Turns a lightweight item into a world item actor so a player can interact with it. Server only
+	 * @returns The world item, or nullptr if the item isn't in the world or it's world class couldn't be loaded
+	 */
+	virtual AItemBase* PromoteWorldItem(const FGuid& Id);
+
+	/** Turns a promoted world item back into a lightweight item, and returns the actor to the world item pool. Server only */
+	virtual bool DemoteWorldItem(const FGuid& Id);
+
+	/** Returns the actor of a promoted item, or nullptr if it hasn't been promoted */
+	AItemBase* GetPromotedWorldItem(const FGuid& Id) const;
+
+
+//----------------------------------------------------------------------------------//
+// Regions																			//
+//----------------------------------------------------------------------------------//
+	/** Returns the grid cell of a location */
+	FIntPoint GetRegionCell(const FVector& Location) const;
+
+	/** Returns the region of a grid cell, or nullptr if there aren't any items there */
+	AInventoryWorldItemRegion* GetRegion(const FIntPoint& Cell) const;
+
+	/** Adds a region to the grid once it's begun play (on the server and on clients) */
+	void RegisterRegion(AInventoryWorldItemRegion* Region);
+
+	/** Removes a region from the grid once it's left play */
+	void UnregisterRegion(AInventoryWorldItemRegion* Region);
+
+	/** Returns how many lightweight items are in the world. Server only */
+	UFUNCTION(BlueprintPure, Category = "Inventory|World Items") int32 GetNumWorldItems() const { return ItemRegions.Num(); }
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the region of a grid cell, spawning it if there isn't one */
+	AInventoryWorldItemRegion* FindOrCreateRegion(const FIntPoint& Cell, const FVector& Location);
+
+	/** Forgets the promoted items that have been picked up, and demotes the ones that players have stopped interacting with */
+	void UpdatePromotedItems();
+
+
+};
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InventoryWorldItemPool.generated.h"
+
+class AItemBase;
+class UDataTable;
+
+
+/**
+ * How a world item pool has been used
+ */
+USTRUCT(BlueprintType)
+struct FInventoryWorldItemPoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** How many items had to be spawned (including the items spawned when the pool was warmed up) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumSpawned = 0;
+
+	/** How many items were reused from the pool instead of being spawned */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumReused = 0;
+
+	/** How many items were returned to the pool */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumReleased = 0;
+
+	/** How many items were destroyed because the pool was already full */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumDestroyed = 0;
+
+	/** How many items from the pool are in the world, and the most there's been at once */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 NumInUse = 0;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 PeakInUse = 0;
+};
+
+
+/**
+ * The dormant world items of a single world class
+ */
+USTRUCT()
+struct FInventoryWorldItemClassPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The items that are hidden and waiting to be reused */
+	UPROPERTY() TArray<TObjectPtr<AItemBase>> FreeItems;
+
+	UPROPERTY() FInventoryWorldItemPoolStats Stats;
+};
+
+
+
+
+/**
+ * Reuses the world items that are dropped from inventories, instead of spawning an actor every time an item is dropped and destroying it once it's picked up.
+ * Each world class has it's own pool of hidden actors with replication put to sleep (dormant), and acquiring one moves it into place and wakes it up with the new item's information.
+ *
+ * Pools can be warmed up when the world begins play (WorldItemPoolPrewarm in the inventory system settings), so a lot of items dropping at once (a player dying, a loot explosion) doesn't spawn anything.
+ * Once a pool has WorldItemPoolSize free items, items that are released are destroyed instead.
+ *
+ * @remarks World items are only pooled on the server, clients just receive the actor's hidden and dormant state
+ */
+UCLASS()
+class INVENTORYSYSTEM_API UInventoryWorldItemPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The pool for each world class */
+	UPROPERTY() TMap<TObjectPtr<UClass>, FInventoryWorldItemClassPool> Pools;
+
+	/** The most free items each pool keeps */
+	int32 MaxFreeItems = 64;
+
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * Places a world item in the world, reusing one from the pool if there is one
+	 *
+	 * @param WorldClass				The class of the world item
+	 * @param Transform					Where the item is placed
+	 * @param Item						The item's information
+	 * @param Database					The item's database
+	 * @param Owner						The owner of the world item
+	 * @returns The world item, or nullptr if it couldn't be spawned
+	 */
+	virtual AItemBase* AcquireWorldItem(UClass* WorldClass, const FTransform& Transform, const F_Item& Item, UDataTable* Database, AActor* Owner = nullptr);
+
+	/** Returns a world item to it's pool once it's been picked up. Only items the pool spawned are pooled, the item is destroyed if the pool is full or if it wasn't spawned by the pool (items placed in the level) */
+	virtual void ReleaseWorldItem(AItemBase* WorldItem);
+
+	/** Returns multiple world items to their pools at once (after looting an area). Items the pool didn't spawn are destroyed */
+	virtual void ReleaseWorldItems(TConstArrayView<AItemBase*> WorldItems);
+
+	/** Releases a world item to the world's pool, or destroys the actor if there isn't one. Only the server releases world items */
+	static void ReleaseOrDestroy(AActor* WorldItem);
+
+	/** Releases multiple world items to the world's pool, and destroys the ones that can't be pooled */
+	static void ReleaseOrDestroy(TConstArrayView<AActor*> WorldItems);
+
+	/** Spawns dormant world items until the class's pool has this many free items */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items") virtual void PrewarmPool(TSubclassOf<AItemBase> WorldClass, int32 NumItems);
+
+	/** Returns how a world class's pool has been used */
+	UFUNCTION(BlueprintPure, Category = "Inventory|World Items") FInventoryWorldItemPoolStats GetPoolStats(TSubclassOf<AItemBase> WorldClass) const;
+
+	/** Logs the stats of every pool */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|World Items") void ListPoolStats() const;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Hides a world item in it's class's pool, or destroys it if the pool is full */
+	void ReleaseToPool(FInventoryWorldItemClassPool& Pool, AItemBase* WorldItem);
+
+	/** Spawns a new world item that isn't in the world yet. The pool marks the items it spawns as pooled (AItemBase::IsPooled) */
+	virtual AItemBase* SpawnWorldItem(UClass* WorldClass, const FTransform& Transform, AActor* Owner) const;
+
+
+};
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryInformation.h"
+#include "GameFramework/Actor.h"
+#include "Item/InventoryItemHandle.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "InventoryWorldItemRegion.generated.h"
+
+class AInventoryWorldItemRegion;
+class UInstancedStaticMeshComponent;
+
+
+/**
+ * An item on the ground that isn't an actor. It's just the item's id, it's definition in the item catalog, how many there are, and where it is
+ */
+USTRUCT(BlueprintType)
+struct FInventoryWorldItemRecord : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+		FInventoryWorldItemRecord(
+			const FGuid& Id = FGuid(),
+			const int32 DefinitionId = INDEX_NONE,
+			const int32 Quantity = 1,
+			const FVector& Location = FVector::ZeroVector,
+			const FRotator& Rotation = FRotator::ZeroRotator
+		) :
+		Id(Id),
+		DefinitionId(DefinitionId),
+		Quantity(Quantity),
+		Location(Location),
+		Rotation(Rotation)
+	{}
+
+public:
+	/** The unique id for this item */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FGuid Id;
+
+	/** The ItemDefId of this item's definition in the item catalog */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 DefinitionId;
+
+	/** How many of this item are in this stack */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") int32 Quantity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FVector Location;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory") FRotator Rotation;
+
+	FTransform GetTransform() const { return FTransform(Rotation, Location); }
+
+	/** Returns the item's full information from it's definition */
+	F_Item ResolveItem() const;
+
+	/** The id is sent as 64 bits if it came from an item handle, the definition is sent as it's database id, and the location and rotation are quantized (items on the ground don't need to be exact) */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventoryWorldItemRecord> : public TStructOpsTypeTraitsBase2<FInventoryWorldItemRecord>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+/**
+ * The replicated list of the items in a region. Clients update the region's instanced meshes when they receive the changes
+ */
+USTRUCT()
+struct FInventoryWorldItemList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY() TArray<FInventoryWorldItemRecord> Items;
+
+	/** The region these items are in */
+	AInventoryWorldItemRegion* Region = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInventoryWorldItemRecord, FInventoryWorldItemList>(Items, DeltaParms, *this);
+	}
+
+	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+
+	/** Rebuilds the region's lookup once every change has been received, removals swap items into other indices */
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+};
+
+
+template<>
+struct TStructOpsTypeTraits<FInventoryWorldItemList> : public TStructOpsTypeTraitsBase2<FInventoryWorldItemList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+
+/**
+ * The instanced mesh of one kind of item in a region, and the item of each instance
+ */
+USTRUCT()
+struct FInventoryWorldItemMeshInstances
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY() TObjectPtr<UInstancedStaticMeshComponent> Mesh;
+
+	/** The id of the item of each instance, in the same order as the instances */
+	TArray<FGuid> InstanceIds;
+};
+
+
+
+
+/**
+ * The items on the ground in one area of the world (UInventoryWorldItemManager). Every item in the region is replicated in one list instead of being it's own actor,
+ * and clients only receive the regions that are close to them. Items are drawn with one instanced mesh for each kind of item (the item's WorldMesh).
+ *
+ * @remarks Items are only added and removed on the server, through the world item manager
+ */
+UCLASS(NotBlueprintable, NotPlaceable)
+class INVENTORYSYSTEM_API AInventoryWorldItemRegion : public AActor
+{
+	GENERATED_BODY()
+	friend struct FInventoryWorldItemList;
+
+protected:
+	/** The items in this region */
+	UPROPERTY(Replicated) FInventoryWorldItemList Items;
+
+	/** The index of each item in the list, by it's id (keyed by the item's handle) */
+	FInventoryItemIdLookup ItemLookup;
+
+	/** The instanced mesh of each kind of item, by ItemDefId */
+	UPROPERTY(Transient) TMap<int32, FInventoryWorldItemMeshInstances> Meshes;
+
+
+public:
+	AInventoryWorldItemRegion(const FObjectInitializer& ObjectInitializer);
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitProperties() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Adds an item to the region. Server only */
+	virtual void AddItem(const FInventoryWorldItemRecord& Item);
+
+	/** Removes an item from the region. Server only */
+	virtual bool RemoveItem(const FGuid& Id);
+
+	/** Returns an item in the region, or nullptr if it isn't here */
+	const FInventoryWorldItemRecord* FindItem(const FGuid& Id) const;
+
+	/** Returns the item of an instance of one of the region's meshes (from a trace), or an invalid id if it isn't one of the region's items */
+	FGuid FindItemFromInstance(const UPrimitiveComponent* Component, int32 InstanceIndex) const;
+
+	/** Returns every item in the region */
+	const TArray<FInventoryWorldItemRecord>& GetItems() const { return Items.Items; }
+
+	/** Returns how many items are in the region */
+	UFUNCTION(BlueprintPure, Category = "Inventory|World Items") int32 GetNumItems() const { return Items.Items.Num(); }
+
+
+//----------------------------------------------------------------------------------//
+// Rendering																		//
+//----------------------------------------------------------------------------------//
+	/** Adds the instances of items that were added to the region */
+	virtual void OnItemsAdded(TConstArrayView<int32> Indices);
+
+	/** Removes the instances of items that are being removed from the region */
+	virtual void OnItemsRemoved(TConstArrayView<int32> Indices);
+
+	/** Moves the instances of items that have changed */
+	virtual void OnItemsChanged(TConstArrayView<int32> Indices);
+
+
+protected:
+	/** Rebuilds the lookup from the items. Clients use this once they've received the replicated changes (FInventoryWorldItemList::PostReplicatedReceive) */
+	void RebuildLookup();
+
+	/** Adds an item's instance, loading it's mesh if it hasn't been loaded */
+	void AddInstance(const FInventoryWorldItemRecord& Item);
+
+	/** Removes an item's instance */
+	void RemoveInstance(const FInventoryWorldItemRecord& Item);
+
+	/** Creates the instances of every item of a kind once it's mesh has been loaded */
+	void RefreshInstances(int32 DefinitionId);
+
+	/** Whether this machine draws the items */
+	bool ShouldRenderItems() const;
+
+
+};
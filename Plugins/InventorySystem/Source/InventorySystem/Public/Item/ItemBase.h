@@ -11,6 +11,7 @@ UCLASS( Blueprintable, ClassGroup=(Inventory) )
 class INVENTORYSYSTEM_API AItemBase : public AActor, public IInventoryItemInterface
 {
 	GENERATED_BODY()
+	friend class UInventoryWorldItemPool;
 	
 protected:
 	/** Information for access this item's data */
@@ -18,16 +19,16 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item|Data Configuration") UDataAsset* GlobalItemInformation;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item|Data Configuration") FName TableId;
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Replicated, Category = "Item|Information") F_Item Item;
-	
-	/**
-	 * Set to true if a player has accessed this item and is performing some action that should prevent other players from doing the same thing
-	 * @note Should be used on the server only
-	 */
-	UPROPERTY(Transient, BlueprintReadWrite) ACharacter* PendingPlayer = nullptr;
 
 	/** Other */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item|Debugging") bool bDebugItemRetrieval;
 
+	/** Whether this item is hidden in a world item pool, waiting to be reused (UInventoryWorldItemPool) */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Item|Pooling") bool bInPool = false;
+
+	/** Whether a world item pool spawned this item. Only these are returned to the pool, items placed in the level (or spawned by anything else) are destroyed once they're picked up */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Item|Pooling") bool bSpawnedByPool = false;
+
 	
 public:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -58,28 +59,13 @@ public:
 	virtual void SetId_Implementation(const FGuid& Id) override;
 	
 	/**
-	 * Server side function that acts like a threadlock to prevent multiple from trying to perform operations on an item at the same time
-	 * 
-	 * @remarks Do not override this unless you're refactoring
-	 */
-	virtual bool IsSafeToAdjustItem_Implementation() const override;
-	
-	/**
-	 * Sets whether a player is already attempting to interact with this item
+	 * Sets whether a player is already attempting to interact with this item. The item is claimed by it's id in the world's claim table (UInventoryItemClaims), so it's given an id if it doesn't have one
 	 * 
 	 * @remarks Do not override this unless you're refactoring
 	 * @note this should determine whether it's safe to adjust an item (only use on the server)
 	 */
 	virtual void SetPlayerPending_Implementation(ACharacter* Player) override;
 	
-	/**
-	 * Gets whether a player is already attempting to interact with this item
-	 * 
-	 * @remarks Do not override this unless you're refactoring
-	 * @note this should determine whether it's safe to adjust an item (only use on the server)
-	 */
-	virtual ACharacter* GetPlayerPending_Implementation() override;
-	
 	
 //----------------------------------------------------------------------------------------------------------//
 // Utility																									//
@@ -87,13 +73,33 @@ public:
 	/** Adds the item information database */
 	virtual void SetItemInformationDatabase_Implementation(UDataTable* Database) override;
 	
-	/** Retrieves an item from the data table. Returns null if the item was not found */
+	/** Retrieves an item from the item catalog (this item's data table is added to the catalog if it isn't already). Returns false if the item was not found */
 	UFUNCTION(BlueprintCallable) virtual bool RetrieveItemFromDataTable(FName Id, F_Item& ItemData);
 	
 	
+//----------------------------------------------------------------------------------------------------------//
+// Pooling																									//
+//----------------------------------------------------------------------------------------------------------//
+	/** Places the item back in the world once it's been reused from a world item pool. The item's information is set afterwards */
+	virtual void OnAcquiredFromPool(const FTransform& Transform);
+	
+	/** Hides the item, disables it's collision, and puts it's replication to sleep until it's reused */
+	virtual void OnReleasedToPool();
+	
+	/** Returns true if this item is waiting in a world item pool */
+	bool IsInPool() const { return bInPool; }
+	
+	/** Returns true if this item belongs to a world item pool */
+	bool IsPooled() const { return bSpawnedByPool; }
+	
+	
 protected:	
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void CreateIdIfNull();
+	
+	/** Keeps the item's place in the world item index (UInventoryWorldItemIndex) up to date when it moves */
+	void OnItemMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
 	virtual void Tick(float DeltaSeconds) override;
 	
 	